@@ -0,0 +1,38 @@
+#ifndef BEK_BENCH_H
+#define BEK_BENCH_H
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Monotonic time in seconds
+static inline double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+// Print one result line as throughput over the processed bytes
+static inline void bench_report(const char *name, const size_t bytes, const double seconds) {
+    printf("%-40s %10.1f MiB/s  (%.3f s)\n", name, (double) bytes / seconds / (1024.0 * 1024.0), seconds);
+}
+
+// Fill a buffer with reproducible pseudo-random bytes
+static inline void bench_fill(uint8_t *buffer, const size_t length, uint64_t seed) {
+    for (size_t i = 0; i < length; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        buffer[i] = (uint8_t) (seed >> 56);
+    }
+}
+
+// Parse an optional positive integer argument
+static inline size_t bench_arg(const int argc, char *argv[], const int index, const size_t fallback) {
+    if (index >= argc) return fallback;
+    const long long value = atoll(argv[index]);
+    return value > 0 ? (size_t) value : fallback;
+}
+
+#endif //BEK_BENCH_H
@@ -0,0 +1,80 @@
+#include "bench.h"
+
+#include "bek_checksum.h"
+
+#define ROUNDS 5
+
+// Time `repeat` passes of `body`, best of ROUNDS
+#define MEASURE(name, repeat, bytes, body)                              \
+    do {                                                                \
+        double best = 0;                                                \
+        for (int round = 0; round < ROUNDS; ++round) {                  \
+            const double start = bench_now();                           \
+            for (size_t r = 0; r < (repeat); ++r) {                     \
+                body;                                                   \
+            }                                                           \
+            const double elapsed = bench_now() - start;                 \
+            if (round == 0 || elapsed < best) best = elapsed;           \
+        }                                                               \
+        bench_report(name, (size_t) (repeat) * (bytes), best);          \
+    } while (0)
+
+int main(int argc, char *argv[]) {
+    // Well past the last-level cache, so the second pass of the two-pass
+    // variants reads memory again
+    const size_t size = bench_arg(argc, argv, 1, 64) << 20;
+    const size_t repeat = bench_arg(argc, argv, 2, 3);
+
+    uint8_t *raw = malloc(size);
+    uint8_t *decoded = malloc(size);
+    char *text = malloc(2 * size);
+    bench_fill(raw, size, 5);
+
+    printf("%zu MiB of random bytes per call, best of %d; rates are binary bytes\n", size >> 20, ROUNDS);
+
+    volatile uint32_t sink = 0;
+    MEASURE("crc32c alone", repeat, size, sink += bek_crc32c(0, raw, size));
+
+    base64_config_t b64_config = {1, 0, 0, "", 1};
+    base16_config_t hex_config = {1, 0, "", 1};
+    base64_ctx_t *b64;
+    base16_ctx_t *hex;
+    base64_init(&b64, &b64_config);
+    base16_init(&hex, &hex_config);
+    const bek_codec_t codecs[2] = {{.kind = BEK_CODEC_BASE64, .ctx.base64 = b64},
+                                   {.kind = BEK_CODEC_BASE16, .ctx.base16 = hex}};
+
+    for (int c = 0; c < 2; c++) {
+        const bek_codec_t *codec = &codecs[c];
+        size_t length, decoded_length;
+        uint32_t crc;
+        bek_encode(codec, raw, size, text, 2 * size, &length);
+        printf("%s %zu characters\n", c ? "base16" : "base64", length);
+
+        MEASURE(c ? "base16 encode, then crc32c" : "base64 encode, then crc32c", repeat, size, {
+            bek_encode(codec, raw, size, text, 2 * size, &length);
+            sink += bek_crc32c(0, raw, size);
+        });
+        MEASURE(c ? "base16 bek_encode_crc32c" : "base64 bek_encode_crc32c", repeat, size, {
+            crc = 0;
+            bek_encode_crc32c(codec, raw, size, text, 2 * size, &length, &crc);
+            sink += crc;
+        });
+        MEASURE(c ? "base16 decode, then crc32c" : "base64 decode, then crc32c", repeat, size, {
+            bek_decode(codec, text, length, decoded, size, &decoded_length);
+            sink += bek_crc32c(0, decoded, decoded_length);
+        });
+        MEASURE(c ? "base16 bek_decode_crc32c" : "base64 bek_decode_crc32c", repeat, size, {
+            crc = 0;
+            bek_decode_crc32c(codec, text, length, decoded, size, &decoded_length, &crc);
+            sink += crc;
+        });
+    }
+
+    base64_free(b64);
+    base16_free(hex);
+    free(raw);
+    free(decoded);
+    free(text);
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include "bench.h"
+
+#include <string.h>
+
+#include "bek_codec.h"
+
+#define BUFFER (1u << 20)
+#define ROUNDS 5
+
+static char text[2 * BUFFER + 64];
+static uint8_t output[4 * sizeof(text)];
+static char messy[2 * sizeof(text)];
+static uint16_t wide[sizeof(text)];
+
+// What bindings did before the UTF-16 variants: widen the char text into the
+// string buffer, or narrow it back before decoding
+static void widen(const char *text, const size_t length, uint16_t *output) {
+    for (size_t i = 0; i < length; i++) output[i] = (uint8_t) text[i];
+}
+
+static void narrow(const uint16_t *text, const size_t length, char *output) {
+    for (size_t i = 0; i < length; i++) output[i] = (char) text[i];
+}
+
+// Time `repeat` calls of `body` and report the best of ROUNDS passes over
+// `bytes` binary bytes per call
+#define MEASURE(name, repeat, bytes, body)                              \
+    do {                                                                \
+        double best = 0;                                                \
+        for (int round = 0; round < ROUNDS; ++round) {                  \
+            const double start = bench_now();                           \
+            for (size_t r = 0; r < (repeat); ++r) {                     \
+                body;                                                   \
+            }                                                           \
+            const double elapsed = bench_now() - start;                 \
+            if (round == 0 || elapsed < best) best = elapsed;           \
+        }                                                               \
+        bench_report(name, (size_t) (repeat) * (bytes), best);          \
+    } while (0)
+
+int main(int argc, char *argv[]) {
+    const size_t repeat = bench_arg(argc, argv, 1, 20);
+    uint8_t *raw = malloc(BUFFER);
+    bench_fill(raw, BUFFER, 7);
+    size_t length, decoded;
+
+    printf("%u KiB of random bytes per call, best of %d; rates are binary bytes\n", BUFFER / 1024, ROUNDS);
+
+    base64_config_t b64_config = {0, 0, 0, "", 1};
+    base64_ctx_t *b64;
+    base64_init(&b64, &b64_config);
+    base64_encode(b64, raw, BUFFER, text, sizeof(text), &length);
+    printf("base64  %zu characters\n", length);
+    MEASURE("base64  encode", repeat, BUFFER, base64_encode(b64, raw, BUFFER, text, sizeof(text), &length));
+    MEASURE("base64  decode", repeat, BUFFER, base64_decode(b64, text, length, output, sizeof(output), &decoded));
+    MEASURE("base64  decode strict", repeat, BUFFER, base64_decode_strict(b64, text, length, output, sizeof(output), &decoded));
+    MEASURE("base64  encode, then widen", repeat, BUFFER, {
+        base64_encode(b64, raw, BUFFER, text, sizeof(text), &length);
+        widen(text, length, wide);
+    });
+    MEASURE("base64  encode UTF-16", repeat, BUFFER, base64_encode_utf16(b64, raw, BUFFER, wide, sizeof(text), &length));
+    MEASURE("base64  narrow, then decode", repeat, BUFFER, {
+        narrow(wide, length, text);
+        base64_decode(b64, text, length, output, sizeof(output), &decoded);
+    });
+    MEASURE("base64  decode UTF-16", repeat, BUFFER, base64_decode_utf16(b64, wide, length, output, sizeof(output), &decoded));
+    base64_free(b64);
+
+    // Mail bodies: 76 columns and CRLF
+    base64_config_t mime_config = {1, 0, 76, "\r\n", 1};
+    base64_init(&b64, &mime_config);
+    base64_encode(b64, raw, BUFFER, text, sizeof(text), &length);
+    printf("base64  MIME %zu characters\n", length);
+    MEASURE("base64  decode MIME", repeat, BUFFER, base64_decode(b64, text, length, output, sizeof(output), &decoded));
+
+    // Pretty-printed JSON: a quoted fragment per line at an irregular width,
+    // indented
+    size_t messy_length = 0;
+    for (size_t i = 0, next = 0, line = 0; i < length; i++) {
+        if (text[i] == '\r' || text[i] == '\n') continue;
+        if (next-- == 0) {
+            memcpy(messy + messy_length, "\",\n    \"", 8);
+            messy_length += 8;
+            next = 40 + (line++ * 37) % 41;
+        }
+        messy[messy_length++] = text[i];
+    }
+    base64_free(b64);
+    base64_config_t json_config = {1, 0, 0, "", 1, " \r\n\","};
+    base64_init(&b64, &json_config);
+    printf("base64  JSON %zu characters\n", messy_length);
+    MEASURE("base64  decode JSON", repeat, BUFFER, base64_decode(b64, messy, messy_length, output, sizeof(output), &decoded));
+    base64_free(b64);
+
+    base32_config_t b32_config = {0, 0, 0, "", 1};
+    base32_ctx_t *b32;
+    base32_init(&b32, &b32_config);
+    base32_encode(b32, raw, BUFFER, text, sizeof(text), &length);
+    printf("base32  %zu characters\n", length);
+    MEASURE("base32  encode", repeat, BUFFER, base32_encode(b32, raw, BUFFER, text, sizeof(text), &length));
+    MEASURE("base32  decode", repeat, BUFFER, base32_decode(b32, text, length, output, sizeof(output), &decoded));
+    MEASURE("base32  decode strict", repeat, BUFFER, base32_decode_strict(b32, text, length, output, sizeof(output), &decoded));
+    base32_free(b32);
+
+    base16_config_t hex_config = {0, 0, "", 1};
+    base16_ctx_t *hex;
+    base16_init(&hex, &hex_config);
+    base16_encode(hex, raw, BUFFER, text, sizeof(text), &length);
+    printf("base16  %zu characters\n", length);
+    MEASURE("base16  encode", repeat, BUFFER, base16_encode(hex, raw, BUFFER, text, sizeof(text), &length));
+    MEASURE("base16  decode", repeat, BUFFER, base16_decode(hex, text, length, output, sizeof(output), &decoded));
+    MEASURE("base16  encode, then widen", repeat, BUFFER, {
+        base16_encode(hex, raw, BUFFER, text, sizeof(text), &length);
+        widen(text, length, wide);
+    });
+    MEASURE("base16  encode UTF-16", repeat, BUFFER, base16_encode_utf16(hex, raw, BUFFER, wide, sizeof(text), &length));
+    MEASURE("base16  narrow, then decode", repeat, BUFFER, {
+        narrow(wide, length, text);
+        base16_decode(hex, text, length, output, sizeof(output), &decoded);
+    });
+    MEASURE("base16  decode UTF-16", repeat, BUFFER, base16_decode_utf16(hex, wide, length, output, sizeof(output), &decoded));
+    base16_free(hex);
+
+    for (int z85 = 0; z85 <= 1; z85++) {
+        base85_config_t b85_config = {z85, 0, "", 1};
+        base85_ctx_t *b85;
+        base85_init(&b85, &b85_config);
+        bek_codec_t codec = {.kind = BEK_CODEC_BASE85, .ctx.base85 = b85};
+        base85_encode(b85, raw, BUFFER, text, sizeof(text), &length);
+        printf("%s %zu characters\n", z85 ? "z85    " : "ascii85", length);
+        MEASURE(z85 ? "z85     encode" : "ascii85 encode", repeat, BUFFER,
+                base85_encode(b85, raw, BUFFER, text, sizeof(text), &length));
+        MEASURE(z85 ? "z85     decode" : "ascii85 decode", repeat, BUFFER,
+                base85_decode(b85, text, length, output, sizeof(output), &decoded));
+        MEASURE(z85 ? "z85     bek_encode (stream engine)" : "ascii85 bek_encode (stream engine)", repeat, BUFFER,
+                bek_encode(&codec, raw, BUFFER, text, sizeof(text), &length));
+        MEASURE(z85 ? "z85     bek_decode (stream engine)" : "ascii85 bek_decode (stream engine)", repeat, BUFFER,
+                bek_decode(&codec, text, length, output, sizeof(output), &decoded));
+        base85_free(b85);
+    }
+
+    free(raw);
+    return decoded == BUFFER ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#include "bench.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bek_file.h"
+#include "bek_uring.h"
+
+#define BLOCK_SIZE (256 * 1024)
+
+// Baseline: blocking read(), streaming encode/decode, blocking write()
+static bek_error_t plain_loop(const base64_ctx_t *ctx, const char *input_path, const char *output_path, const int decode) {
+    const int input_fd = open(input_path, O_RDONLY);
+    const int output_fd = open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    static uint8_t input[BLOCK_SIZE];
+    static uint8_t output[BLOCK_SIZE * 2];
+    bek_stream_t stream;
+    bek_stream_init(&stream);
+
+    if (input_fd < 0 || output_fd < 0) return BEK_ERROR_IO;
+
+    base64_error_t error = BASE64_SUCCESS;
+    ssize_t n;
+    size_t consumed, produced;
+    while (error == BASE64_SUCCESS && (n = read(input_fd, input, sizeof(input))) > 0) {
+        error = decode
+                    ? base64_decode_update(ctx, &stream, (const char *) input, (size_t) n, &consumed,
+                                           output, sizeof(output), &produced)
+                    : base64_encode_update(ctx, &stream, input, (size_t) n, &consumed,
+                                           (char *) output, sizeof(output), &produced);
+        if (write(output_fd, output, produced) != (ssize_t) produced) return BEK_ERROR_IO;
+    }
+    if (error == BASE64_SUCCESS) {
+        error = decode
+                    ? base64_decode_final(ctx, &stream, output, sizeof(output), &produced)
+                    : base64_encode_final(ctx, &stream, (char *) output, sizeof(output), &produced);
+        if (write(output_fd, output, produced) != (ssize_t) produced) return BEK_ERROR_IO;
+    }
+
+    close(input_fd);
+    close(output_fd);
+    return error == BASE64_SUCCESS ? BEK_SUCCESS : BEK_ERROR_INVALID_INPUT;
+}
+
+static bek_error_t run_plain(const bek_codec_t *codec, const char *input, const char *output, const int decode) {
+    return plain_loop(codec->ctx.base64, input, output, decode);
+}
+
+static void measure(const char *name, const bek_codec_t *codec, const char *input, const char *output,
+                    const size_t bytes, const size_t repeat, const int decode, const int method) {
+    const bek_uring_options_t uring_options = {0, 0};
+    const bek_file_options_t file_options = {1, 0};
+    double best = 0;
+
+    for (size_t r = 0; r < repeat; ++r) {
+        const double start = bench_now();
+        bek_error_t error;
+        switch (method) {
+            case 0: error = run_plain(codec, input, output, decode); break;
+            case 1: error = decode ? bek_decode_file_uring(codec, input, output, &uring_options)
+                                   : bek_encode_file_uring(codec, input, output, &uring_options); break;
+            default: error = decode ? bek_decode_file(codec, input, output, &file_options)
+                                    : bek_encode_file(codec, input, output, &file_options); break;
+        }
+        const double elapsed = bench_now() - start;
+
+        if (error != BEK_SUCCESS) {
+            printf("%-40s failed: %s%s%s\n", name, bek_error_string(error),
+                   error == BEK_ERROR_IO ? ": " : "", error == BEK_ERROR_IO ? strerror(errno) : "");
+            return;
+        }
+        if (r == 0 || elapsed < best) best = elapsed;
+    }
+    bench_report(name, bytes, best);
+}
+
+int main(int argc, char *argv[]) {
+    const size_t megabytes = bench_arg(argc, argv, 1, 256);
+    const size_t repeat = bench_arg(argc, argv, 2, 3);
+    const char *directory = argc > 3 ? argv[3] : "/tmp";
+
+    char plain_path[512], encoded_path[512], scratch_path[512];
+    snprintf(plain_path, sizeof(plain_path), "%s/bek_bench_plain", directory);
+    snprintf(encoded_path, sizeof(encoded_path), "%s/bek_bench_encoded", directory);
+    snprintf(scratch_path, sizeof(scratch_path), "%s/bek_bench_scratch", directory);
+
+    const size_t bytes = megabytes * 1024 * 1024;
+    uint8_t *data = malloc(bytes);
+    if (data == NULL) return 1;
+    bench_fill(data, bytes, 1);
+
+    FILE *file = fopen(plain_path, "wb");
+    if (file == NULL || fwrite(data, 1, bytes, file) != bytes) return 1;
+    fclose(file);
+    free(data);
+
+    base64_config_t config = {1, 0, 76, "\n", 1};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+    bek_codec_t codec = {.kind = BEK_CODEC_BASE64, .ctx.base64 = ctx};
+    bek_encode_file(&codec, plain_path, encoded_path, NULL);
+
+    printf("base64, %zu MiB in %s, best of %zu (page cache warm after the first run)\n", megabytes, directory, repeat);
+    measure("encode read/write loop", &codec, plain_path, scratch_path, bytes, repeat, 0, 0);
+    measure("encode io_uring", &codec, plain_path, scratch_path, bytes, repeat, 0, 1);
+    measure("encode mmap", &codec, plain_path, scratch_path, bytes, repeat, 0, 2);
+    measure("decode read/write loop", &codec, encoded_path, scratch_path, bytes, repeat, 1, 0);
+    measure("decode io_uring", &codec, encoded_path, scratch_path, bytes, repeat, 1, 1);
+    measure("decode mmap", &codec, encoded_path, scratch_path, bytes, repeat, 1, 2);
+
+    remove(plain_path);
+    remove(encoded_path);
+    remove(scratch_path);
+    base64_free(ctx);
+    return 0;
+}
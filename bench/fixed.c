@@ -0,0 +1,96 @@
+#include "bench.h"
+
+#include <string.h>
+
+#include "base16.h"
+#include "base32.h"
+#include "base64.h"
+
+#define INPUTS 1024
+
+static uint8_t inputs[INPUTS][64];
+static volatile uint8_t sink;
+
+// Time `body` over `iterations` inputs and report nanoseconds per call
+#define MEASURE(name, iterations, body)                                             \
+    do {                                                                            \
+        char out[256];                                                              \
+        uint8_t acc = 0;                                                            \
+        const double start = bench_now();                                           \
+        for (size_t it = 0; it < (iterations); ++it) {                              \
+            const uint8_t *in = inputs[it % INPUTS];                                \
+            body;                                                                   \
+            acc ^= (uint8_t) out[it % 16];                                          \
+        }                                                                           \
+        const double elapsed = bench_now() - start;                                 \
+        sink = acc;                                                                 \
+        printf("%-36s %8.1f ns/op\n", name, elapsed * 1e9 / (double) (iterations)); \
+    } while (0)
+
+int main(int argc, char *argv[]) {
+    const size_t iterations = bench_arg(argc, argv, 1, 2000000);
+    bench_fill(&inputs[0][0], sizeof(inputs), 7);
+
+    base16_config_t hex_config = {0, 0, "", 1};
+    base64_config_t url_config = {0, 1, 0, "", 1};
+    base32_config_t b32_config = {0, 0, 0, "", 1};
+    base16_ctx_t *hex;
+    base64_ctx_t *url;
+    base32_ctx_t *b32;
+    base16_init(&hex, &hex_config);
+    base64_init(&url, &url_config);
+    base32_init(&b32, &b32_config);
+    size_t length;
+
+    printf("%zu calls each\n", iterations);
+    MEASURE("uuid  generic base16_encode + dashes", iterations, {
+        char raw[32];
+        base16_encode(hex, in, 16, raw, sizeof(raw), &length);
+        memcpy(out, raw, 8); out[8] = '-';
+        memcpy(out + 9, raw + 8, 4); out[13] = '-';
+        memcpy(out + 14, raw + 12, 4); out[18] = '-';
+        memcpy(out + 19, raw + 16, 4); out[23] = '-';
+        memcpy(out + 24, raw + 20, 12);
+    });
+    MEASURE("uuid  base16_encode_uuid", iterations, base16_encode_uuid(in, out, 0));
+
+    MEASURE("hex20 generic base16_encode", iterations, base16_encode(hex, in, 20, out, sizeof(out), &length));
+    MEASURE("hex20 base16_encode_20", iterations, base16_encode_20(in, out, 0));
+    MEASURE("hex32 generic base16_encode", iterations, base16_encode(hex, in, 32, out, sizeof(out), &length));
+    MEASURE("hex32 base16_encode_32", iterations, base16_encode_32(in, out, 0));
+    MEASURE("hex64 generic base16_encode", iterations, base16_encode(hex, in, 64, out, sizeof(out), &length));
+    MEASURE("hex64 base16_encode_64", iterations, base16_encode_64(in, out, 0));
+
+    MEASURE("b64u20 generic base64_encode", iterations, base64_encode(url, in, 20, out, sizeof(out), &length));
+    MEASURE("b64u20 base64url_encode_20", iterations, base64url_encode_20(in, out));
+    MEASURE("b64u32 generic base64_encode", iterations, base64_encode(url, in, 32, out, sizeof(out), &length));
+    MEASURE("b64u32 base64url_encode_32", iterations, base64url_encode_32(in, out));
+    MEASURE("b64u64 generic base64_encode", iterations, base64_encode(url, in, 64, out, sizeof(out), &length));
+    MEASURE("b64u64 base64url_encode_64", iterations, base64url_encode_64(in, out));
+
+    MEASURE("b32k32 generic base32_encode", iterations, base32_encode(b32, in, 32, out, sizeof(out), &length));
+    MEASURE("b32k32 base32_encode_32", iterations, base32_encode_32(in, out));
+
+    // Callers that do not pre-size: allocate per call, or reuse one bek_buf
+    MEASURE("b64u32 get_encode_size + malloc", iterations, {
+        size_t size;
+        base64_get_encode_size(32, url, &size);
+        char *text = malloc(size);
+        base64_encode(url, in, 32, text, size, &length);
+        out[it % 16] = text[it % 16];
+        free(text);
+    });
+    bek_buf_t buf;
+    bek_buf_init(&buf, NULL);
+    MEASURE("b64u32 base64_encode_to_buf, reused", iterations, {
+        bek_buf_clear(&buf);
+        base64_encode_to_buf(url, in, 32, &buf);
+        out[it % 16] = (char) buf.data[it % 16];
+    });
+    bek_buf_free(&buf);
+
+    base16_free(hex);
+    base64_free(url);
+    base32_free(b32);
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "bench.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base16.h"
+
+#define VALUES 4096
+
+static uint64_t values[VALUES];
+static char texts[VALUES][17];
+static size_t lengths[VALUES];
+static volatile uint64_t sink;
+
+// Time `body` over `iterations` values and report nanoseconds per call
+#define MEASURE(name, iterations, body)                                             \
+    do {                                                                            \
+        char out[40];                                                               \
+        (void) out;                                                                 \
+        uint64_t acc = 0;                                                           \
+        const double start = bench_now();                                           \
+        for (size_t it = 0; it < (iterations); ++it) {                              \
+            const size_t i = it % VALUES;                                           \
+            body;                                                                   \
+        }                                                                           \
+        const double elapsed = bench_now() - start;                                 \
+        sink = acc;                                                                 \
+        printf("%-36s %8.1f ns/op\n", name, elapsed * 1e9 / (double) (iterations)); \
+    } while (0)
+
+int main(int argc, char *argv[]) {
+    const size_t iterations = bench_arg(argc, argv, 1, 5000000);
+    bench_fill((uint8_t *) values, sizeof(values), 11);
+    // Mix of magnitudes so minimal-width formatting sees every digit count
+    for (size_t i = 0; i < VALUES; i++) {
+        values[i] >>= i % 64;
+        lengths[i] = (size_t) snprintf(texts[i], sizeof(texts[i]), "%" PRIx64, values[i]);
+    }
+
+    printf("%zu calls each\n", iterations);
+    MEASURE("u32 snprintf %08x", iterations, {
+        snprintf(out, sizeof(out), "%08" PRIx32, (uint32_t) values[i]);
+        acc += (uint8_t) out[i % 8];
+    });
+    MEASURE("u32 base16_format_u32", iterations, {
+        base16_format_u32((uint32_t) values[i], out, 0);
+        acc += (uint8_t) out[i % 8];
+    });
+    MEASURE("u64 snprintf %016llx", iterations, {
+        snprintf(out, sizeof(out), "%016" PRIx64, values[i]);
+        acc += (uint8_t) out[i % 16];
+    });
+    MEASURE("u64 base16_format_u64", iterations, {
+        base16_format_u64(values[i], out, 0);
+        acc += (uint8_t) out[i % 16];
+    });
+    MEASURE("u64 snprintf %llx", iterations, {
+        acc += (uint64_t) snprintf(out, sizeof(out), "%" PRIx64, values[i]);
+    });
+    MEASURE("u64 base16_format_u64_min", iterations, {
+        acc += base16_format_u64_min(values[i], out, 0);
+    });
+    MEASURE("u128 snprintf 2x %016llx", iterations, {
+        snprintf(out, sizeof(out), "%016" PRIx64 "%016" PRIx64, values[i], ~values[i]);
+        acc += (uint8_t) out[i % 32];
+    });
+    MEASURE("u128 base16_format_u128", iterations, {
+        base16_format_u128(values[i], ~values[i], out, 0);
+        acc += (uint8_t) out[i % 32];
+    });
+
+    // strtoull needs a terminated string; the texts table provides one
+    MEASURE("u64 strtoull", iterations, {
+        acc += strtoull(texts[i], NULL, 16);
+    });
+    MEASURE("u64 base16_parse_u64", iterations, {
+        uint64_t value = 0;
+        base16_parse_u64(texts[i], lengths[i], &value);
+        acc += value;
+    });
+    return 0;
+}
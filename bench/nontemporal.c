@@ -0,0 +1,130 @@
+#include "bench.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "bek_codec.h"
+
+#define ROUNDS 5
+
+// Time `repeat` passes of `body`, best of ROUNDS
+#define MEASURE(name, repeat, bytes, body)                              \
+    do {                                                                \
+        double best = 0;                                                \
+        for (int round = 0; round < ROUNDS; ++round) {                  \
+            const double start = bench_now();                           \
+            for (size_t r = 0; r < (repeat); ++r) {                     \
+                body;                                                   \
+            }                                                           \
+            const double elapsed = bench_now() - start;                 \
+            if (round == 0 || elapsed < best) best = elapsed;           \
+        }                                                               \
+        bench_report(name, (size_t) (repeat) * (bytes), best);          \
+    } while (0)
+
+// A latency-bound neighbour: chases a random cycle through a working set of
+// cache lines, so every line the encoder evicts costs it a memory access
+typedef struct {
+    uint32_t *lines;      // 16 words per line, the first holds the next line
+    atomic_int stop;
+    size_t steps;
+} neighbour_t;
+
+static void *neighbour_main(void *arg) {
+    neighbour_t *n = arg;
+    uint32_t line = 0;
+    size_t steps = 0;
+    while (!atomic_load_explicit(&n->stop, memory_order_relaxed)) {
+        for (int i = 0; i < 256; i++) line = n->lines[16 * (size_t) line];
+        steps += 256;
+    }
+    n->steps = steps + (line == UINT32_MAX);
+    return NULL;
+}
+
+// Neighbour steps per microsecond while `repeat` encodes run, or while idle
+// for `idle` seconds when codec is NULL
+static double with_neighbour(neighbour_t *n, const bek_codec_t *codec, const size_t repeat, const double idle,
+                             const uint8_t *input, const size_t size, char *output, const size_t output_size) {
+    pthread_t thread;
+    atomic_store(&n->stop, 0);
+    pthread_create(&thread, NULL, neighbour_main, n);
+
+    const double start = bench_now();
+    size_t length;
+    if (codec == NULL) {
+        while (bench_now() - start < idle) {
+        }
+    }
+    for (size_t r = 0; codec != NULL && r < repeat; ++r) {
+        bek_encode(codec, input, size, output, output_size, &length);
+    }
+    const double elapsed = bench_now() - start;
+
+    atomic_store(&n->stop, 1);
+    pthread_join(thread, NULL);
+    return (double) n->steps / elapsed / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    // Several times any last-level cache
+    const size_t size = bench_arg(argc, argv, 1, 256) << 20;
+    const size_t repeat = bench_arg(argc, argv, 2, 2);
+    const size_t working_set = bench_arg(argc, argv, 3, 4) << 20;
+
+    uint8_t *raw = malloc(size);
+    char *text = malloc(2 * size);
+    bench_fill(raw, size, 3);
+
+    printf("%zu MiB of random bytes per call, best of %d; rates are binary bytes\n", size >> 20, ROUNDS);
+
+    base64_ctx_t *contexts[4];
+    bek_codec_t cached[2], streamed[2];
+    const char *names[2] = {"base64", "base64 MIME"};
+    for (int m = 0; m < 2; m++) {
+        base64_config_t config = {1, 0, m ? 76 : 0, "\r\n", 1, NULL, NULL, BEK_STORE_CACHED};
+        base64_init(&contexts[2 * m], &config);
+        config.stores = BEK_STORE_NONTEMPORAL;
+        base64_init(&contexts[2 * m + 1], &config);
+        cached[m] = (bek_codec_t) {.kind = BEK_CODEC_BASE64, .ctx.base64 = contexts[2 * m]};
+        streamed[m] = (bek_codec_t) {.kind = BEK_CODEC_BASE64, .ctx.base64 = contexts[2 * m + 1]};
+    }
+
+    size_t length;
+    char name[64];
+    for (int m = 0; m < 2; m++) {
+        snprintf(name, sizeof(name), "%s cached stores", names[m]);
+        MEASURE(name, repeat, size, bek_encode(&cached[m], raw, size, text, 2 * size, &length));
+        snprintf(name, sizeof(name), "%s non-temporal stores", names[m]);
+        MEASURE(name, repeat, size, bek_encode(&streamed[m], raw, size, text, 2 * size, &length));
+    }
+
+    // Sattolo's shuffle: one cycle through every line of the working set
+    neighbour_t neighbour = {.lines = malloc(working_set)};
+    const uint32_t line_count = (uint32_t) (working_set / 64);
+    uint64_t seed = 9;
+    for (uint32_t i = 0; i < line_count; i++) neighbour.lines[16 * (size_t) i] = i;
+    for (uint32_t i = line_count - 1; i > 0; i--) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        const uint32_t j = (uint32_t) ((seed >> 33) % i);
+        const uint32_t t = neighbour.lines[16 * (size_t) i];
+        neighbour.lines[16 * (size_t) i] = neighbour.lines[16 * (size_t) j];
+        neighbour.lines[16 * (size_t) j] = t;
+    }
+
+    printf("\nneighbour chasing pointers through %zu MiB, steps/us (higher is better)\n", working_set >> 20);
+    const double start = bench_now();
+    bek_encode(&cached[0], raw, size, text, 2 * size, &length);
+    const double idle = bench_now() - start;
+    printf("%-40s %10.1f\n", "alone", with_neighbour(&neighbour, NULL, 0, repeat * idle, raw, size, text, 2 * size));
+    printf("%-40s %10.1f\n", "beside base64 cached stores",
+           with_neighbour(&neighbour, &cached[0], repeat, 0, raw, size, text, 2 * size));
+    printf("%-40s %10.1f\n", "beside base64 non-temporal stores",
+           with_neighbour(&neighbour, &streamed[0], repeat, 0, raw, size, text, 2 * size));
+
+    for (int c = 0; c < 4; c++) base64_free(contexts[c]);
+    free(neighbour.lines);
+    free(raw);
+    free(text);
+    return 0;
+}
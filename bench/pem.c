@@ -0,0 +1,110 @@
+#include "bench.h"
+
+#include <string.h>
+
+#include "base64.h"
+#include "bek_pem.h"
+
+#define DER_SIZE 1500
+#define ROUNDS 5
+
+// Time `repeat` passes of `body` over the bundle, best of ROUNDS
+#define MEASURE(name, repeat, bytes, body)                              \
+    do {                                                                \
+        double best = 0;                                                \
+        for (int round = 0; round < ROUNDS; ++round) {                  \
+            const double start = bench_now();                           \
+            for (size_t r = 0; r < (repeat); ++r) {                     \
+                body;                                                   \
+            }                                                           \
+            const double elapsed = bench_now() - start;                 \
+            if (round == 0 || elapsed < best) best = elapsed;           \
+        }                                                               \
+        bench_report(name, (size_t) (repeat) * (bytes), best);          \
+    } while (0)
+
+// What callers did before bek_pem: find the markers with strstr and hand the
+// body to the whitespace-skipping base64_decode
+static size_t split_and_decode(const base64_ctx_t *ctx, const char *bundle, uint8_t *der) {
+    size_t total = 0, length;
+    for (const char *p = bundle; (p = strstr(p, "-----BEGIN ")) != NULL;) {
+        const char *body = strchr(p, '\n') + 1;
+        const char *end = strstr(body, "-----END ");
+        base64_decode(ctx, body, (size_t) (end - body), der, 2 * DER_SIZE, &length);
+        total += length;
+        p = strchr(end, '\n');
+    }
+    return total;
+}
+
+static size_t pem_decode_all(const char *bundle, const size_t bundle_length, uint8_t *der) {
+    size_t total = 0, length, offset = 0;
+    bek_pem_block_t block;
+    while (bek_pem_next(bundle, bundle_length, &offset, &block) == BEK_SUCCESS && block.label != NULL) {
+        bek_pem_decode(&block, der, 2 * DER_SIZE, &length);
+        total += length;
+    }
+    return total;
+}
+
+int main(int argc, char *argv[]) {
+    const size_t certificates = bench_arg(argc, argv, 1, 300);
+    const size_t repeat = bench_arg(argc, argv, 2, 20);
+
+    uint8_t *der = malloc(certificates * DER_SIZE);
+    bench_fill(der, certificates * DER_SIZE, 11);
+    const size_t block_size = bek_pem_get_encode_size(11, DER_SIZE);
+    const size_t capacity = certificates * (block_size + 64) + 1;
+    char *bundle = malloc(capacity);
+    char *scratch = malloc(capacity);
+    uint8_t *decoded = malloc(2 * DER_SIZE);
+
+    // A CA store: a comment line and a certificate per entry
+    size_t bundle_length = 0, length;
+    for (size_t i = 0; i < certificates; ++i) {
+        bundle_length += (size_t) sprintf(bundle + bundle_length, "# Certificate %zu\n", i);
+        bek_pem_encode("CERTIFICATE", der + i * DER_SIZE, DER_SIZE, bundle + bundle_length,
+                       capacity - bundle_length, &length);
+        bundle_length += length;
+    }
+    bundle[bundle_length] = '\0';
+
+    printf("%zu certificates of %d bytes, %zu KiB bundle, best of %d\n",
+           certificates, DER_SIZE, bundle_length / 1024, ROUNDS);
+
+    base64_config_t config = {1, 0, 64, "\n", 1};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+
+    volatile size_t sink = 0;
+    MEASURE("decode strstr + base64_decode", repeat, bundle_length, sink += split_and_decode(ctx, bundle, decoded));
+    MEASURE("decode bek_pem_next + bek_pem_decode", repeat, bundle_length, sink += pem_decode_all(bundle, bundle_length, decoded));
+    MEASURE("encode markers + base64_encode", repeat, bundle_length, {
+        size_t used = 0;
+        for (size_t i = 0; i < certificates; ++i) {
+            memcpy(scratch + used, "-----BEGIN CERTIFICATE-----\n", 28);
+            used += 28;
+            base64_encode(ctx, der + i * DER_SIZE, DER_SIZE, scratch + used, capacity - used, &length);
+            used += length;
+            scratch[used++] = '\n';
+            memcpy(scratch + used, "-----END CERTIFICATE-----\n", 26);
+            used += 26;
+        }
+        sink += used;
+    });
+    MEASURE("encode bek_pem_encode", repeat, bundle_length, {
+        size_t used = 0;
+        for (size_t i = 0; i < certificates; ++i) {
+            bek_pem_encode("CERTIFICATE", der + i * DER_SIZE, DER_SIZE, scratch + used, capacity - used, &length);
+            used += length;
+        }
+        sink += used;
+    });
+
+    base64_free(ctx);
+    free(der);
+    free(bundle);
+    free(scratch);
+    free(decoded);
+    return 0;
+}
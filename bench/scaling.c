@@ -0,0 +1,116 @@
+#include "bench.h"
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <string.h>
+
+#include "base64.h"
+
+#define BUFFER_SIZE (64 * 1024)
+
+// Per-thread slot on its own cache line so the harness adds no false sharing
+typedef struct {
+    alignas(64) const base64_ctx_t *ctx;
+    pthread_barrier_t *barrier;
+    size_t iterations;
+    int decode;
+    uint8_t *input;
+    char *encoded;
+    size_t encoded_length;
+    size_t checksum;
+} worker_t;
+
+static void *worker_main(void *arg) {
+    worker_t *w = arg;
+    uint8_t *decoded = aligned_alloc(64, 2 * BUFFER_SIZE);
+    size_t length = 0, checksum = 0;
+
+    pthread_barrier_wait(w->barrier);
+    for (size_t i = 0; i < w->iterations; ++i) {
+        const base64_error_t error = w->decode
+                                         ? base64_decode(w->ctx, w->encoded, w->encoded_length,
+                                                         decoded, 2 * BUFFER_SIZE, &length)
+                                         : base64_encode(w->ctx, w->input, BUFFER_SIZE,
+                                                         w->encoded, 2 * BUFFER_SIZE, &length);
+        checksum += error == BASE64_SUCCESS ? length : 0;
+    }
+    pthread_barrier_wait(w->barrier);
+
+    w->checksum = checksum;
+    free(decoded);
+    return NULL;
+}
+
+// Run `threads` workers that all share one context; returns wall seconds
+static double run(const base64_ctx_t *ctx, worker_t *workers, const unsigned threads,
+                  const size_t iterations, const int decode) {
+    pthread_t handles[256];
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, threads + 1);
+
+    for (unsigned t = 0; t < threads; ++t) {
+        workers[t].ctx = ctx;
+        workers[t].barrier = &barrier;
+        workers[t].iterations = iterations;
+        workers[t].decode = decode;
+        pthread_create(&handles[t], NULL, worker_main, &workers[t]);
+    }
+
+    pthread_barrier_wait(&barrier);
+    const double start = bench_now();
+    pthread_barrier_wait(&barrier);
+    const double elapsed = bench_now() - start;
+
+    for (unsigned t = 0; t < threads; ++t) {
+        pthread_join(handles[t], NULL);
+    }
+    pthread_barrier_destroy(&barrier);
+    return elapsed;
+}
+
+int main(int argc, char *argv[]) {
+    size_t max_threads = bench_arg(argc, argv, 1, 64);
+    const size_t iterations = bench_arg(argc, argv, 2, 2000);
+    if (max_threads > 256) max_threads = 256;
+
+    base64_config_t config = {1, 0, 76, "\n", 1};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+
+    worker_t *workers = aligned_alloc(64, max_threads * sizeof(worker_t));
+    memset(workers, 0, max_threads * sizeof(worker_t));
+    for (size_t t = 0; t < max_threads; ++t) {
+        workers[t].input = aligned_alloc(64, BUFFER_SIZE);
+        workers[t].encoded = aligned_alloc(64, 2 * BUFFER_SIZE);
+        bench_fill(workers[t].input, BUFFER_SIZE, t + 1);
+        base64_encode(ctx, workers[t].input, BUFFER_SIZE, workers[t].encoded, 2 * BUFFER_SIZE,
+                      &workers[t].encoded_length);
+    }
+
+    printf("base64, one shared context, %d KiB per call, %zu calls per thread\n", BUFFER_SIZE / 1024, iterations);
+    printf("%-8s %-7s %14s %10s\n", "threads", "op", "aggregate", "efficiency");
+    for (int decode = 0; decode <= 1; ++decode) {
+        double single = 0;
+        for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+            const double seconds = run(ctx, workers, (unsigned) threads, iterations, decode);
+            for (size_t t = 0; t < threads; ++t) {
+                if (workers[t].checksum != iterations * (decode ? BUFFER_SIZE : workers[t].encoded_length)) {
+                    fprintf(stderr, "thread %zu produced wrong output\n", t);
+                    return 1;
+                }
+            }
+            const double rate = (double) (threads * iterations * BUFFER_SIZE) / seconds / (1024.0 * 1024.0);
+            if (threads == 1) single = rate;
+            printf("%-8zu %-7s %9.1f MiB/s %9.0f%%\n", threads, decode ? "decode" : "encode", rate,
+                   100.0 * rate / (single * (double) threads));
+        }
+    }
+
+    for (size_t t = 0; t < max_threads; ++t) {
+        free(workers[t].input);
+        free(workers[t].encoded);
+    }
+    free(workers);
+    base64_free(ctx);
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include "bench.h"
+
+#include <string.h>
+
+#include "base16.h"
+#include "base32.h"
+#include "base64.h"
+#include "bytes.h"
+#include "swar.h"
+#include "tables.h"
+
+#define BUFFER (1u << 20)
+#define ROUNDS 5
+
+static char text[BUFFER];
+static uint8_t output[BUFFER];
+static volatile uint64_t sink;
+
+// Byte loop: one table lookup per character, values gathered into a word
+static uint64_t classify_table(const uint8_t *table, const uint8_t *p, uint64_t *values) {
+    uint64_t v = 0;
+    for (int k = 0; k < 8; k++) {
+        v = v << 8 | table[p[k]];
+    }
+    *values = v;
+    return v & SWAR_HIGH;
+}
+
+// Run `body` over every 8-character word of text and report the best of
+// ROUNDS passes; body sets invalid and bits for the word at p
+#define MEASURE(name, repeat, body)                                     \
+    do {                                                                \
+        double best = 0;                                                \
+        uint64_t acc = 0;                                               \
+        for (int round = 0; round < ROUNDS; ++round) {                  \
+            const double start = bench_now();                           \
+            for (size_t r = 0; r < (repeat); ++r) {                     \
+                for (size_t i = 0; i + 8 <= BUFFER; i += 8) {           \
+                    const uint8_t *p = (const uint8_t *) text + i;      \
+                    uint64_t values, bits, invalid;                     \
+                    body;                                               \
+                    acc |= invalid;                                     \
+                    store_be64(output + i / 2, bits);                   \
+                }                                                       \
+            }                                                           \
+            const double elapsed = bench_now() - start;                 \
+            if (round == 0 || elapsed < best) best = elapsed;           \
+        }                                                               \
+        sink = acc;                                                     \
+        bench_report(name, (size_t) (repeat) * BUFFER, best);           \
+    } while (0)
+
+// Time whole-buffer calls of `body`, best of ROUNDS
+#define MEASURE_CALL(name, repeat, bytes, body)                         \
+    do {                                                                \
+        double best = 0;                                                \
+        for (int round = 0; round < ROUNDS; ++round) {                  \
+            const double start = bench_now();                           \
+            for (size_t r = 0; r < (repeat); ++r) {                     \
+                body;                                                   \
+            }                                                           \
+            const double elapsed = bench_now() - start;                 \
+            if (round == 0 || elapsed < best) best = elapsed;           \
+        }                                                               \
+        bench_report(name, (size_t) (repeat) * (bytes), best);          \
+    } while (0)
+
+// Pack per-character values the way the table-driven kernels in src/ do
+static uint64_t gather(const uint64_t values, const unsigned bits_per_char) {
+    uint64_t packed = 0;
+    for (int k = 0; k < 8; k++) {
+        packed = packed << bits_per_char | ((values >> (56 - 8 * k)) & ((1u << bits_per_char) - 1));
+    }
+    return packed;
+}
+
+int main(int argc, char *argv[]) {
+    const size_t repeat = bench_arg(argc, argv, 1, 20);
+    uint8_t *raw = malloc(BUFFER);
+    bench_fill(raw, BUFFER, 3);
+    size_t length, decoded;
+
+    printf("%s build, best of %d\n", BEK_SWAR ? "SWAR" : "BEK_NO_SWAR", ROUNDS);
+
+    base16_config_t hex_config = {0, 0, "", 1};
+    base16_ctx_t *hex;
+    base16_init(&hex, &hex_config);
+    base16_encode(hex, raw, BUFFER / 2, text, sizeof(text), &length);
+    MEASURE("hex    table byte loop", repeat, {
+        invalid = classify_table(bek_base16_decode, p, &values);
+        bits = gather(values, 4);
+    });
+    MEASURE("hex    swar_hex_classify", repeat, {
+        invalid = swar_hex_classify(load_be64(p), &values);
+        bits = swar_pack4(values);
+    });
+    MEASURE_CALL("hex    base16_decode", repeat, length,
+                 base16_decode(hex, text, length, output, sizeof(output), &decoded));
+    base16_free(hex);
+
+    base64_config_t b64_config = {0, 0, 0, "", 1};
+    base64_ctx_t *b64;
+    base64_init(&b64, &b64_config);
+    base64_encode(b64, raw, BUFFER / 4 * 3, text, sizeof(text), &length);
+    MEASURE("base64 table byte loop", repeat, {
+        invalid = classify_table(bek_base64_standard_decode, p, &values);
+        bits = gather(values, 6);
+    });
+    MEASURE("base64 swar_base64_classify", repeat, {
+        invalid = swar_base64_classify(load_be64(p), 0, &values);
+        bits = swar_pack6(values);
+    });
+    MEASURE_CALL("base64 base64_decode", repeat, length,
+                 base64_decode(b64, text, length, output, sizeof(output), &decoded));
+    base64_free(b64);
+
+    base32_config_t b32_config = {0, 0, 0, "", 1};
+    base32_ctx_t *b32;
+    base32_init(&b32, &b32_config);
+    base32_encode(b32, raw, BUFFER / 8 * 5, text, sizeof(text), &length);
+    MEASURE("base32 table byte loop", repeat, {
+        invalid = classify_table(bek_base32_standard_decode, p, &values);
+        bits = gather(values, 5);
+    });
+    MEASURE("base32 swar_base32_classify", repeat, {
+        invalid = swar_base32_classify(load_be64(p), 0, &values);
+        bits = swar_pack5(values);
+    });
+    MEASURE_CALL("base32 base32_decode", repeat, length,
+                 base32_decode(b32, text, length, output, sizeof(output), &decoded));
+    MEASURE_CALL("base32 base32_decode_slop", repeat, length,
+                 base32_decode_slop(b32, text, length, output, sizeof(output), &decoded));
+    base32_free(b32);
+
+    sink = decoded;
+    free(raw);
+    return 0;
+}
@@ -0,0 +1,281 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bek_codec.h"
+#include "bek_file.h"
+#include "pipeline.h"
+
+#define BEK_DEFAULT_CHUNK_KIB 1024
+#define BEK_DEFAULT_WRAP 76
+
+typedef struct {
+    const char *name;
+    bek_codec_kind_t kind;
+    int variant; // url_safe for base64, use_hex for base32, use_z85 for base85
+} codec_entry_t;
+
+static const codec_entry_t codecs[] = {
+    {"base64", BEK_CODEC_BASE64, 0},
+    {"base64url", BEK_CODEC_BASE64, 1},
+    {"base32", BEK_CODEC_BASE32, 0},
+    {"base32hex", BEK_CODEC_BASE32, 1},
+    {"hex", BEK_CODEC_BASE16, 0},
+    {"base16", BEK_CODEC_BASE16, 0},
+    {"z85", BEK_CODEC_BASE85, 1},
+};
+
+static void usage(FILE *stream) {
+    fprintf(stream,
+            "Usage: bek [-d] [-m] [-c CODEC] [-w COLS] [-j THREADS] [-b KIB] [-o OUTPUT] [INPUT]\n"
+            "Encode or decode INPUT (standard input by default) to OUTPUT (standard output).\n"
+            "\n"
+            "  -d          decode instead of encode\n"
+            "  -m          memory-map INPUT and OUTPUT (both must be regular files)\n"
+            "  -c CODEC    base64 (default), base64url, base32, base32hex, hex, z85\n"
+            "  -w COLS     wrap encoded lines after COLS characters, 0 disables (default %d)\n"
+            "  -j THREADS  number of worker threads (default: online CPUs)\n"
+            "  -b KIB      chunk size in KiB handed to each worker (default %d)\n"
+            "  -o OUTPUT   write to OUTPUT instead of standard output\n"
+            "  -h          show this help\n",
+            BEK_DEFAULT_WRAP, BEK_DEFAULT_CHUNK_KIB);
+}
+
+static int parse_size(const char *text, unsigned long *value) {
+    char *end;
+    errno = 0;
+    *value = strtoul(text, &end, 10);
+    return errno == 0 && end != text && *end == '\0' && text[0] != '-' ? 0 : -1;
+}
+
+static const codec_entry_t *find_codec(const char *name) {
+    for (size_t i = 0; i < sizeof(codecs) / sizeof(codecs[0]); ++i) {
+        if (strcmp(codecs[i].name, name) == 0) return &codecs[i];
+    }
+    return NULL;
+}
+
+// Create the library context behind a codec handle; returns 0 on success
+static int codec_open(bek_codec_t *codec, const codec_entry_t *entry, const int wrap) {
+    codec->kind = entry->kind;
+
+    switch (entry->kind) {
+        case BEK_CODEC_BASE64: {
+            const base64_config_t config = {
+                .use_padding = 1, .url_safe = entry->variant, .line_length = wrap,
+                .line_ending = "\n", .omit_terminator = 1
+            };
+            base64_ctx_t *ctx;
+            if (base64_init(&ctx, &config) != BASE64_SUCCESS) return -1;
+            codec->ctx.base64 = ctx;
+            return 0;
+        }
+        case BEK_CODEC_BASE32: {
+            const base32_config_t config = {
+                .use_padding = 1, .use_hex = entry->variant, .line_length = wrap,
+                .line_ending = "\n", .omit_terminator = 1
+            };
+            base32_ctx_t *ctx;
+            if (base32_init(&ctx, &config) != BASE32_SUCCESS) return -1;
+            codec->ctx.base32 = ctx;
+            return 0;
+        }
+        case BEK_CODEC_BASE16: {
+            const base16_config_t config = {
+                .uppercase = 1, .line_length = wrap, .line_ending = "\n", .omit_terminator = 1
+            };
+            base16_ctx_t *ctx;
+            if (base16_init(&ctx, &config) != BASE16_SUCCESS) return -1;
+            codec->ctx.base16 = ctx;
+            return 0;
+        }
+        case BEK_CODEC_BASE85: {
+            const base85_config_t config = {
+                .use_z85 = entry->variant, .line_length = wrap, .line_ending = "\n", .omit_terminator = 1
+            };
+            base85_ctx_t *ctx;
+            if (base85_init(&ctx, &config) != BASE85_SUCCESS) return -1;
+            codec->ctx.base85 = ctx;
+            return 0;
+        }
+        default:
+            return -1;
+    }
+}
+
+static void codec_close(const bek_codec_t *codec) {
+    switch (codec->kind) {
+        case BEK_CODEC_BASE64: base64_free((base64_ctx_t *) codec->ctx.base64); break;
+        case BEK_CODEC_BASE32: base32_free((base32_ctx_t *) codec->ctx.base32); break;
+        case BEK_CODEC_BASE16: base16_free((base16_ctx_t *) codec->ctx.base16); break;
+        case BEK_CODEC_BASE85: base85_free((base85_ctx_t *) codec->ctx.base85); break;
+    }
+}
+
+// Transcode between two regular files through memory mappings
+static int run_mapped(const codec_entry_t *entry, const int decode, const int wrap,
+                      const char *input_path, const char *output_path,
+                      const unsigned workers, const size_t chunk_size) {
+    bek_codec_t codec;
+    if (codec_open(&codec, entry, decode ? 0 : wrap) != 0) {
+        fprintf(stderr, "bek: failed to initialize %s codec\n", entry->name);
+        return 1;
+    }
+
+    const bek_file_options_t options = {.threads = workers, .chunk_size = chunk_size};
+    const bek_error_t error = decode
+                                  ? bek_decode_file(&codec, input_path, output_path, &options)
+                                  : bek_encode_file(&codec, input_path, output_path, &options);
+    codec_close(&codec);
+
+    if (error == BEK_ERROR_IO) {
+        fprintf(stderr, "bek: %s\n", strerror(errno));
+        return 1;
+    }
+    if (error != BEK_SUCCESS) {
+        fprintf(stderr, "bek: %s\n", bek_error_string(error));
+        return 1;
+    }
+
+    // Match the streaming mode, which ends wrapped output with a line break
+    if (!decode && wrap > 0) {
+        const int fd = open(output_path, O_RDWR);
+        const off_t size = fd < 0 ? -1 : lseek(fd, 0, SEEK_END);
+        char last = '\n';
+        if (fd < 0 || size < 0 || (size > 0 && pread(fd, &last, 1, size - 1) != 1) ||
+            (last != '\n' && write(fd, "\n", 1) != 1) || close(fd) != 0) {
+            fprintf(stderr, "bek: %s: %s\n", output_path, strerror(errno));
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const codec_entry_t *entry = &codecs[0];
+    const char *output_path = NULL;
+    unsigned long wrap = BEK_DEFAULT_WRAP;
+    unsigned long chunk_kib = BEK_DEFAULT_CHUNK_KIB;
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned long workers = online > 0 ? (unsigned long) online : 1;
+    int decode = 0;
+    int mapped = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "dmc:w:j:b:o:h")) != -1) {
+        switch (opt) {
+            case 'd':
+                decode = 1;
+                break;
+            case 'm':
+                mapped = 1;
+                break;
+            case 'c':
+                entry = find_codec(optarg);
+                if (entry == NULL) {
+                    fprintf(stderr, "bek: unknown codec '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'w':
+                if (parse_size(optarg, &wrap) != 0 || wrap > 1UL << 20) {
+                    fprintf(stderr, "bek: invalid wrap width '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'j':
+                if (parse_size(optarg, &workers) != 0 || workers == 0 || workers > 1024) {
+                    fprintf(stderr, "bek: invalid thread count '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'b':
+                if (parse_size(optarg, &chunk_kib) != 0 || chunk_kib == 0 || chunk_kib > 1UL << 20) {
+                    fprintf(stderr, "bek: invalid chunk size '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'o':
+                output_path = optarg;
+                break;
+            case 'h':
+                usage(stdout);
+                return 0;
+            default:
+                usage(stderr);
+                return 2;
+        }
+    }
+
+    if (argc - optind > 1) {
+        usage(stderr);
+        return 2;
+    }
+
+    if (mapped) {
+        if (optind == argc || output_path == NULL) {
+            fprintf(stderr, "bek: -m needs an INPUT file and -o OUTPUT\n");
+            return 2;
+        }
+        return run_mapped(entry, decode, (int) wrap, argv[optind], output_path,
+                          (unsigned) workers, chunk_kib * 1024);
+    }
+
+    int input_fd = STDIN_FILENO;
+    if (optind < argc && strcmp(argv[optind], "-") != 0) {
+        input_fd = open(argv[optind], O_RDONLY);
+        if (input_fd < 0) {
+            fprintf(stderr, "bek: %s: %s\n", argv[optind], strerror(errno));
+            return 1;
+        }
+    }
+
+    int output_fd = STDOUT_FILENO;
+    if (output_path != NULL) {
+        output_fd = open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (output_fd < 0) {
+            fprintf(stderr, "bek: %s: %s\n", output_path, strerror(errno));
+            return 1;
+        }
+    }
+
+    bek_codec_t codec;
+    if (codec_open(&codec, entry, decode ? 0 : (int) wrap) != 0) {
+        fprintf(stderr, "bek: failed to initialize %s codec\n", entry->name);
+        return 1;
+    }
+
+    const pipeline_config_t config = {
+        .codec = &codec,
+        .decode = decode,
+        .chunk_size = chunk_kib * 1024,
+        .workers = (unsigned) workers,
+        .input_fd = input_fd,
+        .output_fd = output_fd,
+        .final_newline = wrap > 0,
+    };
+
+    pipeline_result_t result;
+    const int status = pipeline_run(&config, &result);
+    codec_close(&codec);
+
+    if (status != 0) {
+        if (result.io_errno != 0) {
+            fprintf(stderr, "bek: %s\n", strerror(result.io_errno));
+        } else {
+            fprintf(stderr, "bek: %s (chunk %zu)\n", bek_error_string(result.error), result.chunk_index);
+        }
+        return 1;
+    }
+
+    if (output_fd != STDOUT_FILENO && close(output_fd) != 0) {
+        fprintf(stderr, "bek: %s: %s\n", output_path, strerror(errno));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,320 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "pipeline.h"
+
+typedef enum {
+    SLOT_FREE = 0, // Owned by the reader
+    SLOT_FILLED,   // Waiting for a worker
+    SLOT_DONE      // Waiting for the writer
+} slot_state_t;
+
+typedef struct {
+    slot_state_t state;
+    uint8_t *input;
+    size_t input_length;
+    uint8_t *output;
+    size_t output_length;
+} slot_t;
+
+typedef struct {
+    const pipeline_config_t *config;
+    slot_t *slots;
+    size_t slot_count;
+    size_t chunk_size;
+    size_t input_capacity;
+    size_t output_capacity;
+    size_t group_chars;
+
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    size_t filled;   // Chunks published by the reader
+    size_t next_job; // Next chunk handed to a worker
+    int eof;         // Reader finished, filled is final
+    int failed;
+    pipeline_result_t result;
+} pipeline_t;
+
+// Record the first failure and wake everyone up; called with the lock held
+static void fail(pipeline_t *p, const size_t chunk, const bek_error_t error, const int io_errno) {
+    if (!p->failed) {
+        p->failed = 1;
+        p->result.error = error;
+        p->result.io_errno = io_errno;
+        p->result.chunk_index = chunk;
+    }
+    pthread_cond_broadcast(&p->changed);
+}
+
+static void fail_locked(pipeline_t *p, const size_t chunk, const bek_error_t error, const int io_errno) {
+    pthread_mutex_lock(&p->lock);
+    fail(p, chunk, error, io_errno);
+    pthread_mutex_unlock(&p->lock);
+}
+
+static ssize_t read_full(const int fd, uint8_t *buffer, const size_t length) {
+    size_t total = 0;
+    while (total < length) {
+        const ssize_t n = read(fd, buffer + total, length - total);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) break;
+        total += (size_t) n;
+    }
+    return (ssize_t) total;
+}
+
+static int write_full(const int fd, const uint8_t *buffer, size_t length) {
+    while (length > 0) {
+        const ssize_t n = write(fd, buffer, length);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buffer += n;
+        length -= (size_t) n;
+    }
+    return 0;
+}
+
+static int is_space(const uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+// Move the significant characters past the last whole quantum into carry and
+// return the new chunk length
+static size_t cut_at_quantum(const pipeline_t *p, const uint8_t *input, const size_t length,
+                             uint8_t *carry, size_t *carry_length) {
+    size_t significant = 0;
+    for (size_t i = 0; i < length; ++i) {
+        significant += !is_space(input[i]);
+    }
+
+    size_t cut = length;
+    for (size_t excess = significant % p->group_chars; excess > 0;) {
+        if (!is_space(input[--cut])) excess--;
+    }
+
+    *carry_length = 0;
+    for (size_t i = cut; i < length; ++i) {
+        if (!is_space(input[i])) carry[(*carry_length)++] = input[i];
+    }
+    return cut;
+}
+
+static void *reader_main(void *arg) {
+    pipeline_t *p = arg;
+    uint8_t carry[16];
+    size_t carry_length = 0;
+
+    for (size_t seq = 0;; ++seq) {
+        slot_t *slot = &p->slots[seq % p->slot_count];
+
+        pthread_mutex_lock(&p->lock);
+        while (!p->failed && slot->state != SLOT_FREE) {
+            pthread_cond_wait(&p->changed, &p->lock);
+        }
+        const int failed = p->failed;
+        pthread_mutex_unlock(&p->lock);
+        if (failed) break;
+
+        memcpy(slot->input, carry, carry_length);
+        const ssize_t n = read_full(p->config->input_fd, slot->input + carry_length, p->chunk_size);
+        if (n < 0) {
+            fail_locked(p, seq, BEK_SUCCESS, errno);
+            break;
+        }
+
+        const int last = (size_t) n < p->chunk_size;
+        size_t length = carry_length + (size_t) n;
+        carry_length = 0;
+        if (p->config->decode && !last) {
+            length = cut_at_quantum(p, slot->input, length, carry, &carry_length);
+        }
+
+        if (length > 0 || !last) {
+            slot->input_length = length;
+            pthread_mutex_lock(&p->lock);
+            slot->state = SLOT_FILLED;
+            p->filled++;
+            pthread_cond_broadcast(&p->changed);
+            pthread_mutex_unlock(&p->lock);
+        }
+        if (last) break;
+    }
+
+    pthread_mutex_lock(&p->lock);
+    p->eof = 1;
+    pthread_cond_broadcast(&p->changed);
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+static void *worker_main(void *arg) {
+    pipeline_t *p = arg;
+
+    pthread_mutex_lock(&p->lock);
+    for (;;) {
+        while (!p->failed && !p->eof && p->next_job == p->filled) {
+            pthread_cond_wait(&p->changed, &p->lock);
+        }
+        if (p->failed || p->next_job == p->filled) break;
+
+        const size_t seq = p->next_job++;
+        slot_t *slot = &p->slots[seq % p->slot_count];
+        pthread_mutex_unlock(&p->lock);
+
+        const bek_error_t error = p->config->decode
+                                      ? bek_decode(p->config->codec, (const char *) slot->input, slot->input_length,
+                                                   slot->output, p->output_capacity, &slot->output_length)
+                                      : bek_encode(p->config->codec, slot->input, slot->input_length,
+                                                   (char *) slot->output, p->output_capacity, &slot->output_length);
+
+        pthread_mutex_lock(&p->lock);
+        if (error != BEK_SUCCESS) {
+            fail(p, seq, error, 0);
+            break;
+        }
+        slot->state = SLOT_DONE;
+        pthread_cond_broadcast(&p->changed);
+    }
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+static void *writer_main(void *arg) {
+    pipeline_t *p = arg;
+    size_t total = 0;
+    uint8_t last_byte = 0;
+
+    for (size_t seq = 0;; ++seq) {
+        slot_t *slot = &p->slots[seq % p->slot_count];
+
+        pthread_mutex_lock(&p->lock);
+        while (!p->failed && !(seq < p->filled && slot->state == SLOT_DONE) && !(p->eof && seq == p->filled)) {
+            pthread_cond_wait(&p->changed, &p->lock);
+        }
+        const int stop = p->failed || seq == p->filled;
+        pthread_mutex_unlock(&p->lock);
+        if (stop) break;
+
+        if (write_full(p->config->output_fd, slot->output, slot->output_length) != 0) {
+            fail_locked(p, seq, BEK_SUCCESS, errno);
+            return NULL;
+        }
+        if (slot->output_length > 0) {
+            total += slot->output_length;
+            last_byte = slot->output[slot->output_length - 1];
+        }
+
+        pthread_mutex_lock(&p->lock);
+        slot->state = SLOT_FREE;
+        pthread_cond_broadcast(&p->changed);
+        pthread_mutex_unlock(&p->lock);
+    }
+
+    if (!p->failed && p->config->final_newline && !p->config->decode && total > 0 && last_byte != '\n') {
+        if (write_full(p->config->output_fd, (const uint8_t *) "\n", 1) != 0) {
+            fail_locked(p, 0, BEK_SUCCESS, errno);
+        }
+    }
+    return NULL;
+}
+
+static int pipeline_alloc(pipeline_t *p) {
+    size_t group_bytes;
+    if (bek_get_quantum(p->config->codec, &group_bytes, &p->group_chars) != BEK_SUCCESS ||
+        p->group_chars > 16) {
+        return -1;
+    }
+
+    if (p->config->decode) {
+        p->chunk_size = p->config->chunk_size < p->group_chars ? p->group_chars : p->config->chunk_size;
+        // Room for the carried partial quantum in front of each read
+        p->input_capacity = p->chunk_size + p->group_chars;
+        bek_get_decode_size(p->config->codec, p->input_capacity, &p->output_capacity);
+    } else {
+        p->chunk_size = bek_encode_chunk_size(p->config->codec, p->config->chunk_size);
+        p->input_capacity = p->chunk_size;
+        bek_get_encode_size(p->config->codec, p->input_capacity, &p->output_capacity);
+    }
+
+    // Two chunks per worker keep the pool busy while the reader and the
+    // writer each hold one more
+    p->slot_count = 2 * (size_t) p->config->workers + 2;
+    p->slots = calloc(p->slot_count, sizeof(slot_t));
+    if (p->slots == NULL) return -1;
+
+    for (size_t i = 0; i < p->slot_count; ++i) {
+        p->slots[i].input = malloc(p->input_capacity);
+        p->slots[i].output = malloc(p->output_capacity);
+        if (p->slots[i].input == NULL || p->slots[i].output == NULL) return -1;
+    }
+    return 0;
+}
+
+static void pipeline_release(pipeline_t *p) {
+    if (p->slots != NULL) {
+        for (size_t i = 0; i < p->slot_count; ++i) {
+            free(p->slots[i].input);
+            free(p->slots[i].output);
+        }
+        free(p->slots);
+    }
+}
+
+int pipeline_run(const pipeline_config_t *config, pipeline_result_t *result) {
+    pipeline_t p = {0};
+    p.config = config;
+    p.result.error = BEK_SUCCESS;
+
+    if (config->workers == 0 || pipeline_alloc(&p) != 0) {
+        pipeline_release(&p);
+        result->error = BEK_ERROR_MEMORY;
+        result->io_errno = 0;
+        result->chunk_index = 0;
+        return -1;
+    }
+
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.changed, NULL);
+
+    pthread_t reader, writer;
+    pthread_t *workers = malloc(config->workers * sizeof(pthread_t));
+    unsigned started = 0;
+    int ok = workers != NULL && pthread_create(&reader, NULL, reader_main, &p) == 0;
+    if (ok) {
+        while (started < config->workers && pthread_create(&workers[started], NULL, worker_main, &p) == 0) {
+            started++;
+        }
+        if (started == 0) fail_locked(&p, 0, BEK_ERROR_MEMORY, 0);
+        if (pthread_create(&writer, NULL, writer_main, &p) != 0) {
+            fail_locked(&p, 0, BEK_ERROR_MEMORY, 0);
+        } else {
+            pthread_join(writer, NULL);
+        }
+        // Workers exit on failure, so a partial pool is still drained
+        for (unsigned i = 0; i < started; ++i) {
+            pthread_join(workers[i], NULL);
+        }
+        pthread_join(reader, NULL);
+    } else {
+        p.failed = 1;
+        p.result.error = BEK_ERROR_MEMORY;
+    }
+
+    free(workers);
+    pthread_cond_destroy(&p.changed);
+    pthread_mutex_destroy(&p.lock);
+    pipeline_release(&p);
+
+    *result = p.result;
+    return p.failed ? -1 : 0;
+}
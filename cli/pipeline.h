@@ -0,0 +1,28 @@
+#ifndef BEK_CLI_PIPELINE_H
+#define BEK_CLI_PIPELINE_H
+
+#include <stddef.h>
+
+#include "bek_codec.h"
+
+// Reader -> worker pool -> ordered writer over a fixed ring of chunk slots
+typedef struct {
+    const bek_codec_t *codec;
+    int decode;          // Decode instead of encode
+    size_t chunk_size;   // Input bytes per chunk (aligned internally)
+    unsigned workers;    // Number of worker threads (at least 1)
+    int input_fd;
+    int output_fd;
+    int final_newline;   // Terminate encoded output with '\n' if not already
+} pipeline_config_t;
+
+typedef struct {
+    bek_error_t error;   // First codec error, BEK_SUCCESS otherwise
+    int io_errno;        // errno of the first failed read/write, 0 otherwise
+    size_t chunk_index;  // Chunk that failed
+} pipeline_result_t;
+
+// Run the pipeline to completion; returns 0 on success, -1 on failure
+int pipeline_run(const pipeline_config_t *config, pipeline_result_t *result);
+
+#endif //BEK_CLI_PIPELINE_H
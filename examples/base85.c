@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "base85.h"
+
+
+int main(int argc, char *argv[]) {
+    base85_ctx_t *ctx;
+    base85_config_t config = {
+        .use_z85 = 1,
+        .line_length = 76,
+        .line_ending = "\n"
+    };
+
+    base85_init(&ctx, &config);
+
+    // Prepare buffers
+    uint8_t input[] = "Hello, World!";
+    char encoded[100];
+    uint8_t decoded[100];
+    size_t encoded_len, decoded_len;
+
+    // Encode
+    base85_encode(ctx, input, strlen((char *) input),
+                  encoded, sizeof(encoded), &encoded_len);
+
+    printf("Encoded: %s\n", encoded);
+
+    // Decode
+    base85_decode(ctx, encoded, encoded_len,
+                  decoded, sizeof(decoded), &decoded_len);
+
+    printf("Decoded: %.*s\n", (int) decoded_len, decoded);
+    // Free context when done
+    base85_free(ctx);
+
+    printf("\n");
+    return 0;
+}
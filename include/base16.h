@@ -27,6 +27,9 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <sys/uio.h>
+
+#include "bek.h"
 
 /**
  * @brief Error codes for base16 operations
@@ -37,7 +40,8 @@ typedef enum {
     BASE16_ERROR_INVALID_LENGTH,   // Input length is invalid
     BASE16_ERROR_BUFFER_TOO_SMALL, // Output buffer is too small
     BASE16_ERROR_NULL_POINTER,     // NULL pointer provided
-    BASE16_ERROR_MEMORY            // Memory allocation failure
+    BASE16_ERROR_MEMORY,           // Memory allocation failure
+    BASE16_ERROR_CALLBACK          // Output callback aborted
 } base16_error_t;
 
 /**
@@ -47,16 +51,36 @@ typedef struct {
     int uppercase;             // Use uppercase (A-F) or lowercase (a-f) letters
     int line_length;           // Length of lines (0 for no line breaks)
     char line_ending[3];       // Line ending sequence (e.g., "\r\n")
+    int omit_terminator;       // Exact-size output without a trailing '\0'
+    const char *ignore;        // Characters decoding skips, one-shot and streaming alike (NULL for C-locale whitespace)
+    const bek_allocator_t *allocator; // Allocator of the context (NULL for the library allocator)
+    bek_store_mode_t stores;   // Output stores of one-shot encodes (BEK_STORE_AUTO by default)
 } base16_config_t;
 
+/**
+ * @brief Number of bytes the slop variants may read past the end of the input
+ *        and write past the end of the output
+ *
+ * Callers of base16_encode_slop() and base16_decode_slop() must guarantee that
+ * this many bytes are addressable after both buffers. The contents of the
+ * output slop region are unspecified after the call.
+ */
+#define BASE16_SLOP_BYTES 32
+
 /**
  * @brief Base16 context structure
+ *
+ * Holds only configuration and lookup tables and is never modified after
+ * base16_init(), so one context may be shared by any number of threads.
+ * Per-stream state lives in a separate bek_stream_t.
  */
 typedef struct base16_ctx_t base16_ctx_t;
 
 /**
  * @brief Initialize a base16 context with the given configuration
  *
+ * Returns BASE16_ERROR_INVALID_INPUT if the ignore set contains a hex digit.
+ *
  * @param ctx Pointer to context pointer to be initialized
  * @param config Configuration options (NULL for defaults)
  * @return base16_error_t Error code
@@ -66,6 +90,10 @@ base16_error_t base16_init(base16_ctx_t **ctx, const base16_config_t *config);
 /**
  * @brief Calculate required buffer size for encoding
  *
+ * The size includes one byte for the '\0' terminator unless the context was
+ * configured with omit_terminator, in which case it is the exact number of
+ * characters the encoder writes.
+ *
  * @param input_length Length of input data
  * @param ctx Base16 context
  * @param output_size Pointer to store required output size
@@ -98,7 +126,7 @@ base16_error_t base16_get_decode_size(size_t input_length,
  * @param output_length Pointer to store actual output length
  * @return base16_error_t Error code
  */
-base16_error_t base16_encode(base16_ctx_t *ctx,
+base16_error_t base16_encode(const base16_ctx_t *ctx,
                              const uint8_t *input,
                              size_t input_length,
                              char *output,
@@ -108,6 +136,11 @@ base16_error_t base16_encode(base16_ctx_t *ctx,
 /**
  * @brief Decode base16 string to binary data
  *
+ * Characters of the configured ignore set are skipped anywhere. Runs of
+ * digits decode in place; from the first character that breaks a run the
+ * input is compacted a few KiB at a time into a stack buffer and decoded a
+ * block at a time.
+ *
  * @param ctx Base16 context
  * @param input Input base16 string
  * @param input_length Length of input string
@@ -116,13 +149,339 @@ base16_error_t base16_encode(base16_ctx_t *ctx,
  * @param output_length Pointer to store actual output length
  * @return base16_error_t Error code
  */
-base16_error_t base16_decode(base16_ctx_t *ctx,
+base16_error_t base16_decode(const base16_ctx_t *ctx,
                              const char *input,
                              size_t input_length,
                              uint8_t *output,
                              size_t output_size,
                              size_t *output_length);
 
+/**
+ * @brief Encode binary data to base16 string using the padded-buffer contract
+ *
+ * Behaves like base16_encode() but runs the word-at-a-time kernel through the
+ * tail. Both buffers must be followed by BASE16_SLOP_BYTES addressable bytes.
+ * Configurations with line_length > 0 take the regular path.
+ *
+ * @param ctx Base16 context
+ * @param input Input binary data (readable for input_length + BASE16_SLOP_BYTES)
+ * @param input_length Length of input data
+ * @param output Output buffer (writable for output_size + BASE16_SLOP_BYTES)
+ * @param output_size Size of output buffer, excluding the slop region
+ * @param output_length Pointer to store actual output length
+ * @return base16_error_t Error code
+ */
+base16_error_t base16_encode_slop(const base16_ctx_t *ctx,
+                                  const uint8_t *input,
+                                  size_t input_length,
+                                  char *output,
+                                  size_t output_size,
+                                  size_t *output_length);
+
+/**
+ * @brief Decode base16 string to binary data using the padded-buffer contract
+ *
+ * Input must be compact: whitespace is rejected with
+ * BASE16_ERROR_INVALID_INPUT and an odd length with
+ * BASE16_ERROR_INVALID_LENGTH. Both buffers must be followed by
+ * BASE16_SLOP_BYTES addressable bytes.
+ *
+ * @param ctx Base16 context
+ * @param input Input base16 string (readable for input_length + BASE16_SLOP_BYTES)
+ * @param input_length Length of input string
+ * @param output Output buffer (writable for output_size + BASE16_SLOP_BYTES)
+ * @param output_size Size of output buffer, excluding the slop region
+ * @param output_length Pointer to store actual output length
+ * @return base16_error_t Error code
+ */
+base16_error_t base16_decode_slop(const base16_ctx_t *ctx,
+                                  const char *input,
+                                  size_t input_length,
+                                  uint8_t *output,
+                                  size_t output_size,
+                                  size_t *output_length);
+
+/**
+ * @brief Encode binary data to base16 text in UTF-16
+ *
+ * Writes the same text as base16_encode(), line breaks and terminator included,
+ * as UTF-16 code units (native byte order, as in a JavaScript or Java string
+ * buffer). Each character is widened as the kernel stores it, so no char
+ * buffer or second pass is needed. Sizes count code units; the required size
+ * is the one base16_get_encode_size() reports.
+ *
+ * @param ctx Base16 context
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param output Output buffer for UTF-16 code units
+ * @param output_size Size of output buffer in code units
+ * @param output_length Pointer to store actual output length in code units
+ * @return base16_error_t Error code
+ */
+base16_error_t base16_encode_utf16(const base16_ctx_t *ctx,
+                                   const uint8_t *input,
+                                   size_t input_length,
+                                   uint16_t *output,
+                                   size_t output_size,
+                                   size_t *output_length);
+
+/**
+ * @brief Decode base16 text in UTF-16 to binary data
+ *
+ * Accepts what base16_decode() accepts, reading UTF-16 code units (native byte
+ * order). The units are narrowed as the kernels load them; any unit above
+ * 0xFF is BASE16_ERROR_INVALID_INPUT. input_length counts code units.
+ *
+ * @param ctx Base16 context
+ * @param input Input UTF-16 code units
+ * @param input_length Length of input in code units
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base16_error_t Error code
+ */
+base16_error_t base16_decode_utf16(const base16_ctx_t *ctx,
+                                   const uint16_t *input,
+                                   size_t input_length,
+                                   uint8_t *output,
+                                   size_t output_size,
+                                   size_t *output_length);
+
+/**
+ * @brief Encode the next chunk of a stream to base16 string
+ *
+ * Consumes input and produces output until either runs out. A partial quantum
+ * and any output that did not fit are kept in the stream state, so chunks may
+ * be split anywhere. No '\0' terminator is written.
+ *
+ * @param ctx Base16 context
+ * @param stream Stream state initialized with bek_stream_init()
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param input_consumed Pointer to store number of input bytes consumed
+ * @param output Output buffer for base16 string
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base16_error_t Error code
+ */
+base16_error_t base16_encode_update(const base16_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const uint8_t *input,
+                                    size_t input_length,
+                                    size_t *input_consumed,
+                                    char *output,
+                                    size_t output_size,
+                                    size_t *output_length);
+
+/**
+ * @brief Finish a base16 encode stream, writing the last quantum
+ *
+ * Returns BASE16_ERROR_BUFFER_TOO_SMALL if output remains; call again with
+ * more space to receive the rest.
+ *
+ * @param ctx Base16 context
+ * @param stream Stream state
+ * @param output Output buffer for base16 string
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base16_error_t Error code
+ */
+base16_error_t base16_encode_final(const base16_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   char *output,
+                                   size_t output_size,
+                                   size_t *output_length);
+
+/**
+ * @brief Decode the next chunk of a base16 stream to binary data
+ *
+ * Whitespace is skipped. Stops early on invalid input, in which case
+ * input_consumed points at the offending character.
+ *
+ * @param ctx Base16 context
+ * @param stream Stream state initialized with bek_stream_init()
+ * @param input Input base16 string
+ * @param input_length Length of input string
+ * @param input_consumed Pointer to store number of input characters consumed
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base16_error_t Error code
+ */
+base16_error_t base16_decode_update(const base16_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const char *input,
+                                    size_t input_length,
+                                    size_t *input_consumed,
+                                    uint8_t *output,
+                                    size_t output_size,
+                                    size_t *output_length);
+
+/**
+ * @brief Finish a base16 decode stream, writing the bytes of the last quantum
+ *
+ * Returns BASE16_ERROR_INVALID_LENGTH if the stream ended mid-quantum and
+ * BASE16_ERROR_BUFFER_TOO_SMALL if output remains.
+ *
+ * @param ctx Base16 context
+ * @param stream Stream state
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base16_error_t Error code
+ */
+base16_error_t base16_decode_final(const base16_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   uint8_t *output,
+                                   size_t output_size,
+                                   size_t *output_length);
+
+/**
+ * @brief Encode scattered binary data to base16, gathering into an iovec list
+ *
+ * Partial quanta are carried across input segment boundaries and output
+ * spills over into the next segment, so the result can go straight to
+ * writev(). No '\0' terminator is written.
+ *
+ * @param ctx Base16 context
+ * @param input Input segments
+ * @param input_count Number of input segments
+ * @param output Output segments, filled in order
+ * @param output_count Number of output segments
+ * @param output_length Pointer to store total output length
+ * @return base16_error_t Error code
+ */
+base16_error_t base16_encode_iov(const base16_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 int input_count,
+                                 const struct iovec *output,
+                                 int output_count,
+                                 size_t *output_length);
+
+/**
+ * @brief Decode scattered base16 text to binary data in an iovec list
+ *
+ * @param ctx Base16 context
+ * @param input Input segments
+ * @param input_count Number of input segments
+ * @param output Output segments, filled in order
+ * @param output_count Number of output segments
+ * @param output_length Pointer to store total output length
+ * @return base16_error_t Error code
+ */
+base16_error_t base16_decode_iov(const base16_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 int input_count,
+                                 const struct iovec *output,
+                                 int output_count,
+                                 size_t *output_length);
+
+/**
+ * @brief Encode binary data to base16, handing output to a callback in blocks
+ *
+ * Output is produced into an internal block of BEK_SINK_BLOCK_SIZE bytes and
+ * passed to the sink each time it fills, so memory use does not depend on
+ * the input size. No '\0' terminator is written.
+ *
+ * @param ctx Base16 context
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param sink Output callback
+ * @param user_data Pointer passed to the callback
+ * @return base16_error_t Error code, BASE16_ERROR_CALLBACK if the sink aborted
+ */
+base16_error_t base16_encode_to_sink(const base16_ctx_t *ctx,
+                                     const uint8_t *input,
+                                     size_t input_length,
+                                     bek_sink_fn sink,
+                                     void *user_data);
+
+/**
+ * @brief Decode base16 string to binary data, handing output to a callback in blocks
+ *
+ * @param ctx Base16 context
+ * @param input Input base16 string
+ * @param input_length Length of input string
+ * @param sink Output callback
+ * @param user_data Pointer passed to the callback
+ * @return base16_error_t Error code, BASE16_ERROR_CALLBACK if the sink aborted
+ */
+base16_error_t base16_decode_to_sink(const base16_ctx_t *ctx,
+                                     const char *input,
+                                     size_t input_length,
+                                     bek_sink_fn sink,
+                                     void *user_data);
+
+/**
+ * @brief Encode the used region of a ring buffer into the free region of another
+ *
+ * Both rings may wrap; the wrap points are handled internally without
+ * linearising either side. The input ring is left unchanged, the output
+ * ring's length grows by the number of characters written. No '\0'
+ * terminator is written.
+ *
+ * @param ctx Base16 context
+ * @param input Ring holding the binary data to encode
+ * @param output Ring receiving the base16 string
+ * @param output_length Pointer to store number of characters appended
+ * @return base16_error_t Error code; the output ring is only updated on success
+ */
+base16_error_t base16_encode_ring(const base16_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length);
+
+/**
+ * @brief Decode the used region of a ring buffer into the free region of another
+ *
+ * @param ctx Base16 context
+ * @param input Ring holding the base16 string
+ * @param output Ring receiving the binary data
+ * @param output_length Pointer to store number of bytes appended
+ * @return base16_error_t Error code; the output ring is only updated on success
+ */
+base16_error_t base16_decode_ring(const base16_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length);
+
+/**
+ * @brief Encode binary data to base16, appending to a growable buffer
+ *
+ * Reserves the base16_get_encode_size() length once and encodes straight into
+ * the buffer, so a buffer cleared with bek_buf_clear() and reused across calls
+ * stops allocating once it is large enough. The text is always followed by a
+ * '\0', which is not counted in buf->length. On error buf->length is
+ * unchanged.
+ *
+ * @param ctx Base16 context
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param buf Buffer to append to
+ * @return base16_error_t Error code, BASE16_ERROR_MEMORY if the buffer could not grow
+ */
+base16_error_t base16_encode_to_buf(const base16_ctx_t *ctx,
+                                    const uint8_t *input,
+                                    size_t input_length,
+                                    bek_buf_t *buf);
+
+/**
+ * @brief Decode base16 string to binary data, appending to a growable buffer
+ *
+ * Reserves the base16_get_decode_size() bound once and decodes straight into
+ * the buffer. On error buf->length is unchanged.
+ *
+ * @param ctx Base16 context
+ * @param input Input base16 string
+ * @param input_length Length of input string
+ * @param buf Buffer to append to
+ * @return base16_error_t Error code, BASE16_ERROR_MEMORY if the buffer could not grow
+ */
+base16_error_t base16_decode_to_buf(const base16_ctx_t *ctx,
+                                    const char *input,
+                                    size_t input_length,
+                                    bek_buf_t *buf);
+
 /**
  * @brief Get string description of error code
  *
@@ -138,4 +497,191 @@ const char *base16_error_string(base16_error_t error);
  */
 void base16_free(base16_ctx_t *ctx);
 
+/*
+ * Integer conversions
+ *
+ * Format and parse unsigned integers as big-endian hex digits. No context is
+ * needed and nothing is terminated; 128-bit values are passed as high and low
+ * 64-bit halves. The fixed-width formatters always write 8, 16 or 32 digits,
+ * the minimal-width ones drop leading zeros (zero itself is written as "0").
+ */
+
+/**
+ * @brief Format a 32-bit value as exactly 8 hex digits
+ *
+ * @param value Value to format
+ * @param output Output buffer of 8 characters
+ * @param uppercase Non-zero for A-F, zero for a-f
+ */
+void base16_format_u32(uint32_t value, char output[8], int uppercase);
+
+/**
+ * @brief Format a 64-bit value as exactly 16 hex digits
+ *
+ * @param value Value to format
+ * @param output Output buffer of 16 characters
+ * @param uppercase Non-zero for A-F, zero for a-f
+ */
+void base16_format_u64(uint64_t value, char output[16], int uppercase);
+
+/**
+ * @brief Format a 128-bit value as exactly 32 hex digits
+ *
+ * @param high Upper 64 bits
+ * @param low Lower 64 bits
+ * @param output Output buffer of 32 characters
+ * @param uppercase Non-zero for A-F, zero for a-f
+ */
+void base16_format_u128(uint64_t high, uint64_t low, char output[32], int uppercase);
+
+/**
+ * @brief Format a 32-bit value without leading zeros
+ *
+ * @param value Value to format
+ * @param output Output buffer of at least 8 characters
+ * @param uppercase Non-zero for A-F, zero for a-f
+ * @return size_t Number of digits written (1-8)
+ */
+size_t base16_format_u32_min(uint32_t value, char *output, int uppercase);
+
+/**
+ * @brief Format a 64-bit value without leading zeros
+ *
+ * @param value Value to format
+ * @param output Output buffer of at least 16 characters
+ * @param uppercase Non-zero for A-F, zero for a-f
+ * @return size_t Number of digits written (1-16)
+ */
+size_t base16_format_u64_min(uint64_t value, char *output, int uppercase);
+
+/**
+ * @brief Format a 128-bit value without leading zeros
+ *
+ * @param high Upper 64 bits
+ * @param low Lower 64 bits
+ * @param output Output buffer of at least 32 characters
+ * @param uppercase Non-zero for A-F, zero for a-f
+ * @return size_t Number of digits written (1-32)
+ */
+size_t base16_format_u128_min(uint64_t high, uint64_t low, char *output, int uppercase);
+
+/**
+ * @brief Parse 1-8 hex digits into a 32-bit value
+ *
+ * Digits of either case are accepted; prefixes, signs and whitespace are not.
+ *
+ * @param input Hex digits
+ * @param length Number of digits (1-8)
+ * @param value Receives the parsed value; untouched on error
+ * @return base16_error_t Error code (INVALID_LENGTH if length is out of range,
+ *         INVALID_INPUT if any character is not a hex digit)
+ */
+base16_error_t base16_parse_u32(const char *input, size_t length, uint32_t *value);
+
+/**
+ * @brief Parse 1-16 hex digits into a 64-bit value
+ *
+ * @param input Hex digits
+ * @param length Number of digits (1-16)
+ * @param value Receives the parsed value; untouched on error
+ * @return base16_error_t Error code
+ */
+base16_error_t base16_parse_u64(const char *input, size_t length, uint64_t *value);
+
+/**
+ * @brief Parse 1-32 hex digits into a 128-bit value
+ *
+ * @param input Hex digits
+ * @param length Number of digits (1-32)
+ * @param high Receives the upper 64 bits; untouched on error
+ * @param low Receives the lower 64 bits; untouched on error
+ * @return base16_error_t Error code
+ */
+base16_error_t base16_parse_u128(const char *input, size_t length, uint64_t *high, uint64_t *low);
+
+/*
+ * Fixed-length encoders
+ *
+ * Specialised for common digest, key and identifier sizes: no context, no
+ * size query, no line wrapping and no terminator. Characters are computed
+ * arithmetically rather than through a table, so the loops have constant trip
+ * counts, unroll fully and run in constant time with respect to the data.
+ */
+
+/**
+ * @brief Map a nibble to its hex digit without branches
+ *
+ * @param nibble Value 0-15
+ * @param uppercase Non-zero for A-F, zero for a-f
+ * @return char Hex digit
+ */
+static inline char base16_nibble_char(const unsigned nibble, const int uppercase) {
+    // Adds the gap between '9' + 1 and 'A' (or 'a') only when nibble > 9
+    const int letter_gap = uppercase ? 'A' - '9' - 1 : 'a' - '9' - 1;
+    return (char) ('0' + (int) nibble + (((9 - (int) nibble) >> 8) & letter_gap));
+}
+
+/**
+ * @brief Encode a fixed number of bytes as hex
+ *
+ * @param input Input bytes
+ * @param length Number of input bytes (a compile-time constant in callers)
+ * @param output Output buffer of 2 * length characters
+ * @param uppercase Non-zero for uppercase digits
+ */
+static inline void base16_encode_fixed(const uint8_t *input, const size_t length, char *output,
+                                       const int uppercase) {
+    for (size_t i = 0; i < length; i++) {
+        output[2 * i] = base16_nibble_char(input[i] >> 4, uppercase);
+        output[2 * i + 1] = base16_nibble_char(input[i] & 0x0F, uppercase);
+    }
+}
+
+/**
+ * @brief Encode a 16-byte UUID in the canonical 8-4-4-4-12 form
+ *
+ * @param input 16 UUID bytes in network order
+ * @param output Output buffer of 36 characters (no terminator)
+ * @param uppercase Non-zero for uppercase digits
+ */
+static inline void base16_encode_uuid(const uint8_t input[16], char output[36], const int uppercase) {
+    base16_encode_fixed(input, 4, output, uppercase);
+    output[8] = '-';
+    base16_encode_fixed(input + 4, 2, output + 9, uppercase);
+    output[13] = '-';
+    base16_encode_fixed(input + 6, 2, output + 14, uppercase);
+    output[18] = '-';
+    base16_encode_fixed(input + 8, 2, output + 19, uppercase);
+    output[23] = '-';
+    base16_encode_fixed(input + 10, 6, output + 24, uppercase);
+}
+
+/**
+ * @brief Encode 16 bytes (e.g. an MD5 digest or raw UUID) as 32 hex characters
+ */
+static inline void base16_encode_16(const uint8_t input[16], char output[32], const int uppercase) {
+    base16_encode_fixed(input, 16, output, uppercase);
+}
+
+/**
+ * @brief Encode 20 bytes (e.g. a SHA-1 digest) as 40 hex characters
+ */
+static inline void base16_encode_20(const uint8_t input[20], char output[40], const int uppercase) {
+    base16_encode_fixed(input, 20, output, uppercase);
+}
+
+/**
+ * @brief Encode 32 bytes (e.g. a SHA-256 digest) as 64 hex characters
+ */
+static inline void base16_encode_32(const uint8_t input[32], char output[64], const int uppercase) {
+    base16_encode_fixed(input, 32, output, uppercase);
+}
+
+/**
+ * @brief Encode 64 bytes (e.g. a SHA-512 digest) as 128 hex characters
+ */
+static inline void base16_encode_64(const uint8_t input[64], char output[128], const int uppercase) {
+    base16_encode_fixed(input, 64, output, uppercase);
+}
+
 #endif //BASE16_H
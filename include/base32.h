@@ -25,7 +25,11 @@
 #ifndef BASE32_H
 #define BASE32_H
 
+#include <stddef.h>
 #include <stdint.h>
+#include <sys/uio.h>
+
+#include "bek.h"
 
 /**
  * @brief Error codes for base32 operations
@@ -37,7 +41,8 @@ typedef enum {
  BASE32_ERROR_BUFFER_TOO_SMALL, // Output buffer is too small
  BASE32_ERROR_NULL_POINTER, // NULL pointer provided
  BASE32_ERROR_PADDING, // Invalid padding
- BASE32_ERROR_MEMORY // Memory allocation failure
+ BASE32_ERROR_MEMORY, // Memory allocation failure
+ BASE32_ERROR_CALLBACK // Output callback aborted
 } base32_error_t;
 
 /**
@@ -48,10 +53,27 @@ typedef struct {
  int use_hex; // Use hex-based alphabet
  int line_length; // Length of lines (0 for no line breaks)
  char line_ending[3]; // Line ending sequence (e.g., "\r\n")
+ int omit_terminator; // Exact-size output without a trailing '\0'
+ const bek_allocator_t *allocator; // Allocator of the context (NULL for the library allocator)
+ bek_store_mode_t stores; // Output stores of one-shot encodes (BEK_STORE_AUTO by default)
 } base32_config_t;
 
+/**
+ * @brief Number of bytes the slop variants may read past the end of the input
+ *        and write past the end of the output
+ *
+ * Callers of base32_encode_slop() and base32_decode_slop() must guarantee that
+ * this many bytes are addressable after both buffers. The contents of the
+ * output slop region are unspecified after the call.
+ */
+#define BASE32_SLOP_BYTES 32
+
 /**
  * @brief Base32 context structure
+ *
+ * Holds only configuration and lookup tables and is never modified after
+ * base32_init(), so one context may be shared by any number of threads.
+ * Per-stream state lives in a separate bek_stream_t.
  */
 typedef struct base32_ctx_t base32_ctx_t;
 
@@ -67,6 +89,10 @@ base32_error_t base32_init(base32_ctx_t **ctx, const base32_config_t *config);
 /**
  * @brief Calculate required buffer size for encoding
  *
+ * The size includes one byte for the '\0' terminator unless the context was
+ * configured with omit_terminator, in which case it is the exact number of
+ * characters the encoder writes.
+ *
  * @param input_length Length of input data
  * @param ctx Base32 context
  * @param output_size Pointer to store required output size
@@ -124,6 +150,311 @@ base32_error_t base32_decode(const base32_ctx_t *ctx,
                              size_t output_size,
                              size_t *output_length);
 
+/**
+ * @brief Encode binary data to base32 string using the padded-buffer contract
+ *
+ * Behaves like base32_encode() but runs the word-at-a-time kernel through the
+ * tail. Both buffers must be followed by BASE32_SLOP_BYTES addressable bytes.
+ * Configurations with line_length > 0 take the regular path.
+ *
+ * @param ctx Base32 context
+ * @param input Input binary data (readable for input_length + BASE32_SLOP_BYTES)
+ * @param input_length Length of input data
+ * @param output Output buffer (writable for output_size + BASE32_SLOP_BYTES)
+ * @param output_size Size of output buffer, excluding the slop region
+ * @param output_length Pointer to store actual output length
+ * @return base32_error_t Error code
+ */
+base32_error_t base32_encode_slop(const base32_ctx_t *ctx,
+                                  const uint8_t *input,
+                                  size_t input_length,
+                                  char *output,
+                                  size_t output_size,
+                                  size_t *output_length);
+
+/**
+ * @brief Decode base32 string to binary data using the padded-buffer contract
+ *
+ * Input must be compact: any character outside the alphabet, other than
+ * trailing padding, is rejected with BASE32_ERROR_INVALID_INPUT. Both buffers
+ * must be followed by BASE32_SLOP_BYTES addressable bytes.
+ *
+ * @param ctx Base32 context
+ * @param input Input base32 string (readable for input_length + BASE32_SLOP_BYTES)
+ * @param input_length Length of input string
+ * @param output Output buffer (writable for output_size + BASE32_SLOP_BYTES)
+ * @param output_size Size of output buffer, excluding the slop region
+ * @param output_length Pointer to store actual output length
+ * @return base32_error_t Error code
+ */
+base32_error_t base32_decode_slop(const base32_ctx_t *ctx,
+                                  const char *input,
+                                  size_t input_length,
+                                  uint8_t *output,
+                                  size_t output_size,
+                                  size_t *output_length);
+
+/**
+ * @brief Decode canonical base32 only (RFC 4648 section 3.5)
+ *
+ * Any character outside the alphabet, whitespace included, is rejected with
+ * BASE32_ERROR_INVALID_INPUT. BASE32_ERROR_PADDING is returned when the final
+ * quantum leaves non-zero bits unused, or when the trailing '=' run is not
+ * exactly the one the encoder would write: the complement to a multiple of
+ * eight with use_padding, nothing without it. A final quantum of 1, 3 or 6
+ * characters is BASE32_ERROR_INVALID_LENGTH. The output must hold the exact
+ * decoded length.
+ *
+ * @param ctx Base32 context
+ * @param input Input base32 string
+ * @param input_length Length of input string
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base32_error_t Error code
+ */
+base32_error_t base32_decode_strict(const base32_ctx_t *ctx,
+                                    const char *input,
+                                    size_t input_length,
+                                    uint8_t *output,
+                                    size_t output_size,
+                                    size_t *output_length);
+
+/**
+ * @brief Encode the next chunk of a stream to base32 string
+ *
+ * Consumes input and produces output until either runs out. A partial quantum
+ * and any output that did not fit are kept in the stream state, so chunks may
+ * be split anywhere. No '\0' terminator is written.
+ *
+ * @param ctx Base32 context
+ * @param stream Stream state initialized with bek_stream_init()
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param input_consumed Pointer to store number of input bytes consumed
+ * @param output Output buffer for base32 string
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base32_error_t Error code
+ */
+base32_error_t base32_encode_update(const base32_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const uint8_t *input,
+                                    size_t input_length,
+                                    size_t *input_consumed,
+                                    char *output,
+                                    size_t output_size,
+                                    size_t *output_length);
+
+/**
+ * @brief Finish a base32 encode stream, writing the last quantum and padding
+ *
+ * Returns BASE32_ERROR_BUFFER_TOO_SMALL if output remains; call again with
+ * more space to receive the rest.
+ *
+ * @param ctx Base32 context
+ * @param stream Stream state
+ * @param output Output buffer for base32 string
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base32_error_t Error code
+ */
+base32_error_t base32_encode_final(const base32_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   char *output,
+                                   size_t output_size,
+                                   size_t *output_length);
+
+/**
+ * @brief Decode the next chunk of a base32 stream to binary data
+ *
+ * Whitespace is skipped. Stops early on invalid input, in which case
+ * input_consumed points at the offending character.
+ *
+ * @param ctx Base32 context
+ * @param stream Stream state initialized with bek_stream_init()
+ * @param input Input base32 string
+ * @param input_length Length of input string
+ * @param input_consumed Pointer to store number of input characters consumed
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base32_error_t Error code
+ */
+base32_error_t base32_decode_update(const base32_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const char *input,
+                                    size_t input_length,
+                                    size_t *input_consumed,
+                                    uint8_t *output,
+                                    size_t output_size,
+                                    size_t *output_length);
+
+/**
+ * @brief Finish a base32 decode stream, writing the bytes of the last quantum
+ *
+ * Returns BASE32_ERROR_INVALID_LENGTH if the stream ended mid-quantum and
+ * BASE32_ERROR_BUFFER_TOO_SMALL if output remains.
+ *
+ * @param ctx Base32 context
+ * @param stream Stream state
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base32_error_t Error code
+ */
+base32_error_t base32_decode_final(const base32_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   uint8_t *output,
+                                   size_t output_size,
+                                   size_t *output_length);
+
+/**
+ * @brief Encode scattered binary data to base32, gathering into an iovec list
+ *
+ * Partial quanta are carried across input segment boundaries and output
+ * spills over into the next segment, so the result can go straight to
+ * writev(). No '\0' terminator is written.
+ *
+ * @param ctx Base32 context
+ * @param input Input segments
+ * @param input_count Number of input segments
+ * @param output Output segments, filled in order
+ * @param output_count Number of output segments
+ * @param output_length Pointer to store total output length
+ * @return base32_error_t Error code
+ */
+base32_error_t base32_encode_iov(const base32_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 int input_count,
+                                 const struct iovec *output,
+                                 int output_count,
+                                 size_t *output_length);
+
+/**
+ * @brief Decode scattered base32 text to binary data in an iovec list
+ *
+ * @param ctx Base32 context
+ * @param input Input segments
+ * @param input_count Number of input segments
+ * @param output Output segments, filled in order
+ * @param output_count Number of output segments
+ * @param output_length Pointer to store total output length
+ * @return base32_error_t Error code
+ */
+base32_error_t base32_decode_iov(const base32_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 int input_count,
+                                 const struct iovec *output,
+                                 int output_count,
+                                 size_t *output_length);
+
+/**
+ * @brief Encode binary data to base32, handing output to a callback in blocks
+ *
+ * Output is produced into an internal block of BEK_SINK_BLOCK_SIZE bytes and
+ * passed to the sink each time it fills, so memory use does not depend on
+ * the input size. No '\0' terminator is written.
+ *
+ * @param ctx Base32 context
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param sink Output callback
+ * @param user_data Pointer passed to the callback
+ * @return base32_error_t Error code, BASE32_ERROR_CALLBACK if the sink aborted
+ */
+base32_error_t base32_encode_to_sink(const base32_ctx_t *ctx,
+                                     const uint8_t *input,
+                                     size_t input_length,
+                                     bek_sink_fn sink,
+                                     void *user_data);
+
+/**
+ * @brief Decode base32 string to binary data, handing output to a callback in blocks
+ *
+ * @param ctx Base32 context
+ * @param input Input base32 string
+ * @param input_length Length of input string
+ * @param sink Output callback
+ * @param user_data Pointer passed to the callback
+ * @return base32_error_t Error code, BASE32_ERROR_CALLBACK if the sink aborted
+ */
+base32_error_t base32_decode_to_sink(const base32_ctx_t *ctx,
+                                     const char *input,
+                                     size_t input_length,
+                                     bek_sink_fn sink,
+                                     void *user_data);
+
+/**
+ * @brief Encode the used region of a ring buffer into the free region of another
+ *
+ * Both rings may wrap; the wrap points are handled internally without
+ * linearising either side. The input ring is left unchanged, the output
+ * ring's length grows by the number of characters written. No '\0'
+ * terminator is written.
+ *
+ * @param ctx Base32 context
+ * @param input Ring holding the binary data to encode
+ * @param output Ring receiving the base32 string
+ * @param output_length Pointer to store number of characters appended
+ * @return base32_error_t Error code; the output ring is only updated on success
+ */
+base32_error_t base32_encode_ring(const base32_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length);
+
+/**
+ * @brief Decode the used region of a ring buffer into the free region of another
+ *
+ * @param ctx Base32 context
+ * @param input Ring holding the base32 string
+ * @param output Ring receiving the binary data
+ * @param output_length Pointer to store number of bytes appended
+ * @return base32_error_t Error code; the output ring is only updated on success
+ */
+base32_error_t base32_decode_ring(const base32_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length);
+
+/**
+ * @brief Encode binary data to base32, appending to a growable buffer
+ *
+ * Reserves the base32_get_encode_size() length once and encodes straight into
+ * the buffer, so a buffer cleared with bek_buf_clear() and reused across calls
+ * stops allocating once it is large enough. The text is always followed by a
+ * '\0', which is not counted in buf->length. On error buf->length is
+ * unchanged.
+ *
+ * @param ctx Base32 context
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param buf Buffer to append to
+ * @return base32_error_t Error code, BASE32_ERROR_MEMORY if the buffer could not grow
+ */
+base32_error_t base32_encode_to_buf(const base32_ctx_t *ctx,
+                                    const uint8_t *input,
+                                    size_t input_length,
+                                    bek_buf_t *buf);
+
+/**
+ * @brief Decode base32 string to binary data, appending to a growable buffer
+ *
+ * Reserves the base32_get_decode_size() bound once and decodes straight into
+ * the buffer. On error buf->length is unchanged.
+ *
+ * @param ctx Base32 context
+ * @param input Input base32 string
+ * @param input_length Length of input string
+ * @param buf Buffer to append to
+ * @return base32_error_t Error code, BASE32_ERROR_MEMORY if the buffer could not grow
+ */
+base32_error_t base32_decode_to_buf(const base32_ctx_t *ctx,
+                                    const char *input,
+                                    size_t input_length,
+                                    bek_buf_t *buf);
+
 /**
  * @brief Get string description of error code
  *
@@ -138,4 +469,48 @@ const char *base32_error_string(base32_error_t error);
  * @param ctx Base32 context to free
  */
 void base32_free(base32_ctx_t *ctx);
+
+/*
+ * Fixed-length encoders
+ *
+ * Specialised for common key sizes: no context, no size query, no line
+ * wrapping, no padding and no terminator. All loops have constant trip counts
+ * and unroll fully, leaving no data-dependent branches.
+ */
+
+/**
+ * @brief Map a 5-bit value to its base32 character
+ *
+ * @param value Value 0-31
+ * @return char Character from A-Z or 2-7
+ */
+static inline char base32_value_char(const unsigned value) {
+    static const char alphabet[32] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+    return alphabet[value];
+}
+
+/**
+ * @brief Encode 32 bytes (e.g. a key) as 52 unpadded base32 characters
+ *
+ * Append "====" for the padded RFC 4648 form.
+ *
+ * @param input 32 input bytes
+ * @param output Output buffer of 52 characters
+ */
+static inline void base32_encode_32(const uint8_t input[32], char output[52]) {
+    // Six full 5-byte groups, then 2 bytes into 4 characters
+    for (int g = 0; g < 6; g++, input += 5, output += 8) {
+        const uint64_t n = (uint64_t) input[0] << 32 | (uint64_t) input[1] << 24 | (uint64_t) input[2] << 16 |
+                           (uint64_t) input[3] << 8 | input[4];
+        for (int k = 0; k < 8; k++) {
+            output[k] = base32_value_char((unsigned) (n >> (35 - 5 * k)) & 0x1F);
+        }
+    }
+    const unsigned n = (unsigned) input[0] << 8 | input[1];
+    output[0] = base32_value_char(n >> 11);
+    output[1] = base32_value_char((n >> 6) & 0x1F);
+    output[2] = base32_value_char((n >> 1) & 0x1F);
+    output[3] = base32_value_char((n << 4) & 0x1F);
+}
+
 #endif //BASE32_H
@@ -26,6 +26,9 @@
 #define BASE64_H
 #include <stddef.h>
 #include <stdint.h>
+#include <sys/uio.h>
+
+#include "bek.h"
 
 /**
  * @brief Error codes for base64 operations
@@ -37,7 +40,8 @@ typedef enum {
  BASE64_ERROR_BUFFER_TOO_SMALL, // Output buffer is too small
  BASE64_ERROR_NULL_POINTER, // NULL pointer provided
  BASE64_ERROR_PADDING, // Invalid padding
- BASE64_ERROR_MEMORY // Memory allocation failure
+ BASE64_ERROR_MEMORY, // Memory allocation failure
+ BASE64_ERROR_CALLBACK // Output callback aborted
 } base64_error_t;
 
 /**
@@ -48,16 +52,37 @@ typedef struct {
  int url_safe; // Use URL-safe alphabet (-_ instead of +/)
  int line_length; // Length of lines (0 for no line breaks)
  char line_ending[3]; // Line ending sequence (e.g., "\r\n")
+ int omit_terminator; // Exact-size output without a trailing '\0'
+ const char *ignore; // Characters decoding skips, one-shot and streaming alike (NULL for " \r\n")
+ const bek_allocator_t *allocator; // Allocator of the context (NULL for the library allocator)
+ bek_store_mode_t stores; // Output stores of one-shot encodes (BEK_STORE_AUTO by default)
 } base64_config_t;
 
+/**
+ * @brief Number of bytes the slop variants may read past the end of the input
+ *        and write past the end of the output
+ *
+ * Callers of base64_encode_slop() and base64_decode_slop() must guarantee that
+ * this many bytes are addressable after both buffers. The contents of the
+ * output slop region are unspecified after the call.
+ */
+#define BASE64_SLOP_BYTES 32
+
 /**
  * @brief Base64 context structure
+ *
+ * Holds only configuration and lookup tables and is never modified after
+ * base64_init(), so one context may be shared by any number of threads.
+ * Per-stream state lives in a separate bek_stream_t.
  */
 typedef struct base64_ctx_t base64_ctx_t;
 
 /**
  * @brief Initialize a base64 context with the given configuration
  *
+ * Returns BASE64_ERROR_INVALID_INPUT if the ignore set contains '=' or a
+ * character of the selected alphabet.
+ *
  * @param ctx Pointer to context pointer to be initialized
  * @param config Configuration options (NULL for defaults)
  * @return base64_error_t Error code
@@ -67,6 +92,10 @@ base64_error_t base64_init(base64_ctx_t **ctx, const base64_config_t *config);
 /**
  * @brief Calculate required buffer size for encoding
  *
+ * The size includes one byte for the '\0' terminator unless the context was
+ * configured with omit_terminator, in which case it is the exact number of
+ * characters the encoder writes.
+ *
  * @param input_length Length of input data
  * @param ctx Base64 context
  * @param output_size Pointer to store required output size
@@ -109,6 +138,12 @@ base64_error_t base64_encode(const base64_ctx_t *ctx,
 /**
  * @brief Decode base64 string to binary data
  *
+ * Characters of the configured ignore set (by default space, CR and LF) are
+ * skipped anywhere. When the first line is a whole number of quanta ended by
+ * LF or CRLF, as in MIME and PEM bodies, following lines of the same layout
+ * are decoded without a per-character test. Elsewhere the input is compacted
+ * a few KiB at a time into a stack buffer and decoded a block at a time.
+ *
  * @param ctx Base64 context
  * @param input Input base64 string
  * @param input_length Length of input string
@@ -117,13 +152,366 @@ base64_error_t base64_encode(const base64_ctx_t *ctx,
  * @param output_length Pointer to store actual output length
  * @return base64_error_t Error code
  */
-base64_error_t base64_decode(base64_ctx_t *ctx,
+base64_error_t base64_decode(const base64_ctx_t *ctx,
                              const char *input,
                              size_t input_length,
                              uint8_t *output,
                              size_t output_size,
                              size_t *output_length);
 
+/**
+ * @brief Encode binary data to base64 string using the padded-buffer contract
+ *
+ * Behaves like base64_encode() but runs the word-at-a-time kernel through the
+ * tail instead of finishing it byte by byte. Both buffers must be followed by
+ * BASE64_SLOP_BYTES addressable bytes. Configurations with line_length > 0
+ * take the regular path.
+ *
+ * @param ctx Base64 context
+ * @param input Input binary data (readable for input_length + BASE64_SLOP_BYTES)
+ * @param input_length Length of input data
+ * @param output Output buffer (writable for output_size + BASE64_SLOP_BYTES)
+ * @param output_size Size of output buffer, excluding the slop region
+ * @param output_length Pointer to store actual output length
+ * @return base64_error_t Error code
+ */
+base64_error_t base64_encode_slop(const base64_ctx_t *ctx,
+                                  const uint8_t *input,
+                                  size_t input_length,
+                                  char *output,
+                                  size_t output_size,
+                                  size_t *output_length);
+
+/**
+ * @brief Decode base64 string to binary data using the padded-buffer contract
+ *
+ * Input must be compact: whitespace and line breaks are rejected with
+ * BASE64_ERROR_INVALID_INPUT. Trailing padding is optional. Both buffers must
+ * be followed by BASE64_SLOP_BYTES addressable bytes.
+ *
+ * @param ctx Base64 context
+ * @param input Input base64 string (readable for input_length + BASE64_SLOP_BYTES)
+ * @param input_length Length of input string
+ * @param output Output buffer (writable for output_size + BASE64_SLOP_BYTES)
+ * @param output_size Size of output buffer, excluding the slop region
+ * @param output_length Pointer to store actual output length
+ * @return base64_error_t Error code
+ */
+base64_error_t base64_decode_slop(const base64_ctx_t *ctx,
+                                  const char *input,
+                                  size_t input_length,
+                                  uint8_t *output,
+                                  size_t output_size,
+                                  size_t *output_length);
+
+/**
+ * @brief Decode canonical base64 only (RFC 4648 section 3.5)
+ *
+ * For tokens and signatures, where a second spelling of the same bytes must
+ * not verify. Any character outside the alphabet, whitespace included, is
+ * rejected with BASE64_ERROR_INVALID_INPUT. BASE64_ERROR_PADDING is returned
+ * when the final quantum leaves non-zero bits unused, or when the trailing
+ * '=' run is not exactly the one the encoder would write: the complement to
+ * a multiple of four with use_padding, nothing without it. A final quantum of
+ * a single character is BASE64_ERROR_INVALID_LENGTH. The output must hold the
+ * exact decoded length.
+ *
+ * @param ctx Base64 context
+ * @param input Input base64 string
+ * @param input_length Length of input string
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base64_error_t Error code
+ */
+base64_error_t base64_decode_strict(const base64_ctx_t *ctx,
+                                    const char *input,
+                                    size_t input_length,
+                                    uint8_t *output,
+                                    size_t output_size,
+                                    size_t *output_length);
+
+/**
+ * @brief Encode binary data to base64 text in UTF-16
+ *
+ * Writes the same text as base64_encode(), line breaks and terminator included,
+ * as UTF-16 code units (native byte order, as in a JavaScript or Java string
+ * buffer). Each character is widened as the kernel stores it, so no char
+ * buffer or second pass is needed. Sizes count code units; the required size
+ * is the one base64_get_encode_size() reports.
+ *
+ * @param ctx Base64 context
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param output Output buffer for UTF-16 code units
+ * @param output_size Size of output buffer in code units
+ * @param output_length Pointer to store actual output length in code units
+ * @return base64_error_t Error code
+ */
+base64_error_t base64_encode_utf16(const base64_ctx_t *ctx,
+                                   const uint8_t *input,
+                                   size_t input_length,
+                                   uint16_t *output,
+                                   size_t output_size,
+                                   size_t *output_length);
+
+/**
+ * @brief Decode base64 text in UTF-16 to binary data
+ *
+ * Accepts what base64_decode() accepts, reading UTF-16 code units (native byte
+ * order). The units are narrowed as the kernels load them; any unit above
+ * 0xFF is BASE64_ERROR_INVALID_INPUT. input_length counts code units.
+ *
+ * @param ctx Base64 context
+ * @param input Input UTF-16 code units
+ * @param input_length Length of input in code units
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base64_error_t Error code
+ */
+base64_error_t base64_decode_utf16(const base64_ctx_t *ctx,
+                                   const uint16_t *input,
+                                   size_t input_length,
+                                   uint8_t *output,
+                                   size_t output_size,
+                                   size_t *output_length);
+
+/**
+ * @brief Encode the next chunk of a stream to base64 string
+ *
+ * Consumes input and produces output until either runs out. A partial quantum
+ * and any output that did not fit are kept in the stream state, so chunks may
+ * be split anywhere. No '\0' terminator is written.
+ *
+ * @param ctx Base64 context
+ * @param stream Stream state initialized with bek_stream_init()
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param input_consumed Pointer to store number of input bytes consumed
+ * @param output Output buffer for base64 string
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base64_error_t Error code
+ */
+base64_error_t base64_encode_update(const base64_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const uint8_t *input,
+                                    size_t input_length,
+                                    size_t *input_consumed,
+                                    char *output,
+                                    size_t output_size,
+                                    size_t *output_length);
+
+/**
+ * @brief Finish a base64 encode stream, writing the last quantum and padding
+ *
+ * Returns BASE64_ERROR_BUFFER_TOO_SMALL if output remains; call again with
+ * more space to receive the rest.
+ *
+ * @param ctx Base64 context
+ * @param stream Stream state
+ * @param output Output buffer for base64 string
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base64_error_t Error code
+ */
+base64_error_t base64_encode_final(const base64_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   char *output,
+                                   size_t output_size,
+                                   size_t *output_length);
+
+/**
+ * @brief Decode the next chunk of a base64 stream to binary data
+ *
+ * Whitespace is skipped. Stops early on invalid input, in which case
+ * input_consumed points at the offending character.
+ *
+ * @param ctx Base64 context
+ * @param stream Stream state initialized with bek_stream_init()
+ * @param input Input base64 string
+ * @param input_length Length of input string
+ * @param input_consumed Pointer to store number of input characters consumed
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base64_error_t Error code
+ */
+base64_error_t base64_decode_update(const base64_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const char *input,
+                                    size_t input_length,
+                                    size_t *input_consumed,
+                                    uint8_t *output,
+                                    size_t output_size,
+                                    size_t *output_length);
+
+/**
+ * @brief Finish a base64 decode stream, writing the bytes of the last quantum
+ *
+ * Returns BASE64_ERROR_INVALID_LENGTH if the stream ended mid-quantum and
+ * BASE64_ERROR_BUFFER_TOO_SMALL if output remains.
+ *
+ * @param ctx Base64 context
+ * @param stream Stream state
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base64_error_t Error code
+ */
+base64_error_t base64_decode_final(const base64_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   uint8_t *output,
+                                   size_t output_size,
+                                   size_t *output_length);
+
+/**
+ * @brief Encode scattered binary data to base64, gathering into an iovec list
+ *
+ * Partial quanta are carried across input segment boundaries and output
+ * spills over into the next segment, so the result can go straight to
+ * writev(). No '\0' terminator is written.
+ *
+ * @param ctx Base64 context
+ * @param input Input segments
+ * @param input_count Number of input segments
+ * @param output Output segments, filled in order
+ * @param output_count Number of output segments
+ * @param output_length Pointer to store total output length
+ * @return base64_error_t Error code
+ */
+base64_error_t base64_encode_iov(const base64_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 int input_count,
+                                 const struct iovec *output,
+                                 int output_count,
+                                 size_t *output_length);
+
+/**
+ * @brief Decode scattered base64 text to binary data in an iovec list
+ *
+ * @param ctx Base64 context
+ * @param input Input segments
+ * @param input_count Number of input segments
+ * @param output Output segments, filled in order
+ * @param output_count Number of output segments
+ * @param output_length Pointer to store total output length
+ * @return base64_error_t Error code
+ */
+base64_error_t base64_decode_iov(const base64_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 int input_count,
+                                 const struct iovec *output,
+                                 int output_count,
+                                 size_t *output_length);
+
+/**
+ * @brief Encode binary data to base64, handing output to a callback in blocks
+ *
+ * Output is produced into an internal block of BEK_SINK_BLOCK_SIZE bytes and
+ * passed to the sink each time it fills, so memory use does not depend on
+ * the input size. No '\0' terminator is written.
+ *
+ * @param ctx Base64 context
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param sink Output callback
+ * @param user_data Pointer passed to the callback
+ * @return base64_error_t Error code, BASE64_ERROR_CALLBACK if the sink aborted
+ */
+base64_error_t base64_encode_to_sink(const base64_ctx_t *ctx,
+                                     const uint8_t *input,
+                                     size_t input_length,
+                                     bek_sink_fn sink,
+                                     void *user_data);
+
+/**
+ * @brief Decode base64 string to binary data, handing output to a callback in blocks
+ *
+ * @param ctx Base64 context
+ * @param input Input base64 string
+ * @param input_length Length of input string
+ * @param sink Output callback
+ * @param user_data Pointer passed to the callback
+ * @return base64_error_t Error code, BASE64_ERROR_CALLBACK if the sink aborted
+ */
+base64_error_t base64_decode_to_sink(const base64_ctx_t *ctx,
+                                     const char *input,
+                                     size_t input_length,
+                                     bek_sink_fn sink,
+                                     void *user_data);
+
+/**
+ * @brief Encode the used region of a ring buffer into the free region of another
+ *
+ * Both rings may wrap; the wrap points are handled internally without
+ * linearising either side. The input ring is left unchanged, the output
+ * ring's length grows by the number of characters written. No '\0'
+ * terminator is written.
+ *
+ * @param ctx Base64 context
+ * @param input Ring holding the binary data to encode
+ * @param output Ring receiving the base64 string
+ * @param output_length Pointer to store number of characters appended
+ * @return base64_error_t Error code; the output ring is only updated on success
+ */
+base64_error_t base64_encode_ring(const base64_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length);
+
+/**
+ * @brief Decode the used region of a ring buffer into the free region of another
+ *
+ * @param ctx Base64 context
+ * @param input Ring holding the base64 string
+ * @param output Ring receiving the binary data
+ * @param output_length Pointer to store number of bytes appended
+ * @return base64_error_t Error code; the output ring is only updated on success
+ */
+base64_error_t base64_decode_ring(const base64_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length);
+
+/**
+ * @brief Encode binary data to base64, appending to a growable buffer
+ *
+ * Reserves the base64_get_encode_size() length once and encodes straight into
+ * the buffer, so a buffer cleared with bek_buf_clear() and reused across calls
+ * stops allocating once it is large enough. The text is always followed by a
+ * '\0', which is not counted in buf->length. On error buf->length is
+ * unchanged.
+ *
+ * @param ctx Base64 context
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param buf Buffer to append to
+ * @return base64_error_t Error code, BASE64_ERROR_MEMORY if the buffer could not grow
+ */
+base64_error_t base64_encode_to_buf(const base64_ctx_t *ctx,
+                                    const uint8_t *input,
+                                    size_t input_length,
+                                    bek_buf_t *buf);
+
+/**
+ * @brief Decode base64 string to binary data, appending to a growable buffer
+ *
+ * Reserves the base64_get_decode_size() bound once and decodes straight into
+ * the buffer. On error buf->length is unchanged.
+ *
+ * @param ctx Base64 context
+ * @param input Input base64 string
+ * @param input_length Length of input string
+ * @param buf Buffer to append to
+ * @return base64_error_t Error code, BASE64_ERROR_MEMORY if the buffer could not grow
+ */
+base64_error_t base64_decode_to_buf(const base64_ctx_t *ctx,
+                                    const char *input,
+                                    size_t input_length,
+                                    bek_buf_t *buf);
+
 /**
  * @brief Get string description of error code
  *
@@ -139,4 +527,72 @@ const char *base64_error_string(base64_error_t error);
  */
 void base64_free(base64_ctx_t *ctx);
 
+/*
+ * Fixed-length encoders
+ *
+ * Specialised for common digest and key sizes: no context, no size query, no
+ * line wrapping, no padding and no terminator. All loops have constant trip
+ * counts and unroll fully, leaving no data-dependent branches.
+ */
+
+/**
+ * @brief Map a 6-bit value to its URL-safe base64 character
+ *
+ * @param value Value 0-63
+ * @return char Character from A-Z, a-z, 0-9, '-' or '_'
+ */
+static inline char base64url_value_char(const unsigned value) {
+    static const char alphabet[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    return alphabet[value];
+}
+
+/**
+ * @brief Encode a fixed number of bytes as unpadded base64url
+ *
+ * @param input Input bytes
+ * @param length Number of input bytes (a compile-time constant in callers)
+ * @param output Output buffer of (4 * length + 2) / 3 characters
+ */
+static inline void base64url_encode_fixed(const uint8_t *input, const size_t length, char *output) {
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3, output += 4) {
+        const uint32_t n = (uint32_t) input[i] << 16 | (uint32_t) input[i + 1] << 8 | input[i + 2];
+        output[0] = base64url_value_char(n >> 18);
+        output[1] = base64url_value_char((n >> 12) & 0x3F);
+        output[2] = base64url_value_char((n >> 6) & 0x3F);
+        output[3] = base64url_value_char(n & 0x3F);
+    }
+    if (length - i == 2) {
+        const uint32_t n = (uint32_t) input[i] << 16 | (uint32_t) input[i + 1] << 8;
+        output[0] = base64url_value_char(n >> 18);
+        output[1] = base64url_value_char((n >> 12) & 0x3F);
+        output[2] = base64url_value_char((n >> 6) & 0x3F);
+    } else if (length - i == 1) {
+        const uint32_t n = (uint32_t) input[i] << 16;
+        output[0] = base64url_value_char(n >> 18);
+        output[1] = base64url_value_char((n >> 12) & 0x3F);
+    }
+}
+
+/**
+ * @brief Encode 20 bytes (e.g. a SHA-1 digest) as 27 unpadded base64url characters
+ */
+static inline void base64url_encode_20(const uint8_t input[20], char output[27]) {
+    base64url_encode_fixed(input, 20, output);
+}
+
+/**
+ * @brief Encode 32 bytes (e.g. a SHA-256 digest or key) as 43 unpadded base64url characters
+ */
+static inline void base64url_encode_32(const uint8_t input[32], char output[43]) {
+    base64url_encode_fixed(input, 32, output);
+}
+
+/**
+ * @brief Encode 64 bytes (e.g. a SHA-512 digest) as 86 unpadded base64url characters
+ */
+static inline void base64url_encode_64(const uint8_t input[64], char output[86]) {
+    base64url_encode_fixed(input, 64, output);
+}
+
 #endif //BASE64_H
@@ -0,0 +1,410 @@
+// MIT License
+//
+// Copyright (c) 2024 MKKHLIF
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// File: base85.h
+
+#ifndef BASE85_H
+#define BASE85_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include "bek.h"
+
+/*
+ * Base85 encodes every 4 bytes as 5 characters (25% overhead against 33% for
+ * base64). Two alphabets are supported:
+ *
+ * - Ascii85 (btoa, PostScript, PDF): characters '!'..'u'. The decoder also
+ *   accepts 'z' for four zero bytes; the encoder never emits it, so encoded
+ *   sizes stay exact. The "<~" "~>" delimiters are not handled.
+ * - Z85 (ZeroMQ RFC 32): an 85-character set that is safe in source code and
+ *   XML attributes, with no abbreviations.
+ *
+ * Both encode a trailing partial quantum of n bytes as n + 1 characters, the
+ * Ascii85 convention; Z85 proper only defines multiples of four bytes.
+ * Whitespace is skipped when decoding.
+ */
+
+/**
+ * @brief Error codes for base85 operations
+ */
+typedef enum {
+    BASE85_SUCCESS = 0,
+    BASE85_ERROR_INVALID_INPUT,    // Invalid character or quantum above 2^32 - 1
+    BASE85_ERROR_INVALID_LENGTH,   // Input length is invalid
+    BASE85_ERROR_BUFFER_TOO_SMALL, // Output buffer is too small
+    BASE85_ERROR_NULL_POINTER,     // NULL pointer provided
+    BASE85_ERROR_MEMORY,           // Memory allocation failure
+    BASE85_ERROR_CALLBACK          // Output callback aborted
+} base85_error_t;
+
+/**
+ * @brief Configuration options for base85 operations
+ */
+typedef struct {
+    int use_z85;               // Z85 alphabet instead of Ascii85
+    int line_length;           // Length of lines (0 for no line breaks)
+    char line_ending[3];       // Line ending sequence (e.g., "\r\n")
+    int omit_terminator;       // Exact-size output without a trailing '\0'
+    const bek_allocator_t *allocator; // Allocator of the context (NULL for the library allocator)
+    bek_store_mode_t stores;   // Output stores of one-shot encodes (BEK_STORE_AUTO by default)
+} base85_config_t;
+
+/**
+ * @brief Base85 context structure
+ *
+ * Holds only configuration and lookup tables and is never modified after
+ * base85_init(), so one context may be shared by any number of threads.
+ * Per-stream state lives in a separate bek_stream_t.
+ */
+typedef struct base85_ctx_t base85_ctx_t;
+
+/**
+ * @brief Initialize a base85 context with the given configuration
+ *
+ * @param ctx Pointer to context pointer to be initialized
+ * @param config Configuration options (NULL for defaults)
+ * @return base85_error_t Error code
+ */
+base85_error_t base85_init(base85_ctx_t **ctx, const base85_config_t *config);
+
+/**
+ * @brief Calculate required buffer size for encoding
+ *
+ * The size includes one byte for the '\0' terminator unless the context was
+ * configured with omit_terminator, in which case it is the exact number of
+ * characters the encoder writes.
+ *
+ * @param input_length Length of input data
+ * @param ctx Base85 context
+ * @param output_size Pointer to store required output size
+ * @return base85_error_t Error code
+ */
+base85_error_t base85_get_encode_size(size_t input_length,
+                                      const base85_ctx_t *ctx,
+                                      size_t *output_size);
+
+/**
+ * @brief Calculate required buffer size for decoding
+ *
+ * For Ascii85 the bound allows every character to be a 'z', i.e. four bytes
+ * per input character.
+ *
+ * @param input_length Length of base85 input string
+ * @param ctx Base85 context
+ * @param output_size Pointer to store required output size
+ * @return base85_error_t Error code
+ */
+base85_error_t base85_get_decode_size(size_t input_length,
+                                      const base85_ctx_t *ctx,
+                                      size_t *output_size);
+
+/**
+ * @brief Encode binary data to base85 string
+ *
+ * @param ctx Base85 context
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param output Output buffer for base85 string
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base85_error_t Error code
+ */
+base85_error_t base85_encode(const base85_ctx_t *ctx,
+                             const uint8_t *input,
+                             const size_t input_length,
+                             char *output,
+                             const size_t output_size,
+                             size_t *output_length);
+
+/**
+ * @brief Decode base85 string to binary data
+ *
+ * @param ctx Base85 context
+ * @param input Input base85 string
+ * @param input_length Length of input string
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base85_error_t Error code
+ */
+base85_error_t base85_decode(const base85_ctx_t *ctx,
+                             const char *input,
+                             size_t input_length,
+                             uint8_t *output,
+                             size_t output_size,
+                             size_t *output_length);
+
+/**
+ * @brief Encode the next chunk of a stream to base85 string
+ *
+ * Consumes input and produces output until either runs out. A partial quantum
+ * and any output that did not fit are kept in the stream state, so chunks may
+ * be split anywhere. No '\0' terminator is written.
+ *
+ * @param ctx Base85 context
+ * @param stream Stream state initialized with bek_stream_init()
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param input_consumed Pointer to store number of input bytes consumed
+ * @param output Output buffer for base85 string
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base85_error_t Error code
+ */
+base85_error_t base85_encode_update(const base85_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const uint8_t *input,
+                                    size_t input_length,
+                                    size_t *input_consumed,
+                                    char *output,
+                                    size_t output_size,
+                                    size_t *output_length);
+
+/**
+ * @brief Finish a base85 encode stream, writing the last partial quantum
+ *
+ * Returns BASE85_ERROR_BUFFER_TOO_SMALL if output remains; call again with
+ * more space to receive the rest.
+ *
+ * @param ctx Base85 context
+ * @param stream Stream state
+ * @param output Output buffer for base85 string
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base85_error_t Error code
+ */
+base85_error_t base85_encode_final(const base85_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   char *output,
+                                   size_t output_size,
+                                   size_t *output_length);
+
+/**
+ * @brief Decode the next chunk of a base85 stream to binary data
+ *
+ * Whitespace is skipped. Stops early on invalid input, in which case
+ * input_consumed points at the offending character, or just past a quantum
+ * whose value does not fit in 32 bits.
+ *
+ * @param ctx Base85 context
+ * @param stream Stream state initialized with bek_stream_init()
+ * @param input Input base85 string
+ * @param input_length Length of input string
+ * @param input_consumed Pointer to store number of input characters consumed
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base85_error_t Error code
+ */
+base85_error_t base85_decode_update(const base85_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const char *input,
+                                    size_t input_length,
+                                    size_t *input_consumed,
+                                    uint8_t *output,
+                                    size_t output_size,
+                                    size_t *output_length);
+
+/**
+ * @brief Finish a base85 decode stream, writing the bytes of the last quantum
+ *
+ * Returns BASE85_ERROR_INVALID_LENGTH if the stream ended one character into
+ * a quantum and BASE85_ERROR_BUFFER_TOO_SMALL if output remains.
+ *
+ * @param ctx Base85 context
+ * @param stream Stream state
+ * @param output Output buffer for binary data
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return base85_error_t Error code
+ */
+base85_error_t base85_decode_final(const base85_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   uint8_t *output,
+                                   size_t output_size,
+                                   size_t *output_length);
+
+/**
+ * @brief Encode scattered binary data to base85, gathering into an iovec list
+ *
+ * Partial quanta are carried across input segment boundaries and output
+ * spills over into the next segment, so the result can go straight to
+ * writev(). No '\0' terminator is written.
+ *
+ * @param ctx Base85 context
+ * @param input Input segments
+ * @param input_count Number of input segments
+ * @param output Output segments, filled in order
+ * @param output_count Number of output segments
+ * @param output_length Pointer to store total output length
+ * @return base85_error_t Error code
+ */
+base85_error_t base85_encode_iov(const base85_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 int input_count,
+                                 const struct iovec *output,
+                                 int output_count,
+                                 size_t *output_length);
+
+/**
+ * @brief Decode scattered base85 text to binary data in an iovec list
+ *
+ * @param ctx Base85 context
+ * @param input Input segments
+ * @param input_count Number of input segments
+ * @param output Output segments, filled in order
+ * @param output_count Number of output segments
+ * @param output_length Pointer to store total output length
+ * @return base85_error_t Error code
+ */
+base85_error_t base85_decode_iov(const base85_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 int input_count,
+                                 const struct iovec *output,
+                                 int output_count,
+                                 size_t *output_length);
+
+/**
+ * @brief Encode binary data to base85, handing output to a callback in blocks
+ *
+ * Output is produced into an internal block of BEK_SINK_BLOCK_SIZE bytes and
+ * passed to the sink each time it fills, so memory use does not depend on
+ * the input size. No '\0' terminator is written.
+ *
+ * @param ctx Base85 context
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param sink Output callback
+ * @param user_data Pointer passed to the callback
+ * @return base85_error_t Error code, BASE85_ERROR_CALLBACK if the sink aborted
+ */
+base85_error_t base85_encode_to_sink(const base85_ctx_t *ctx,
+                                     const uint8_t *input,
+                                     size_t input_length,
+                                     bek_sink_fn sink,
+                                     void *user_data);
+
+/**
+ * @brief Decode base85 string to binary data, handing output to a callback in blocks
+ *
+ * @param ctx Base85 context
+ * @param input Input base85 string
+ * @param input_length Length of input string
+ * @param sink Output callback
+ * @param user_data Pointer passed to the callback
+ * @return base85_error_t Error code, BASE85_ERROR_CALLBACK if the sink aborted
+ */
+base85_error_t base85_decode_to_sink(const base85_ctx_t *ctx,
+                                     const char *input,
+                                     size_t input_length,
+                                     bek_sink_fn sink,
+                                     void *user_data);
+
+/**
+ * @brief Encode the used region of a ring buffer into the free region of another
+ *
+ * Both rings may wrap; the wrap points are handled internally without
+ * linearising either side. The input ring is left unchanged, the output
+ * ring's length grows by the number of characters written. No '\0'
+ * terminator is written.
+ *
+ * @param ctx Base85 context
+ * @param input Ring holding the binary data to encode
+ * @param output Ring receiving the base85 string
+ * @param output_length Pointer to store number of characters appended
+ * @return base85_error_t Error code; the output ring is only updated on success
+ */
+base85_error_t base85_encode_ring(const base85_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length);
+
+/**
+ * @brief Decode the used region of a ring buffer into the free region of another
+ *
+ * @param ctx Base85 context
+ * @param input Ring holding the base85 string
+ * @param output Ring receiving the binary data
+ * @param output_length Pointer to store number of bytes appended
+ * @return base85_error_t Error code; the output ring is only updated on success
+ */
+base85_error_t base85_decode_ring(const base85_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length);
+
+/**
+ * @brief Encode binary data to base85, appending to a growable buffer
+ *
+ * Reserves the base85_get_encode_size() length once and encodes straight into
+ * the buffer, so a buffer cleared with bek_buf_clear() and reused across calls
+ * stops allocating once it is large enough. The text is always followed by a
+ * '\0', which is not counted in buf->length. On error buf->length is
+ * unchanged.
+ *
+ * @param ctx Base85 context
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param buf Buffer to append to
+ * @return base85_error_t Error code, BASE85_ERROR_MEMORY if the buffer could not grow
+ */
+base85_error_t base85_encode_to_buf(const base85_ctx_t *ctx,
+                                    const uint8_t *input,
+                                    size_t input_length,
+                                    bek_buf_t *buf);
+
+/**
+ * @brief Decode base85 string to binary data, appending to a growable buffer
+ *
+ * Reserves the base85_get_decode_size() bound once and decodes straight into
+ * the buffer. On error buf->length is unchanged.
+ *
+ * @param ctx Base85 context
+ * @param input Input base85 string
+ * @param input_length Length of input string
+ * @param buf Buffer to append to
+ * @return base85_error_t Error code, BASE85_ERROR_MEMORY if the buffer could not grow
+ */
+base85_error_t base85_decode_to_buf(const base85_ctx_t *ctx,
+                                    const char *input,
+                                    size_t input_length,
+                                    bek_buf_t *buf);
+
+/**
+ * @brief Get string description of error code
+ *
+ * @param error Error code
+ * @return const char* Error description
+ */
+const char *base85_error_string(base85_error_t error);
+
+/**
+ * @brief Free base85 context and associated resources
+ *
+ * @param ctx Base85 context to free
+ */
+void base85_free(base85_ctx_t *ctx);
+
+#endif //BASE85_H
@@ -0,0 +1,218 @@
+// MIT License
+//
+// Copyright (c) 2024 MKKHLIF
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// File: bek.h
+
+#ifndef BEK_H
+#define BEK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Error codes for codec-independent operations
+ *
+ * The first values line up with each codec's own error enum.
+ */
+typedef enum {
+    BEK_SUCCESS = 0,
+    BEK_ERROR_INVALID_INPUT,    // Input contains invalid characters
+    BEK_ERROR_INVALID_LENGTH,   // Input length is invalid
+    BEK_ERROR_BUFFER_TOO_SMALL, // Output buffer is too small
+    BEK_ERROR_NULL_POINTER,     // NULL pointer provided
+    BEK_ERROR_PADDING,          // Invalid padding
+    BEK_ERROR_MEMORY,           // Memory allocation failure
+    BEK_ERROR_CALLBACK,         // Output callback aborted
+    BEK_ERROR_IO                // File operation failed, errno holds the cause
+} bek_error_t;
+
+/**
+ * @brief Incremental encode/decode state shared by all codecs
+ *
+ * Carries the partial quantum, the output column and any output that did not
+ * fit into the caller's buffer between calls, so input and output can be split
+ * at arbitrary byte boundaries. One state serves one stream; the codec context
+ * itself is never modified. Treat the fields as private.
+ */
+typedef struct {
+    uint64_t bits;            // Partial quantum
+    unsigned count;           // Bytes (encode) or characters (decode) in the quantum
+    unsigned padding;         // Padding characters seen while decoding
+    size_t column;            // Output column for line wrapping
+    uint8_t pending[32];      // Output produced but not yet delivered
+    unsigned pending_offset;  // First undelivered byte in pending
+    unsigned pending_length;  // Number of valid bytes in pending
+} bek_stream_t;
+
+/**
+ * @brief Size of the internal block handed to output callbacks
+ *
+ * Small enough to stay in L1/L2 while the kernel fills it.
+ */
+#define BEK_SINK_BLOCK_SIZE 16384
+
+/**
+ * @brief Output callback for the *_to_sink functions
+ *
+ * Called with each full block of output and once more with the remainder.
+ * The data is only valid for the duration of the call.
+ *
+ * @param user_data Pointer passed through from the caller
+ * @param data Output block
+ * @param length Number of bytes in the block
+ * @return int 0 to continue, non-zero to abort
+ */
+typedef int (*bek_sink_fn)(void *user_data, const void *data, size_t length);
+
+/**
+ * @brief Circular buffer descriptor for the *_ring functions
+ *
+ * The used region starts at head and may wrap past the end of the storage.
+ * A linear buffer is described by head = 0 and capacity = its size.
+ */
+typedef struct {
+    uint8_t *base;            // Start of the ring storage
+    size_t capacity;          // Size of the ring storage
+    size_t head;              // Offset of the first used byte
+    size_t length;            // Number of used bytes
+} bek_ring_t;
+
+/**
+ * @brief How one-shot encodes store their output
+ *
+ * Non-temporal stores write whole cache lines straight to memory instead of
+ * allocating them in the cache, so encoding hundreds of megabytes evicts less
+ * of the data of other threads, but the encode itself runs slower. They are
+ * only used when asked for. Streaming, iovec, sink and ring calls always use
+ * ordinary stores.
+ */
+typedef enum {
+    BEK_STORE_AUTO = 0,     // Library default, currently ordinary stores
+    BEK_STORE_CACHED,       // Always ordinary stores
+    BEK_STORE_NONTEMPORAL   // Always non-temporal stores
+} bek_store_mode_t;
+
+/**
+ * @brief Memory allocator hook
+ *
+ * alloc returns NULL on failure. free receives the size that was requested
+ * for the block, which arena and pool allocators can use; it is never called
+ * with NULL. Both may be called from any thread that uses the library object
+ * the block belongs to. A NULL allocator pointer anywhere in the API means the
+ * library allocator, see bek_set_allocator().
+ */
+typedef struct {
+    void *(*alloc)(void *user_data, size_t size);
+    void (*free)(void *user_data, void *ptr, size_t size);
+    void *user_data;          // Passed to both callbacks
+} bek_allocator_t;
+
+/**
+ * @brief Growable byte buffer for the *_to_buf functions
+ *
+ * Appends grow the storage geometrically, so a buffer that is cleared and
+ * reused across calls stops allocating once it has reached the largest size
+ * needed. Read data and length directly; change them only through the
+ * bek_buf_* functions.
+ */
+typedef struct {
+    uint8_t *data;            // Contents, NULL until the first reservation
+    size_t length;            // Number of bytes used
+    size_t capacity;          // Number of bytes allocated
+    const bek_allocator_t *allocator; // Allocator of data, NULL for the library allocator
+} bek_buf_t;
+
+/**
+ * @brief Reset a stream state before the first update call
+ *
+ * @param stream Stream state to initialize
+ */
+void bek_stream_init(bek_stream_t *stream);
+
+/**
+ * @brief Install the allocator used wherever no other one is given
+ *
+ * Covers codec contexts created without a config allocator, thread pools,
+ * file and io_uring jobs, and buffers initialized without an allocator. The
+ * allocator is copied. Call it before any other library function and before
+ * starting threads that use the library; objects keep freeing through the
+ * allocator that was installed when they were created, except buffers, which
+ * must not outlive a change.
+ *
+ * @param allocator Allocator to install, NULL to restore malloc/free
+ */
+void bek_set_allocator(const bek_allocator_t *allocator);
+
+/**
+ * @brief Initialize an empty buffer without allocating
+ *
+ * @param buf Buffer to initialize
+ * @param allocator Allocator for the storage, NULL for the library
+ *        allocator; must outlive the buffer
+ */
+void bek_buf_init(bek_buf_t *buf, const bek_allocator_t *allocator);
+
+/**
+ * @brief Make room for at least additional more bytes
+ *
+ * Grows the capacity to the larger of twice the current capacity and what is
+ * needed, copying the contents. Does nothing if the room is already there.
+ *
+ * @param buf Buffer
+ * @param additional Number of bytes to be appended
+ * @return bek_error_t Error code, BEK_ERROR_MEMORY if the allocator failed
+ */
+bek_error_t bek_buf_reserve(bek_buf_t *buf, size_t additional);
+
+/**
+ * @brief Append bytes to a buffer
+ *
+ * @param buf Buffer
+ * @param data Bytes to append
+ * @param length Number of bytes
+ * @return bek_error_t Error code, BEK_ERROR_MEMORY if the allocator failed
+ */
+bek_error_t bek_buf_append(bek_buf_t *buf, const void *data, size_t length);
+
+/**
+ * @brief Empty a buffer, keeping its storage for reuse
+ *
+ * @param buf Buffer
+ */
+void bek_buf_clear(bek_buf_t *buf);
+
+/**
+ * @brief Release the storage of a buffer and leave it empty
+ *
+ * @param buf Buffer
+ */
+void bek_buf_free(bek_buf_t *buf);
+
+/**
+ * @brief Get string description of error code
+ *
+ * @param error Error code
+ * @return const char* Error description
+ */
+const char *bek_error_string(bek_error_t error);
+
+#endif //BEK_H
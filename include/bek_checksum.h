@@ -0,0 +1,99 @@
+// MIT License
+//
+// Copyright (c) 2024 MKKHLIF
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// File: bek_checksum.h
+
+#ifndef BEK_CHECKSUM_H
+#define BEK_CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bek_codec.h"
+
+/*
+ * CRC-32C (Castagnoli), as used by iSCSI, ext4 and the object stores that
+ * accept an x-amz-checksum-crc32c style header. The fused variants checksum
+ * the raw bytes in the same pass that encodes or decodes them, one
+ * cache-sized block at a time, so the data is read from memory once.
+ */
+
+/**
+ * @brief Update a CRC-32C with more data
+ *
+ * Start from 0 and pass the previous result to continue over the next piece;
+ * the pre- and post-inversion are handled internally, as in zlib's crc32().
+ * Uses the SSE4.2 or ARMv8 CRC instructions when the CPU has them.
+ *
+ * @param crc CRC of the data so far, 0 for none
+ * @param data Data
+ * @param length Length of data
+ * @return uint32_t CRC of the data so far followed by data
+ */
+uint32_t bek_crc32c(uint32_t crc, const void *data, size_t length);
+
+/**
+ * @brief Encode binary data and compute the CRC-32C of it in one pass
+ *
+ * Produces the same output as bek_encode().
+ *
+ * @param codec Codec handle
+ * @param input Binary data
+ * @param input_length Length of input data
+ * @param output Output buffer
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @param crc In: CRC of preceding data, 0 for none; out: updated over input
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_encode_crc32c(const bek_codec_t *codec,
+                              const uint8_t *input,
+                              size_t input_length,
+                              char *output,
+                              size_t output_size,
+                              size_t *output_length,
+                              uint32_t *crc);
+
+/**
+ * @brief Decode text and compute the CRC-32C of the decoded bytes in one pass
+ *
+ * Produces the same output as bek_decode(). On error *crc covers the bytes
+ * written so far.
+ *
+ * @param codec Codec handle
+ * @param input Encoded text
+ * @param input_length Length of input
+ * @param output Output buffer
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @param crc In: CRC of preceding data, 0 for none; out: updated over output
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_decode_crc32c(const bek_codec_t *codec,
+                              const char *input,
+                              size_t input_length,
+                              uint8_t *output,
+                              size_t output_size,
+                              size_t *output_length,
+                              uint32_t *crc);
+
+#endif //BEK_CHECKSUM_H
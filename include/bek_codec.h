@@ -0,0 +1,183 @@
+// MIT License
+//
+// Copyright (c) 2024 MKKHLIF
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// File: bek_codec.h
+
+#ifndef BEK_CODEC_H
+#define BEK_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bek.h"
+#include "base16.h"
+#include "base32.h"
+#include "base64.h"
+#include "base85.h"
+
+/**
+ * @brief Codec families supported by the codec-independent API
+ */
+typedef enum {
+    BEK_CODEC_BASE64 = 0,
+    BEK_CODEC_BASE32,
+    BEK_CODEC_BASE16,
+    BEK_CODEC_BASE85
+} bek_codec_kind_t;
+
+/**
+ * @brief Handle to a configured codec context of any family
+ *
+ * Only borrows the context; the caller keeps ownership and frees it with the
+ * matching *_free function.
+ */
+typedef struct {
+    bek_codec_kind_t kind;
+    union {
+        const base64_ctx_t *base64;
+        const base32_ctx_t *base32;
+        const base16_ctx_t *base16;
+        const base85_ctx_t *base85;
+    } ctx;
+} bek_codec_t;
+
+/**
+ * @brief Calculate the exact encoded length, excluding any terminator
+ *
+ * @param codec Codec handle
+ * @param input_length Length of input data
+ * @param output_size Pointer to store the number of characters produced
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_get_encode_size(const bek_codec_t *codec,
+                                size_t input_length,
+                                size_t *output_size);
+
+/**
+ * @brief Calculate an upper bound for the decoded length
+ *
+ * @param codec Codec handle
+ * @param input_length Length of encoded input
+ * @param output_size Pointer to store the maximum number of bytes produced
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_get_decode_size(const bek_codec_t *codec,
+                                size_t input_length,
+                                size_t *output_size);
+
+/**
+ * @brief Round a chunk size down so independently encoded chunks concatenate
+ *
+ * The result is a multiple of the codec quantum whose encoding ends exactly
+ * at a line break, so every chunk but the last can be encoded on its own and
+ * the outputs joined without fix-ups. Never returns less than one such unit.
+ *
+ * @param codec Codec handle
+ * @param target Desired input chunk size in bytes
+ * @return size_t Aligned input chunk size in bytes, 0 if codec is invalid
+ */
+size_t bek_encode_chunk_size(const bek_codec_t *codec, size_t target);
+
+/**
+ * @brief Get the quantum of a codec
+ *
+ * @param codec Codec handle
+ * @param group_bytes Pointer to store bytes per quantum (may be NULL)
+ * @param group_chars Pointer to store characters per quantum (may be NULL)
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_get_quantum(const bek_codec_t *codec,
+                            size_t *group_bytes,
+                            size_t *group_chars);
+
+/**
+ * @brief Encode binary data with any codec, without a terminator
+ *
+ * @param codec Codec handle
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param output Output buffer
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_encode(const bek_codec_t *codec,
+                       const uint8_t *input,
+                       size_t input_length,
+                       char *output,
+                       size_t output_size,
+                       size_t *output_length);
+
+/**
+ * @brief Decode text with any codec
+ *
+ * @param codec Codec handle
+ * @param input Input string
+ * @param input_length Length of input string
+ * @param output Output buffer
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_decode(const bek_codec_t *codec,
+                       const char *input,
+                       size_t input_length,
+                       uint8_t *output,
+                       size_t output_size,
+                       size_t *output_length);
+
+/**
+ * @brief Encode binary data with any codec, appending to a growable buffer
+ *
+ * Reserves the exact encoded length once, then encodes straight into the
+ * buffer. The text is followed by a '\0' that is not counted in buf->length.
+ * On error buf->length is unchanged.
+ *
+ * @param codec Codec handle
+ * @param input Input binary data
+ * @param input_length Length of input data
+ * @param buf Buffer to append to
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_encode_to_buf(const bek_codec_t *codec,
+                              const uint8_t *input,
+                              size_t input_length,
+                              bek_buf_t *buf);
+
+/**
+ * @brief Decode text with any codec, appending to a growable buffer
+ *
+ * Reserves the bek_get_decode_size() bound once, then decodes straight into
+ * the buffer. On error buf->length is unchanged.
+ *
+ * @param codec Codec handle
+ * @param input Input string
+ * @param input_length Length of input string
+ * @param buf Buffer to append to
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_decode_to_buf(const bek_codec_t *codec,
+                              const char *input,
+                              size_t input_length,
+                              bek_buf_t *buf);
+
+#endif //BEK_CODEC_H
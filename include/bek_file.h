@@ -0,0 +1,82 @@
+// MIT License
+//
+// Copyright (c) 2024 MKKHLIF
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// File: bek_file.h
+
+#ifndef BEK_FILE_H
+#define BEK_FILE_H
+
+#include <stddef.h>
+
+#include "bek_codec.h"
+
+/**
+ * @brief Default number of input bytes handed to each thread by the file APIs
+ */
+#define BEK_FILE_DEFAULT_CHUNK_SIZE (1024 * 1024)
+
+/**
+ * @brief Options for memory-mapped file encoding and decoding
+ */
+typedef struct {
+    unsigned threads;  // Worker threads (0 or 1 runs on the calling thread)
+    size_t chunk_size; // Input bytes per parallel chunk (0 for the default)
+} bek_file_options_t;
+
+/**
+ * @brief Encode a regular file into another through memory mappings
+ *
+ * The output file is created or truncated, pre-sized to the exact encoded
+ * length and written through a shared mapping, so no data passes through heap
+ * buffers. The output has no terminator and no trailing line ending beyond
+ * the ones produced by line wrapping.
+ *
+ * @param codec Codec handle
+ * @param input_path Path of the file to encode
+ * @param output_path Path of the file to write
+ * @param options Threading options (NULL for single-threaded defaults)
+ * @return bek_error_t Error code; on BEK_ERROR_IO errno holds the cause
+ */
+bek_error_t bek_encode_file(const bek_codec_t *codec,
+                            const char *input_path,
+                            const char *output_path,
+                            const bek_file_options_t *options);
+
+/**
+ * @brief Decode a regular file into another through memory mappings
+ *
+ * The output file is pre-sized to the maximum decoded length and truncated to
+ * the actual length once decoding succeeds. Characters the codec treats as
+ * whitespace may appear anywhere in the input.
+ *
+ * @param codec Codec handle
+ * @param input_path Path of the file to decode
+ * @param output_path Path of the file to write
+ * @param options Threading options (NULL for single-threaded defaults)
+ * @return bek_error_t Error code; on BEK_ERROR_IO errno holds the cause
+ */
+bek_error_t bek_decode_file(const bek_codec_t *codec,
+                            const char *input_path,
+                            const char *output_path,
+                            const bek_file_options_t *options);
+
+#endif //BEK_FILE_H
@@ -0,0 +1,129 @@
+// MIT License
+//
+// Copyright (c) 2024 MKKHLIF
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// File: bek_pem.h
+
+#ifndef BEK_PEM_H
+#define BEK_PEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bek.h"
+
+/*
+ * PEM (RFC 7468) blocks: base64 text between "-----BEGIN label-----" and
+ * "-----END label-----" lines. Text outside blocks is skipped, so CA bundles
+ * with explanatory lines parse as they are. Encapsulated headers of legacy
+ * OpenSSL keys ("Proc-Type:") are not supported.
+ */
+
+/**
+ * @brief One PEM block located in a larger text, without copying
+ *
+ * label and body point into the text passed to bek_pem_next().
+ */
+typedef struct {
+    const char *label;        // Label of the BEGIN line, e.g. "CERTIFICATE"; NULL if none was found
+    size_t label_length;
+    const char *body;         // Base64 lines between the BEGIN and END lines
+    size_t body_length;
+} bek_pem_block_t;
+
+/**
+ * @brief Locate the next PEM block
+ *
+ * Searches from *offset and advances it past the END line of the block.
+ * When no further BEGIN line exists, returns BEK_SUCCESS with block->label
+ * set to NULL and *offset set to input_length.
+ *
+ * @param input PEM text, e.g. a whole certificate bundle
+ * @param input_length Length of input
+ * @param offset Position to search from, updated past the block
+ * @param block Pointer to store the located block
+ * @return bek_error_t Error code; BEK_ERROR_INVALID_INPUT if a block has no
+ *         matching END line
+ */
+bek_error_t bek_pem_next(const char *input,
+                         size_t input_length,
+                         size_t *offset,
+                         bek_pem_block_t *block);
+
+/**
+ * @brief Calculate an upper bound for the decoded length of a block
+ *
+ * @param block Located block
+ * @return size_t Maximum number of bytes bek_pem_decode() writes
+ */
+size_t bek_pem_get_decode_size(const bek_pem_block_t *block);
+
+/**
+ * @brief Decode the body of a PEM block to binary (DER) data
+ *
+ * Lines of exactly 64 characters are decoded as whole quanta with the line
+ * ending checked at its fixed offset; anything else, such as the short last
+ * line, padding or other wrap widths, goes through the general base64
+ * decoder, which skips whitespace.
+ *
+ * @param block Located block
+ * @param output Output buffer
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_pem_decode(const bek_pem_block_t *block,
+                           uint8_t *output,
+                           size_t output_size,
+                           size_t *output_length);
+
+/**
+ * @brief Calculate the exact length of an encoded PEM block
+ *
+ * @param label_length Length of the label
+ * @param input_length Length of the binary data
+ * @return size_t Number of characters bek_pem_encode() writes
+ */
+size_t bek_pem_get_encode_size(size_t label_length, size_t input_length);
+
+/**
+ * @brief Encode binary data as one PEM block
+ *
+ * Writes the BEGIN line, the base64 body wrapped at 64 columns and the END
+ * line, each ending in "\n". No '\0' terminator is written, so blocks can be
+ * appended back to back into a bundle.
+ *
+ * @param label Label, e.g. "CERTIFICATE"
+ * @param input Binary data
+ * @param input_length Length of input data
+ * @param output Output buffer
+ * @param output_size Size of output buffer
+ * @param output_length Pointer to store actual output length
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_pem_encode(const char *label,
+                           const uint8_t *input,
+                           size_t input_length,
+                           char *output,
+                           size_t output_size,
+                           size_t *output_length);
+
+#endif //BEK_PEM_H
@@ -0,0 +1,187 @@
+// MIT License
+//
+// Copyright (c) 2024 MKKHLIF
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// File: bek_pool.h
+
+#ifndef BEK_POOL_H
+#define BEK_POOL_H
+
+#include <stddef.h>
+
+#include "bek_codec.h"
+
+/**
+ * @brief Jobs larger than this many input bytes are split across threads
+ */
+#define BEK_POOL_SPLIT_SIZE (1024 * 1024)
+
+/**
+ * @brief Approximate input bytes per piece of a split job
+ */
+#define BEK_POOL_PIECE_SIZE (256 * 1024)
+
+/**
+ * @brief Consecutive small jobs are batched into tasks of about this size
+ */
+#define BEK_POOL_BATCH_SIZE (64 * 1024)
+
+/**
+ * @brief Direction of a job
+ */
+typedef enum {
+    BEK_JOB_ENCODE = 0,
+    BEK_JOB_DECODE
+} bek_job_op_t;
+
+/**
+ * @brief One independent encode or decode request
+ *
+ * Encoding writes no terminator. The output buffers of different jobs must
+ * not overlap.
+ */
+typedef struct {
+    const bek_codec_t *codec;  // Codec handle
+    bek_job_op_t op;           // Encode or decode
+    const void *input;         // Binary data (encode) or text (decode)
+    size_t input_length;       // Length of input
+    void *output;              // Output buffer
+    size_t output_size;        // Size of output buffer
+    size_t output_length;      // Set to the number of bytes produced
+    bek_error_t status;        // Set to the result of this job
+} bek_job_t;
+
+/**
+ * @brief Opaque work-stealing thread pool
+ */
+typedef struct bek_pool_t bek_pool_t;
+
+/**
+ * @brief Create a pool of worker threads
+ *
+ * @param pool Pointer to pool pointer to be initialized
+ * @param threads Number of threads including the caller of bek_pool_run
+ *                (0 for the number of online CPUs)
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_pool_create(bek_pool_t **pool, unsigned threads);
+
+/**
+ * @brief NUMA layout a pool places its threads and pieces by
+ *
+ * Read from /sys/devices/system/node and move_pages(2) when not given. Any
+ * layout can be described instead, e.g. to exercise placement on a
+ * single-node machine; pinning to a CPU that does not exist is skipped.
+ */
+typedef struct {
+    unsigned cpu_count;        // Number of CPUs
+    const int *cpu_nodes;      // Node of each CPU, cpu_count entries
+    // Node of the page holding address, negative if unknown
+    int (*page_node)(void *user_data, const void *address);
+    void *user_data;           // Passed to page_node
+} bek_numa_topology_t;
+
+/**
+ * @brief Options of a NUMA-aware pool
+ */
+typedef struct {
+    unsigned threads;                    // Including the caller of bek_pool_run (0 for one per CPU)
+    const bek_numa_topology_t *topology; // NULL for the layout of this machine
+} bek_numa_options_t;
+
+/**
+ * @brief Counters of the pieces split jobs were cut into
+ */
+typedef struct {
+    size_t pieces;             // Pieces run
+    size_t pieces_placed;      // Queued on a thread of the node holding their input
+    size_t pieces_local;       // Run by a thread of the node holding their input
+} bek_pool_stats_t;
+
+/**
+ * @brief Create a pool whose workers are pinned across NUMA nodes
+ *
+ * Worker threads are pinned with sched_setaffinity to CPUs taken from each
+ * node in turn; the thread calling bek_pool_run is left alone. Pieces of
+ * split jobs are queued on a worker of the node that owns their input pages
+ * and idle workers steal from their own node first, so large buffers are
+ * read where they live. Output pages that have not been touched yet land on
+ * the node of the worker that writes them first; see bek_pool_map_output.
+ *
+ * @param pool Pointer to pool pointer to be initialized
+ * @param options Thread count and topology, NULL for defaults
+ * @return bek_error_t Error code
+ */
+bek_error_t bek_pool_create_numa(bek_pool_t **pool, const bek_numa_options_t *options);
+
+/**
+ * @brief Read the piece counters of a pool
+ *
+ * @param pool Pool to query
+ * @param stats Set to the counters accumulated since the pool was created
+ */
+void bek_pool_get_stats(const bek_pool_t *pool, bek_pool_stats_t *stats);
+
+/**
+ * @brief Map memory for a large job output, backed by huge pages if possible
+ *
+ * Tries MAP_HUGETLB and falls back to ordinary pages with a transparent huge
+ * page hint. The pages are not touched, so each lands on the node of the
+ * thread that writes it first.
+ *
+ * @param size Number of bytes
+ * @return void* Mapping, NULL on failure
+ */
+void *bek_pool_map_output(size_t size);
+
+/**
+ * @brief Unmap memory from bek_pool_map_output
+ *
+ * @param data Mapping, NULL is ignored
+ * @param size Size it was mapped with
+ */
+void bek_pool_unmap_output(void *data, size_t size);
+
+/**
+ * @brief Stop the workers and free the pool
+ *
+ * @param pool Pool to free
+ */
+void bek_pool_free(bek_pool_t *pool);
+
+/**
+ * @brief Run a vector of jobs to completion
+ *
+ * Small jobs are batched, large ones are split into pieces, and idle threads
+ * steal work from busy ones. The calling thread takes part and returns once
+ * every job has finished. Each job's status and output_length are filled in
+ * independently, so one failing job does not affect the others. Only one
+ * thread may run jobs on a pool at a time.
+ *
+ * @param pool Pool to run on
+ * @param jobs Jobs to run
+ * @param job_count Number of jobs
+ * @return bek_error_t BEK_SUCCESS if every job succeeded, otherwise the
+ *         status of the first failed job
+ */
+bek_error_t bek_pool_run(bek_pool_t *pool, bek_job_t *jobs, size_t job_count);
+
+#endif //BEK_POOL_H
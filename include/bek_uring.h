@@ -0,0 +1,86 @@
+// MIT License
+//
+// Copyright (c) 2024 MKKHLIF
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// File: bek_uring.h
+
+#ifndef BEK_URING_H
+#define BEK_URING_H
+
+#include <stddef.h>
+
+#include "bek_codec.h"
+
+/**
+ * @brief Default number of blocks kept in flight by the io_uring backend
+ */
+#define BEK_URING_DEFAULT_QUEUE_DEPTH 8
+
+/**
+ * @brief Default block size read and written by the io_uring backend
+ */
+#define BEK_URING_DEFAULT_BLOCK_SIZE (256 * 1024)
+
+/**
+ * @brief Options for the io_uring file backend
+ */
+typedef struct {
+    unsigned queue_depth; // Blocks in flight (0 for the default)
+    size_t block_size;    // Input bytes per read (0 for the default)
+} bek_uring_options_t;
+
+/**
+ * @brief Encode a file using io_uring for all reads and writes
+ *
+ * Keeps up to queue_depth reads and writes in flight on registered buffers
+ * and encodes each block on the calling thread as its read completes. The
+ * output matches bek_encode() over the whole file.
+ *
+ * Only available when the library is built with BEK_WITH_IO_URING, which
+ * defines BEK_HAVE_IO_URING; otherwise fails with BEK_ERROR_IO and errno set
+ * to ENOSYS.
+ *
+ * @param codec Codec handle
+ * @param input_path Path of the file to encode
+ * @param output_path Path of the file to write
+ * @param options Queue options (NULL for defaults)
+ * @return bek_error_t Error code; on BEK_ERROR_IO errno holds the cause
+ */
+bek_error_t bek_encode_file_uring(const bek_codec_t *codec,
+                                  const char *input_path,
+                                  const char *output_path,
+                                  const bek_uring_options_t *options);
+
+/**
+ * @brief Decode a file using io_uring for all reads and writes
+ *
+ * @param codec Codec handle
+ * @param input_path Path of the file to decode
+ * @param output_path Path of the file to write
+ * @param options Queue options (NULL for defaults)
+ * @return bek_error_t Error code; on BEK_ERROR_IO errno holds the cause
+ */
+bek_error_t bek_decode_file_uring(const bek_codec_t *codec,
+                                  const char *input_path,
+                                  const char *output_path,
+                                  const bek_uring_options_t *options);
+
+#endif //BEK_URING_H
@@ -0,0 +1,49 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "alloc.h"
+
+static void *default_alloc(void *user_data, const size_t size) {
+    (void) user_data;
+    return malloc(size);
+}
+
+static void default_free(void *user_data, void *ptr, const size_t size) {
+    (void) user_data;
+    (void) size;
+    free(ptr);
+}
+
+static const bek_allocator_t DEFAULT_ALLOCATOR = {default_alloc, default_free, NULL};
+
+// Read without synchronisation: installed before any thread uses the library
+static bek_allocator_t library_allocator = {default_alloc, default_free, NULL};
+
+void bek_set_allocator(const bek_allocator_t *allocator) {
+    library_allocator = allocator != NULL && allocator->alloc != NULL && allocator->free != NULL
+                            ? *allocator
+                            : DEFAULT_ALLOCATOR;
+}
+
+bek_allocator_t bek_allocator(const bek_allocator_t *allocator) {
+    return allocator != NULL ? *allocator : library_allocator;
+}
+
+void *bek_alloc(const bek_allocator_t *allocator, const size_t size) {
+    const bek_allocator_t *a = allocator != NULL ? allocator : &library_allocator;
+    return a->alloc(a->user_data, size);
+}
+
+void *bek_calloc(const bek_allocator_t *allocator, const size_t count, const size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) return NULL;
+    void *ptr = bek_alloc(allocator, count * size);
+    if (ptr != NULL) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void bek_free(const bek_allocator_t *allocator, void *ptr, const size_t size) {
+    if (ptr == NULL) return;
+    const bek_allocator_t *a = allocator != NULL ? allocator : &library_allocator;
+    a->free(a->user_data, ptr, size);
+}
@@ -1,17 +1,31 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 #include "base16.h"
 
+#include "alloc.h"
+#include "bytes.h"
+#include "codec.h"
+#include "ignore.h"
+#include "stream.h"
+#include "swar.h"
+#include "tables.h"
+
 // Internal context structure
 struct base16_ctx_t {
     int uppercase;
     int line_length;
     char line_ending[3];
-    int current_line_length;
+    int omit_terminator;
+    const uint8_t *decode_table; // Shared read-only nibble table, both letter cases
+    bek_ignore_t ignore;       // Characters base16_decode skips
+    bek_codec_desc_t desc;     // Configuration as seen by the streaming engine
+    bek_allocator_t allocator; // Allocator the context was allocated with
 };
 
+static void encode_groups(const char *alphabet, const uint8_t *input, size_t groups, char *output);
+static size_t decode_groups(const uint8_t *table, const char *input, size_t groups, uint8_t *output);
+
 // Default configuration
 static const base16_config_t DEFAULT_CONFIG = {
     .uppercase = 1,
@@ -24,20 +38,52 @@ base16_error_t base16_init(base16_ctx_t **ctx, const base16_config_t *config) {
         return BASE16_ERROR_NULL_POINTER;
     }
 
+    // Use default config if not provided
+    const base16_config_t *effective_config = config ? config : &DEFAULT_CONFIG;
+
     // Allocate context
-    *ctx = malloc(sizeof(base16_ctx_t));
+    const bek_allocator_t allocator = bek_allocator(effective_config->allocator);
+    *ctx = bek_alloc(&allocator, sizeof(base16_ctx_t));
     if (*ctx == NULL) {
         return BASE16_ERROR_MEMORY;
     }
-
-    // Use default config if not provided
-    const base16_config_t *effective_config = config ? config : &DEFAULT_CONFIG;
+    (*ctx)->allocator = allocator;
 
     // Copy configuration
     (*ctx)->uppercase = effective_config->uppercase;
     (*ctx)->line_length = effective_config->line_length;
-    (*ctx)->current_line_length = 0;
+    (*ctx)->omit_terminator = effective_config->omit_terminator;
     strncpy((*ctx)->line_ending, effective_config->line_ending, sizeof((*ctx)->line_ending) - 1);
+    (*ctx)->line_ending[sizeof((*ctx)->line_ending) - 1] = '\0';
+
+    // Point at the prebuilt reverse table
+    (*ctx)->decode_table = bek_base16_decode;
+
+    // Skipping a hex digit would change the data
+    bek_ignore_init(&(*ctx)->ignore, effective_config->ignore ? effective_config->ignore : " \t\n\v\f\r");
+    for (int c = 0; c < 256; c++) {
+        if (bek_ignored(&(*ctx)->ignore, (uint8_t) c) && (*ctx)->decode_table[c] < 16) {
+            bek_free(&allocator, *ctx, sizeof(base16_ctx_t));
+            *ctx = NULL;
+            return BASE16_ERROR_INVALID_INPUT;
+        }
+    }
+
+    // Describe the configuration for the streaming engine
+    (*ctx)->desc = (bek_codec_desc_t){
+        .alphabet = (*ctx)->uppercase ? bek_base16_upper_alphabet : bek_base16_lower_alphabet,
+        .decode_table = (*ctx)->decode_table,
+        .ignore = &(*ctx)->ignore,
+        .bits_per_char = 4,
+        .group_bytes = 1,
+        .group_chars = 2,
+        .use_padding = 0,
+        .line_length = (*ctx)->line_length > 0 ? (size_t) (*ctx)->line_length : 0,
+        .line_ending = (*ctx)->line_ending,
+        .stores = effective_config->stores,
+        .encode_groups = encode_groups,
+        .decode_groups = decode_groups
+    };
 
     return BASE16_SUCCESS;
 }
@@ -58,7 +104,7 @@ base16_error_t base16_get_encode_size(size_t input_length,
         base_size += line_breaks;
     }
 
-    *output_size = base_size + 1; // +1 for null terminator
+    *output_size = base_size + (ctx->omit_terminator ? 0 : 1); // +1 for null terminator
     return BASE16_SUCCESS;
 }
 
@@ -74,7 +120,19 @@ base16_error_t base16_get_decode_size(size_t input_length,
     return BASE16_SUCCESS;
 }
 
-base16_error_t base16_encode(base16_ctx_t *ctx,
+// Helper function to write one character, wrapping lines as configured
+static inline void put_char(const base16_ctx_t *ctx, char *output, size_t *output_index,
+                            size_t *column, const char c) {
+    output[(*output_index)++] = c;
+    if (ctx->line_length > 0 && ++*column == (size_t) ctx->line_length) {
+        for (const char *e = ctx->line_ending; *e != '\0'; e++) {
+            output[(*output_index)++] = *e;
+        }
+        *column = 0;
+    }
+}
+
+base16_error_t base16_encode(const base16_ctx_t *ctx,
                              const uint8_t *input,
                              size_t input_length,
                              char *output,
@@ -92,36 +150,97 @@ base16_error_t base16_encode(base16_ctx_t *ctx,
         return BASE16_ERROR_BUFFER_TOO_SMALL;
     }
 
+    // Output asked to bypass the cache goes through the engine
+    if (bek_use_nontemporal(&ctx->desc)) {
+        size_t length;
+        bek_encode_nontemporal(&ctx->desc, input, input_length, output, output_size, &length);
+        if (!ctx->omit_terminator) output[length] = '\0';
+        *output_length = length;
+        return BASE16_SUCCESS;
+    }
+
     size_t out_idx = 0;
-    size_t line_count = 0;
+    size_t column = 0;
 
     for (size_t i = 0; i < input_length; i++) {
         // Hex encoding for each byte
         int high = (input[i] >> 4) & 0x0F;
         int low = input[i] & 0x0F;
 
-        // Convert to hex character
-        output[out_idx++] = high + (high > 9 ? (ctx->uppercase ? 'A' - 10 : 'a' - 10) : '0');
-        output[out_idx++] = low + (low > 9 ? (ctx->uppercase ? 'A' - 10 : 'a' - 10) : '0');
-
-        // Add line breaks if configured
-        if (ctx->line_length > 0) {
-            line_count += 2;
-            if (line_count >= ctx->line_length) {
-                strcpy(output + out_idx, ctx->line_ending);
-                out_idx += strlen(ctx->line_ending);
-                line_count = 0;
-            }
-        }
+        // Convert to hex character, adding line breaks if configured
+        put_char(ctx, output, &out_idx, &column, high + (high > 9 ? (ctx->uppercase ? 'A' - 10 : 'a' - 10) : '0'));
+        put_char(ctx, output, &out_idx, &column, low + (low > 9 ? (ctx->uppercase ? 'A' - 10 : 'a' - 10) : '0'));
     }
 
-    output[out_idx] = '\0';
+    if (!ctx->omit_terminator) output[out_idx] = '\0';
     *output_length = out_idx;
 
     return BASE16_SUCCESS;
 }
 
-base16_error_t base16_decode(base16_ctx_t *ctx,
+// Decode runs of eight hex digits until a word holds anything else; returns
+// the number of characters decoded
+static size_t decode_words(const char *input, const size_t length, uint8_t *output) {
+    size_t i = 0;
+    for (uint64_t values; BEK_SWAR && i + 8 <= length &&
+         swar_hex_classify(load_be64((const uint8_t *) input + i), &values) == 0;
+         i += 8, output += 4) {
+        store_be32(output, swar_pack4(values));
+    }
+    return i;
+}
+
+// decode_words for UTF-16 text, narrowing each word of code units as it loads
+// it; a unit above 0xFF ends the run like any other invalid character
+static size_t decode_words16(const uint16_t *input, const size_t length, uint8_t *output) {
+    size_t i = 0;
+    for (uint64_t chars, values; BEK_SWAR && i + 8 <= length && load_narrow_be64(input + i, &chars) <= 0xFF &&
+         swar_hex_classify(chars, &values) == 0;
+         i += 8, output += 4) {
+        store_be32(output, swar_pack4(values));
+    }
+    return i;
+}
+
+// Character loop: skips the ignore set anywhere and drops a lone final digit.
+// Reads UTF-16 code units when wide is set; units above 0xFF are invalid.
+static base16_error_t decode_chars(const base16_ctx_t *ctx,
+                                   const void *input,
+                                   const int wide,
+                                   const size_t input_length,
+                                   uint8_t *output,
+                                   size_t *output_length) {
+    size_t out_idx = 0;
+
+    for (size_t i = 0; i < input_length; i += 2) {
+        // Eight digits at a time while the input is plain hex
+        const size_t run = wide ? decode_words16((const uint16_t *) input + i, input_length - i, output + out_idx)
+                                : decode_words((const char *) input + i, input_length - i, output + out_idx);
+        i += run;
+        out_idx += run / 2;
+
+        // Skip whitespace
+        while (i < input_length && text_at(input, wide, i) <= 0xFF &&
+               bek_ignored(&ctx->ignore, (uint8_t) text_at(input, wide, i))) i++;
+        if (i + 1 >= input_length) break;
+
+        // Convert hex characters to byte; the table marks everything else
+        // with a class above 15
+        const unsigned c0 = text_at(input, wide, i), c1 = text_at(input, wide, i + 1);
+        const uint8_t high = c0 <= 0xFF ? ctx->decode_table[c0] : BEK_CLASS_INVALID;
+        const uint8_t low = c1 <= 0xFF ? ctx->decode_table[c1] : BEK_CLASS_INVALID;
+        if (high > 15 || low > 15) {
+            return BASE16_ERROR_INVALID_INPUT;
+        }
+
+        output[out_idx++] = (uint8_t) (high << 4 | low);
+    }
+
+    *output_length = out_idx;
+    return BASE16_SUCCESS;
+}
+
+base16_error_t base16_decode(const base16_ctx_t *ctx,
                              const char *input,
                              size_t input_length,
                              uint8_t *output,
@@ -139,26 +258,137 @@ base16_error_t base16_decode(base16_ctx_t *ctx,
         return BASE16_ERROR_BUFFER_TOO_SMALL;
     }
 
+    size_t i = 0;
     size_t out_idx = 0;
 
-    for (size_t i = 0; i < input_length; i += 2) {
-        // Skip whitespace
-        while (i < input_length && isspace(input[i])) i++;
-        if (i + 1 >= input_length) break;
+    // Runs of digits decode in place. From the first word that breaks a run,
+    // a block of the input is compacted and decoded whole, then the next run
+    // is tried. A block holding anything but digits, and a lone final digit,
+    // go to the character loop.
+    char block[BEK_COMPACT_BLOCK + 8];
+    while (i < input_length) {
+        const size_t run = decode_words(input + i, input_length - i, output + out_idx);
+        i += run;
+        out_idx += run / 2;
+
+        size_t taken;
+        const size_t kept = bek_compact(&ctx->ignore, input + i, input_length - i, block, BEK_COMPACT_BLOCK, &taken);
+        const size_t words = decode_words(block, kept, output + out_idx);
+        const size_t pairs = (kept - words) / 2;
+        if (decode_groups(ctx->decode_table, block + words, pairs, output + out_idx + words / 2) != pairs) break;
+        out_idx += kept / 2;
+        i += taken;
+    }
 
-        // Convert hex characters to byte
-        int high = isdigit(input[i]) ? input[i] - '0' : (tolower(input[i]) - 'a' + 10);
-        int low = isdigit(input[i + 1]) ? input[i + 1] - '0' : (tolower(input[i + 1]) - 'a' + 10);
+    size_t tail;
+    const base16_error_t error = decode_chars(ctx, input + i, 0, input_length - i, output + out_idx, &tail);
+    if (error == BASE16_SUCCESS) *output_length = out_idx + tail;
+    return error;
+}
 
-        // Validate hex characters
-        if (high > 15 || low > 15) {
-            return BASE16_ERROR_INVALID_INPUT;
-        }
+// Encode one 8-byte word into 16 characters
+static inline void encode_word(const char *digits, const uint64_t w, char *o) {
+    for (int k = 0; k < 8; k++) {
+        const uint8_t b = (uint8_t) (w >> (56 - 8 * k));
+        o[2 * k] = digits[b >> 4];
+        o[2 * k + 1] = digits[b & 0x0F];
+    }
+}
 
-        output[out_idx++] = (high << 4) | low;
+base16_error_t base16_encode_slop(const base16_ctx_t *ctx,
+                                  const uint8_t *input,
+                                  const size_t input_length,
+                                  char *output,
+                                  const size_t output_size,
+                                  size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
     }
 
-    *output_length = out_idx;
+    if (ctx->line_length > 0) {
+        return base16_encode(ctx, input, input_length, output, output_size, output_length);
+    }
+
+    size_t required_size;
+    const base16_error_t size_check = base16_get_encode_size(input_length, ctx, &required_size);
+    if (size_check != BASE16_SUCCESS) return size_check;
+
+    if (output_size < required_size) {
+        return BASE16_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    const char *digits = ctx->uppercase ? bek_base16_upper_alphabet : bek_base16_lower_alphabet;
+    size_t i = 0;
+
+    // 8 input bytes -> 16 characters per step; the last step may run into the slop
+    do {
+        encode_word(digits, load_be64(input + i), output + 2 * i);
+        i += 8;
+    } while (i < input_length);
+
+    if (!ctx->omit_terminator) output[2 * input_length] = '\0';
+    *output_length = 2 * input_length;
+
+    return BASE16_SUCCESS;
+}
+
+// Decode 8 characters into a 32-bit group; lanes outside lane_mask count as '0'.
+// Returns non-zero if any kept lane is not a hex digit.
+static inline uint64_t decode_word(const uint8_t *table, const char *input,
+                                   const uint64_t lane_mask, uint64_t *bits) {
+    const uint8_t *p = (const uint8_t *) input;
+    const uint64_t d = ((uint64_t) table[p[0]] << 56) | ((uint64_t) table[p[1]] << 48) |
+                       ((uint64_t) table[p[2]] << 40) | ((uint64_t) table[p[3]] << 32) |
+                       ((uint64_t) table[p[4]] << 24) | ((uint64_t) table[p[5]] << 16) |
+                       ((uint64_t) table[p[6]] << 8) | (uint64_t) table[p[7]];
+    const uint64_t v = d & lane_mask;
+
+    *bits = ((v >> 56) & 0x0F) << 60 | ((v >> 48) & 0x0F) << 56 |
+            ((v >> 40) & 0x0F) << 52 | ((v >> 32) & 0x0F) << 48 |
+            ((v >> 24) & 0x0F) << 44 | ((v >> 16) & 0x0F) << 40 |
+            ((v >> 8) & 0x0F) << 36 | (v & 0x0F) << 32;
+    return v & 0x8080808080808080ULL;
+}
+
+base16_error_t base16_decode_slop(const base16_ctx_t *ctx,
+                                  const char *input,
+                                  const size_t input_length,
+                                  uint8_t *output,
+                                  const size_t output_size,
+                                  size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+
+    if (input_length % 2 != 0) {
+        return BASE16_ERROR_INVALID_LENGTH;
+    }
+
+    const size_t decoded_length = input_length / 2;
+    if (output_size < decoded_length) {
+        return BASE16_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    const uint8_t *table = ctx->decode_table;
+    uint64_t invalid = 0;
+    uint64_t bits;
+    size_t i = 0;
+
+    // 8 characters -> 4 bytes per step, storing a full 8-byte word
+    for (; i + 8 <= input_length; i += 8) {
+        invalid |= decode_word(table, input + i, UINT64_MAX, &bits);
+        store_be64(output + i / 2, bits);
+    }
+
+    // Tail: lanes past the end are masked out rather than branched around
+    invalid |= decode_word(table, input + i, be64_prefix_mask(input_length - i), &bits);
+    store_be64(output + i / 2, bits);
+
+    if (invalid) {
+        return BASE16_ERROR_INVALID_INPUT;
+    }
+
+    *output_length = decoded_length;
     return BASE16_SUCCESS;
 }
 
@@ -170,12 +400,498 @@ const char *base16_error_string(base16_error_t error) {
         case BASE16_ERROR_BUFFER_TOO_SMALL: return "Buffer too small";
         case BASE16_ERROR_NULL_POINTER: return "Null pointer";
         case BASE16_ERROR_MEMORY: return "Memory allocation failed";
+        case BASE16_ERROR_CALLBACK: return "Output callback aborted";
         default: return "Unknown error";
     }
 }
 
 void base16_free(base16_ctx_t *ctx) {
     if (ctx != NULL) {
-        free(ctx);
+        const bek_allocator_t allocator = ctx->allocator;
+        bek_free(&allocator, ctx, sizeof(base16_ctx_t));
+    }
+}
+
+// put_char for UTF-16 output
+static inline void put_unit(const base16_ctx_t *ctx, uint16_t *output, size_t *output_index,
+                            size_t *column, const char c) {
+    output[(*output_index)++] = (uint8_t) c;
+    if (ctx->line_length > 0 && ++*column == (size_t) ctx->line_length) {
+        for (const char *e = ctx->line_ending; *e != '\0'; e++) {
+            output[(*output_index)++] = (uint8_t) *e;
+        }
+        *column = 0;
+    }
+}
+
+// encode_groups with each character widened to a code unit as it is stored
+static void encode_groups16(const char *alphabet, const uint8_t *input, const size_t groups, uint16_t *output) {
+    for (size_t g = 0; g < groups; g++) {
+        output[2 * g] = (uint8_t) alphabet[input[g] >> 4];
+        output[2 * g + 1] = (uint8_t) alphabet[input[g] & 0x0F];
+    }
+}
+
+base16_error_t base16_encode_utf16(const base16_ctx_t *ctx,
+                                   const uint8_t *input,
+                                   const size_t input_length,
+                                   uint16_t *output,
+                                   const size_t output_size,
+                                   size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
     }
+
+    size_t required_size;
+    const base16_error_t size_check = base16_get_encode_size(input_length, ctx, &required_size);
+    if (size_check != BASE16_SUCCESS) return size_check;
+
+    if (output_size < required_size) {
+        return BASE16_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    const char *digits = ctx->uppercase ? bek_base16_upper_alphabet : bek_base16_lower_alphabet;
+    const size_t line = ctx->line_length > 0 ? (size_t) ctx->line_length : 0;
+    size_t i = 0;
+    size_t output_index = 0;
+    size_t column = 0;
+
+    while (i < input_length) {
+        // Whole bytes up to the end of the line go through the kernel; a byte
+        // that straddles a line break is written a unit at a time
+        size_t run = input_length - i;
+        if (line > 0 && run > (line - column) / 2) run = (line - column) / 2;
+        if (run == 0) {
+            put_unit(ctx, output, &output_index, &column, digits[input[i] >> 4]);
+            put_unit(ctx, output, &output_index, &column, digits[input[i] & 0x0F]);
+            i++;
+            continue;
+        }
+
+        encode_groups16(digits, input + i, run, output + output_index);
+        i += run;
+        output_index += 2 * run;
+        column += 2 * run;
+        if (column == line) {
+            for (const char *e = ctx->line_ending; *e != '\0'; e++) output[output_index++] = (uint8_t) *e;
+            column = 0;
+        }
+    }
+
+    if (!ctx->omit_terminator) output[output_index] = 0;
+    *output_length = output_index;
+
+    return BASE16_SUCCESS;
+}
+
+base16_error_t base16_decode_utf16(const base16_ctx_t *ctx,
+                                   const uint16_t *input,
+                                   const size_t input_length,
+                                   uint8_t *output,
+                                   const size_t output_size,
+                                   size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+
+    size_t required_size;
+    const base16_error_t size_check = base16_get_decode_size(input_length, ctx, &required_size);
+    if (size_check != BASE16_SUCCESS) return size_check;
+
+    if (output_size < required_size) {
+        return BASE16_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    size_t i = 0;
+    size_t out_idx = 0;
+
+    // The loop of base16_decode with the narrowing folded into the word loads
+    // and the compaction. A block holding a unit above 0xFF goes to the
+    // character loop like one holding invalid input.
+    char block[BEK_COMPACT_BLOCK + 8];
+    while (i < input_length) {
+        const size_t run = decode_words16(input + i, input_length - i, output + out_idx);
+        i += run;
+        out_idx += run / 2;
+
+        size_t taken;
+        int wide;
+        const size_t kept = bek_compact16(&ctx->ignore, input + i, input_length - i, block, BEK_COMPACT_BLOCK,
+                                          &taken, &wide);
+        const size_t words = decode_words(block, kept, output + out_idx);
+        const size_t pairs = (kept - words) / 2;
+        if (wide || decode_groups(ctx->decode_table, block + words, pairs, output + out_idx + words / 2) != pairs) break;
+        out_idx += kept / 2;
+        i += taken;
+    }
+
+    size_t tail;
+    const base16_error_t error = decode_chars(ctx, input + i, 1, input_length - i, output + out_idx, &tail);
+    if (error == BASE16_SUCCESS) *output_length = out_idx + tail;
+    return error;
+}
+
+// Bulk kernel: 1 byte -> 2 characters per group
+static void encode_groups(const char *alphabet, const uint8_t *input, const size_t groups, char *output) {
+    for (size_t g = 0; g < groups; g++) {
+        output[2 * g] = alphabet[input[g] >> 4];
+        output[2 * g + 1] = alphabet[input[g] & 0x0F];
+    }
+}
+
+// Bulk kernel: 2 characters -> 1 byte per group, stopping at a non-hex character
+static size_t decode_groups(const uint8_t *table, const char *input, const size_t groups, uint8_t *output) {
+    const uint8_t *p = (const uint8_t *) input;
+    for (size_t g = 0; g < groups; g++) {
+        const uint8_t high = table[p[2 * g]], low = table[p[2 * g + 1]];
+        if ((high | low) & 0xC0) return g;
+        output[g] = (uint8_t) (high << 4 | low);
+    }
+    return groups;
+}
+
+static base16_error_t to_error(const bek_error_t error) {
+    switch (error) {
+        case BEK_SUCCESS: return BASE16_SUCCESS;
+        case BEK_ERROR_INVALID_INPUT: return BASE16_ERROR_INVALID_INPUT;
+        case BEK_ERROR_INVALID_LENGTH: return BASE16_ERROR_INVALID_LENGTH;
+        case BEK_ERROR_BUFFER_TOO_SMALL: return BASE16_ERROR_BUFFER_TOO_SMALL;
+        case BEK_ERROR_NULL_POINTER: return BASE16_ERROR_NULL_POINTER;
+        case BEK_ERROR_PADDING: return BASE16_ERROR_INVALID_INPUT;
+        case BEK_ERROR_CALLBACK: return BASE16_ERROR_CALLBACK;
+        default: return BASE16_ERROR_MEMORY;
+    }
+}
+
+base16_error_t base16_encode_update(const base16_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const uint8_t *input,
+                                    const size_t input_length,
+                                    size_t *input_consumed,
+                                    char *output,
+                                    const size_t output_size,
+                                    size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (input == NULL && input_length > 0) || input_consumed == NULL ||
+        (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_update(&ctx->desc, stream, input, input_length, input_consumed,
+                                      output, output_size, output_length));
+}
+
+base16_error_t base16_encode_final(const base16_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   char *output,
+                                   const size_t output_size,
+                                   size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_final(&ctx->desc, stream, output, output_size, output_length));
+}
+
+base16_error_t base16_decode_update(const base16_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const char *input,
+                                    const size_t input_length,
+                                    size_t *input_consumed,
+                                    uint8_t *output,
+                                    const size_t output_size,
+                                    size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (input == NULL && input_length > 0) || input_consumed == NULL ||
+        (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_update(&ctx->desc, stream, input, input_length, input_consumed,
+                                      output, output_size, output_length));
+}
+
+base16_error_t base16_decode_final(const base16_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   uint8_t *output,
+                                   const size_t output_size,
+                                   size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_final(&ctx->desc, stream, output, output_size, output_length));
+}
+
+base16_error_t base16_encode_iov(const base16_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 const int input_count,
+                                 const struct iovec *output,
+                                 const int output_count,
+                                 size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_iov(&ctx->desc, input, input_count, output, output_count, output_length));
+}
+
+base16_error_t base16_decode_iov(const base16_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 const int input_count,
+                                 const struct iovec *output,
+                                 const int output_count,
+                                 size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_iov(&ctx->desc, input, input_count, output, output_count, output_length));
+}
+
+base16_error_t base16_encode_to_sink(const base16_ctx_t *ctx,
+                                     const uint8_t *input,
+                                     const size_t input_length,
+                                     const bek_sink_fn sink,
+                                     void *user_data) {
+    if (ctx == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_to_sink(&ctx->desc, input, input_length, sink, user_data));
+}
+
+base16_error_t base16_decode_to_sink(const base16_ctx_t *ctx,
+                                     const char *input,
+                                     const size_t input_length,
+                                     const bek_sink_fn sink,
+                                     void *user_data) {
+    if (ctx == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_to_sink(&ctx->desc, input, input_length, sink, user_data));
+}
+
+base16_error_t base16_encode_ring(const base16_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_ring(&ctx->desc, input, output, output_length));
+}
+
+base16_error_t base16_decode_ring(const base16_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_ring(&ctx->desc, input, output, output_length));
+}
+
+base16_error_t base16_encode_to_buf(const base16_ctx_t *ctx,
+                                    const uint8_t *input,
+                                    const size_t input_length,
+                                    bek_buf_t *buf) {
+    if (ctx == NULL || buf == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+
+    // One byte more than the encoder may need, so the text always ends in
+    // '\0' even when the context omits the terminator
+    size_t size;
+    const base16_error_t size_check = base16_get_encode_size(input_length, ctx, &size);
+    if (size_check != BASE16_SUCCESS) return size_check;
+    if (bek_buf_reserve(buf, size + 1) != BEK_SUCCESS) {
+        return BASE16_ERROR_MEMORY;
+    }
+
+    size_t length;
+    const base16_error_t error = base16_encode(ctx, input, input_length, (char *) buf->data + buf->length,
+                                               buf->capacity - buf->length, &length);
+    if (error == BASE16_SUCCESS) {
+        buf->length += length;
+        buf->data[buf->length] = '\0';
+    }
+    return error;
+}
+
+base16_error_t base16_decode_to_buf(const base16_ctx_t *ctx,
+                                    const char *input,
+                                    const size_t input_length,
+                                    bek_buf_t *buf) {
+    if (ctx == NULL || buf == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+
+    size_t size;
+    const base16_error_t size_check = base16_get_decode_size(input_length, ctx, &size);
+    if (size_check != BASE16_SUCCESS) return size_check;
+    if (bek_buf_reserve(buf, size) != BEK_SUCCESS) {
+        return BASE16_ERROR_MEMORY;
+    }
+
+    size_t length;
+    const base16_error_t error = base16_decode(ctx, input, input_length, buf->data + buf->length,
+                                               buf->capacity - buf->length, &length);
+    if (error == BASE16_SUCCESS) buf->length += length;
+    return error;
+}
+
+const bek_codec_desc_t *base16_desc(const base16_ctx_t *ctx) {
+    return &ctx->desc;
+}
+
+// Integer conversions. Eight digits are handled per 64-bit word: formatting
+// spreads the nibbles of a 32-bit value into bytes and turns all of them into
+// characters with a few adds; parsing validates and converts eight characters
+// at once, then gathers the nibbles back together.
+
+// Spread the 8 nibbles of a 32-bit value into the 8 bytes of a word, most
+// significant nibble in the most significant byte
+static uint64_t spread_nibbles(const uint32_t value) {
+    uint64_t x = value;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return x;
+}
+
+// Turn a word of nibble bytes into big-endian hex digits
+static void store_digits(const uint32_t value, char *output, const int uppercase) {
+    const uint64_t nibbles = spread_nibbles(value);
+    // 0x01 in every byte whose nibble is 10 or more
+    const uint64_t letters = ((nibbles + 6 * SWAR_ONES) >> 4) & SWAR_ONES;
+    const uint64_t gap = uppercase ? 'A' - '9' - 1 : 'a' - '9' - 1;
+    store_be64((uint8_t *) output, nibbles + '0' * SWAR_ONES + letters * gap);
+}
+
+// Convert eight big-endian hex characters; returns 0 if any is not a digit
+static int parse_word(const uint64_t chars, uint32_t *value) {
+    uint64_t values;
+    if (swar_hex_classify(chars, &values) != 0) {
+        return 0;
+    }
+    *value = swar_pack4(values);
+    return 1;
+}
+
+// Parse 1-8 digits, right-aligned behind implicit '0' characters
+static int parse_digits(const char *input, const size_t length, uint32_t *value) {
+    if (length == 8) {
+        return parse_word(load_be64((const uint8_t *) input), value);
+    }
+    uint64_t chars = '0' * SWAR_ONES;
+    for (size_t i = 0; i < length; i++) {
+        chars = (chars << 8) | (uint8_t) input[i];
+    }
+    return parse_word(chars, value);
+}
+
+// Number of significant hex digits in a 64-bit value, at least 1
+static size_t digit_count(uint64_t value) {
+    size_t count = 1;
+    if (value >> 32) {
+        count += 8;
+        value >>= 32;
+    }
+    if (value >> 16) {
+        count += 4;
+        value >>= 16;
+    }
+    if (value >> 8) {
+        count += 2;
+        value >>= 8;
+    }
+    if (value >> 4) {
+        count += 1;
+    }
+    return count;
+}
+
+void base16_format_u32(const uint32_t value, char output[8], const int uppercase) {
+    store_digits(value, output, uppercase);
+}
+
+void base16_format_u64(const uint64_t value, char output[16], const int uppercase) {
+    store_digits((uint32_t) (value >> 32), output, uppercase);
+    store_digits((uint32_t) value, output + 8, uppercase);
+}
+
+void base16_format_u128(const uint64_t high, const uint64_t low, char output[32], const int uppercase) {
+    base16_format_u64(high, output, uppercase);
+    base16_format_u64(low, output + 16, uppercase);
+}
+
+size_t base16_format_u32_min(const uint32_t value, char *output, const int uppercase) {
+    char digits[8];
+    const size_t count = digit_count(value);
+    store_digits(value, digits, uppercase);
+    memcpy(output, digits + 8 - count, count);
+    return count;
+}
+
+size_t base16_format_u64_min(const uint64_t value, char *output, const int uppercase) {
+    char digits[16];
+    const size_t count = digit_count(value);
+    base16_format_u64(value, digits, uppercase);
+    memcpy(output, digits + 16 - count, count);
+    return count;
+}
+
+size_t base16_format_u128_min(const uint64_t high, const uint64_t low, char *output, const int uppercase) {
+    if (high == 0) {
+        return base16_format_u64_min(low, output, uppercase);
+    }
+    const size_t count = base16_format_u64_min(high, output, uppercase);
+    base16_format_u64(low, output + count, uppercase);
+    return count + 16;
+}
+
+base16_error_t base16_parse_u32(const char *input, const size_t length, uint32_t *value) {
+    if (input == NULL || value == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    if (length == 0 || length > 8) {
+        return BASE16_ERROR_INVALID_LENGTH;
+    }
+    uint32_t result;
+    if (!parse_digits(input, length, &result)) {
+        return BASE16_ERROR_INVALID_INPUT;
+    }
+    *value = result;
+    return BASE16_SUCCESS;
+}
+
+base16_error_t base16_parse_u64(const char *input, const size_t length, uint64_t *value) {
+    if (input == NULL || value == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    if (length == 0 || length > 16) {
+        return BASE16_ERROR_INVALID_LENGTH;
+    }
+    // The first word takes whatever does not fill the second one completely
+    const size_t head = length > 8 ? length - 8 : 0;
+    uint32_t upper = 0, lower;
+    if ((head > 0 && !parse_digits(input, head, &upper)) ||
+        !parse_digits(input + head, length - head, &lower)) {
+        return BASE16_ERROR_INVALID_INPUT;
+    }
+    *value = ((uint64_t) upper << 32) | lower;
+    return BASE16_SUCCESS;
+}
+
+base16_error_t base16_parse_u128(const char *input, const size_t length, uint64_t *high, uint64_t *low) {
+    if (input == NULL || high == NULL || low == NULL) {
+        return BASE16_ERROR_NULL_POINTER;
+    }
+    if (length == 0 || length > 32) {
+        return BASE16_ERROR_INVALID_LENGTH;
+    }
+    const size_t head = length > 16 ? length - 16 : 0;
+    uint64_t upper = 0, lower;
+    base16_error_t result;
+    if (head > 0 && (result = base16_parse_u64(input, head, &upper)) != BASE16_SUCCESS) {
+        return result;
+    }
+    if ((result = base16_parse_u64(input + head, length - head, &lower)) != BASE16_SUCCESS) {
+        return result;
+    }
+    *high = upper;
+    *low = lower;
+    return BASE16_SUCCESS;
 }
@@ -3,22 +3,31 @@
 #include <string.h>
 #include "base32.h"
 
-// Standard base32 and base32hex alphabets
-static const char BASE32_STANDARD_ALPHABET[] =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
-static const char BASE32_HEX_ALPHABET[] =
-        "0123456789ABCDEFGHIJKLMNOPQRSTUV";
+#include "alloc.h"
+#include "bytes.h"
+#include "codec.h"
+#include "stream.h"
+#include "swar.h"
+#include "tables.h"
 
 // Internal context structure
 struct base32_ctx_t {
-    char alphabet[32];
+    const char *alphabet;        // Shared read-only alphabet of the variant
+    const uint8_t *decode_table; // Shared read-only reverse table of the variant
     int use_padding;
     int use_hex;
     int line_length;
     char line_ending[3];
-    int current_line_length;
+    int omit_terminator;
+    bek_codec_desc_t desc;     // Configuration as seen by the streaming engine
+    bek_allocator_t allocator; // Allocator the context was allocated with
 };
 
+static void encode_groups(const char *alphabet, const uint8_t *input, size_t groups, char *output);
+static size_t decode_groups(const uint8_t *table, const char *input, size_t groups, uint8_t *output);
+static size_t decode_groups_standard(const uint8_t *table, const char *input, size_t groups, uint8_t *output);
+static size_t decode_groups_hex(const uint8_t *table, const char *input, size_t groups, uint8_t *output);
+
 // Default configuration
 static const base32_config_t DEFAULT_CONFIG = {
     .use_padding = 1,
@@ -32,26 +41,43 @@ base32_error_t base32_init(base32_ctx_t **ctx, const base32_config_t *config) {
         return BASE32_ERROR_NULL_POINTER;
     }
 
+    // Use default config if not provided
+    const base32_config_t *effective_config = config ? config : &DEFAULT_CONFIG;
+
     // Allocate context
-    *ctx = malloc(sizeof(base32_ctx_t));
+    const bek_allocator_t allocator = bek_allocator(effective_config->allocator);
+    *ctx = bek_alloc(&allocator, sizeof(base32_ctx_t));
     if (*ctx == NULL) {
         return BASE32_ERROR_MEMORY;
     }
+    (*ctx)->allocator = allocator;
 
-    // Use default config if not provided
-    const base32_config_t *effective_config = config ? config : &DEFAULT_CONFIG;
-
-    // Set alphabet based on config
-    memcpy((*ctx)->alphabet,
-           effective_config->use_hex ? BASE32_HEX_ALPHABET : BASE32_STANDARD_ALPHABET,
-           32);
+    // Point at the prebuilt tables of the selected variant
+    (*ctx)->alphabet = effective_config->use_hex ? bek_base32_hex_alphabet : bek_base32_standard_alphabet;
+    (*ctx)->decode_table = effective_config->use_hex ? bek_base32_hex_decode : bek_base32_standard_decode;
 
     // Copy configuration
     (*ctx)->use_padding = effective_config->use_padding;
     (*ctx)->use_hex = effective_config->use_hex;
     (*ctx)->line_length = effective_config->line_length;
-    (*ctx)->current_line_length = 0;
+    (*ctx)->omit_terminator = effective_config->omit_terminator;
     strncpy((*ctx)->line_ending, effective_config->line_ending, sizeof((*ctx)->line_ending) - 1);
+    (*ctx)->line_ending[sizeof((*ctx)->line_ending) - 1] = '\0';
+
+    // Describe the configuration for the streaming engine
+    (*ctx)->desc = (bek_codec_desc_t){
+        .alphabet = (*ctx)->alphabet,
+        .decode_table = (*ctx)->decode_table,
+        .bits_per_char = 5,
+        .group_bytes = 5,
+        .group_chars = 8,
+        .use_padding = (*ctx)->use_padding,
+        .line_length = (*ctx)->line_length > 0 ? (size_t) (*ctx)->line_length : 0,
+        .line_ending = (*ctx)->line_ending,
+        .stores = effective_config->stores,
+        .encode_groups = encode_groups,
+        .decode_groups = (*ctx)->use_hex ? decode_groups_hex : decode_groups_standard
+    };
 
     return BASE32_SUCCESS;
 }
@@ -64,7 +90,9 @@ base32_error_t base32_get_encode_size(size_t input_length,
     }
 
     // Calculate base32 encoded size
-    size_t base_size = 8 * ((input_length + 4) / 5);
+    size_t base_size = ctx->use_padding
+                           ? 8 * ((input_length + 4) / 5)
+                           : 8 * (input_length / 5) + (input_length % 5 * 8 + 4) / 5;
 
     // Add line breaks if needed
     if (ctx->line_length > 0) {
@@ -72,7 +100,7 @@ base32_error_t base32_get_encode_size(size_t input_length,
         base_size += line_breaks;
     }
 
-    *output_size = base_size + 1; // +1 for null terminator
+    *output_size = base_size + (ctx->omit_terminator ? 0 : 1); // +1 for null terminator
     return BASE32_SUCCESS;
 }
 
@@ -88,6 +116,18 @@ base32_error_t base32_get_decode_size(size_t input_length,
     return BASE32_SUCCESS;
 }
 
+// Helper function to write one character, wrapping lines as configured
+static inline void put_char(const base32_ctx_t *ctx, char *output, size_t *output_index,
+                            size_t *column, const char c) {
+    output[(*output_index)++] = c;
+    if (ctx->line_length > 0 && ++*column == (size_t) ctx->line_length) {
+        for (const char *e = ctx->line_ending; *e != '\0'; e++) {
+            output[(*output_index)++] = *e;
+        }
+        *column = 0;
+    }
+}
+
 base32_error_t base32_encode(const base32_ctx_t *ctx,
                              const uint8_t *input,
                              const size_t input_length,
@@ -106,9 +146,19 @@ base32_error_t base32_encode(const base32_ctx_t *ctx,
         return BASE32_ERROR_BUFFER_TOO_SMALL;
     }
 
+    // Output asked to bypass the cache goes through the engine
+    if (bek_use_nontemporal(&ctx->desc)) {
+        size_t length;
+        bek_encode_nontemporal(&ctx->desc, input, input_length, output, output_size, &length);
+        if (!ctx->omit_terminator) output[length] = '\0';
+        *output_length = length;
+        return BASE32_SUCCESS;
+    }
+
     size_t bits = 0;
     uint32_t buffer = 0;
     size_t output_index = 0;
+    size_t column = 0;
 
     for (size_t i = 0; i < input_length; ++i) {
         buffer <<= 8;
@@ -116,7 +166,7 @@ base32_error_t base32_encode(const base32_ctx_t *ctx,
         bits += 8;
 
         while (bits >= 5) {
-            output[output_index++] = ctx->alphabet[(buffer >> (bits - 5)) & 0x1f];
+            put_char(ctx, output, &output_index, &column, ctx->alphabet[(buffer >> (bits - 5)) & 0x1f]);
             buffer &= ~(0x1f << (bits - 5));
             bits -= 5;
         }
@@ -125,30 +175,40 @@ base32_error_t base32_encode(const base32_ctx_t *ctx,
     // Handle padding for the last few bytes
     if (input_length % 5 == 1) {
         buffer <<= 2;
-        output[output_index++] = ctx->alphabet[buffer & 0x1f];
+        put_char(ctx, output, &output_index, &column, ctx->alphabet[buffer & 0x1f]);
         if (ctx->use_padding) {
-            output[output_index++] = '='; output[output_index++] = '='; output[output_index++] = '='; output[output_index++] = '='; output[output_index++] = '='; output[output_index++] = '=';
+            put_char(ctx, output, &output_index, &column, '=');
+            put_char(ctx, output, &output_index, &column, '=');
+            put_char(ctx, output, &output_index, &column, '=');
+            put_char(ctx, output, &output_index, &column, '=');
+            put_char(ctx, output, &output_index, &column, '=');
+            put_char(ctx, output, &output_index, &column, '=');
         }
     } else if (input_length % 5 == 2) {
         buffer <<= 4;
-        output[output_index++] = ctx->alphabet[buffer & 0x1f];
+        put_char(ctx, output, &output_index, &column, ctx->alphabet[buffer & 0x1f]);
         if (ctx->use_padding) {
-            output[output_index++] = '='; output[output_index++] = '='; output[output_index++] = '='; output[output_index++] = '=';
+            put_char(ctx, output, &output_index, &column, '=');
+            put_char(ctx, output, &output_index, &column, '=');
+            put_char(ctx, output, &output_index, &column, '=');
+            put_char(ctx, output, &output_index, &column, '=');
         }
     } else if (input_length % 5 == 3) {
         buffer <<= 1;
-        output[output_index++] = ctx->alphabet[buffer & 0x1f];
+        put_char(ctx, output, &output_index, &column, ctx->alphabet[buffer & 0x1f]);
         if (ctx->use_padding) {
-            output[output_index++] = '='; output[output_index++] = '='; output[output_index++] = '=';
+            put_char(ctx, output, &output_index, &column, '=');
+            put_char(ctx, output, &output_index, &column, '=');
+            put_char(ctx, output, &output_index, &column, '=');
         }
     } else if (input_length % 5 == 4) {
         buffer <<= 3;
-        output[output_index++] = ctx->alphabet[buffer & 0x1f];
+        put_char(ctx, output, &output_index, &column, ctx->alphabet[buffer & 0x1f]);
         if (ctx->use_padding) {
-            output[output_index++] = '=';
+            put_char(ctx, output, &output_index, &column, '=');
         }
     }
-    output[output_index] = '\0';
+    if (!ctx->omit_terminator) output[output_index] = '\0';
     *output_length = output_index;
 
     return BASE32_SUCCESS;
@@ -178,25 +238,36 @@ base32_error_t base32_decode(const base32_ctx_t *ctx,
     size_t bits = 0;
 
     for (size_t i = 0; i < input_length; i++) {
-        const uint8_t datum = input[i];
-        uint32_t group = 0;
+        // Whole groups at a time while the bit buffer is empty
+        uint64_t values;
+        while (BEK_SWAR && bits == 0 && i + 8 <= input_length &&
+               swar_base32_classify(load_be64((const uint8_t *) input + i), ctx->use_hex, &values) == 0) {
+            const uint64_t group = swar_pack5(values);
+            store_be32(output + output_len, (uint32_t) (group >> 8));
+            output[output_len + 4] = (uint8_t) group;
+            output_len += 5;
+            i += 8;
+        }
+        if (i >= input_length) break;
 
-        // Look up the decoding table for the current byte (datum)
-        if (datum < 256) {
-            group = ctx->alphabet[datum];
+        const uint8_t value = ctx->decode_table[(uint8_t) input[i]];
+
+        // Skip whitespace and stop at padding
+        if (value == BEK_CLASS_SPACE) continue;
+        if (value == BEK_CLASS_PAD) break;
+        if (value >= 32) {
+            return BASE32_ERROR_INVALID_INPUT;
         }
+
         // Shift the buffer by 5 bits and add the new group
-        buffer <<= 5;
+        buffer = (buffer << 5) | value;
         bits += 5;
-        buffer += group;
 
         // If we have accumulated at least 8 bits, extract the byte
         if (bits >= 8) {
-            if (datum != '=') {
-                output[output_len++] = (char)(buffer >> (bits - 8));
-            }
-            buffer &= ~(0xff << (bits - 8));  // Clear the extracted byte
             bits -= 8;
+            output[output_len++] = (uint8_t) (buffer >> bits);
+            buffer &= (1u << bits) - 1;  // Clear the extracted byte
         }
     }
 
@@ -206,6 +277,208 @@ base32_error_t base32_decode(const base32_ctx_t *ctx,
     return BASE32_SUCCESS;
 }
 
+base32_error_t base32_encode_slop(const base32_ctx_t *ctx,
+                                  const uint8_t *input,
+                                  const size_t input_length,
+                                  char *output,
+                                  const size_t output_size,
+                                  size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+
+    if (ctx->line_length > 0) {
+        return base32_encode(ctx, input, input_length, output, output_size, output_length);
+    }
+
+    size_t required_size;
+    const base32_error_t size_check = base32_get_encode_size(input_length, ctx, &required_size);
+    if (size_check != BASE32_SUCCESS) return size_check;
+
+    if (output_size < required_size) {
+        return BASE32_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    const char *alphabet = ctx->alphabet;
+    size_t i = 0;
+    size_t output_index = 0;
+
+    // 5 input bytes -> 8 characters per step, loading a full 8-byte word
+    for (; i + 5 <= input_length; i += 5, output_index += 8) {
+        const uint64_t w = load_be64(input + i);
+        char *o = output + output_index;
+        o[0] = alphabet[(w >> 59) & 0x1f];
+        o[1] = alphabet[(w >> 54) & 0x1f];
+        o[2] = alphabet[(w >> 49) & 0x1f];
+        o[3] = alphabet[(w >> 44) & 0x1f];
+        o[4] = alphabet[(w >> 39) & 0x1f];
+        o[5] = alphabet[(w >> 34) & 0x1f];
+        o[6] = alphabet[(w >> 29) & 0x1f];
+        o[7] = alphabet[(w >> 24) & 0x1f];
+    }
+
+    // Tail: run one more full step over the masked word and keep what is valid
+    const size_t remaining = input_length - i;
+    const uint64_t w = load_be64(input + i) & be64_prefix_mask(remaining);
+    char *o = output + output_index;
+    o[0] = alphabet[(w >> 59) & 0x1f];
+    o[1] = alphabet[(w >> 54) & 0x1f];
+    o[2] = alphabet[(w >> 49) & 0x1f];
+    o[3] = alphabet[(w >> 44) & 0x1f];
+    o[4] = alphabet[(w >> 39) & 0x1f];
+    o[5] = alphabet[(w >> 34) & 0x1f];
+    o[6] = alphabet[(w >> 29) & 0x1f];
+    o[7] = alphabet[(w >> 24) & 0x1f];
+
+    const size_t chars = (remaining * 8 + 4) / 5;
+    memset(output + output_index + chars, '=', 6);
+    output_index += ctx->use_padding && remaining ? 8 : chars;
+
+    if (!ctx->omit_terminator) output[output_index] = '\0';
+    *output_length = output_index;
+
+    return BASE32_SUCCESS;
+}
+
+// Decode 8 characters into a 40-bit group; lanes outside lane_mask count as 'A'.
+// Returns non-zero if any kept lane is not in the alphabet.
+static inline uint64_t decode_word(const uint8_t *table, const int hex, const char *input,
+                                   const uint64_t lane_mask, uint64_t *bits) {
+    if (BEK_SWAR) {
+        const uint64_t chars = (load_be64((const uint8_t *) input) & lane_mask) | ('A' * SWAR_ONES & ~lane_mask);
+        uint64_t values;
+        const uint64_t invalid = swar_base32_classify(chars, hex, &values);
+        *bits = swar_pack5(values & lane_mask) << 24;
+        return invalid;
+    }
+
+    const uint8_t *p = (const uint8_t *) input;
+    const uint64_t d = ((uint64_t) table[p[0]] << 56) | ((uint64_t) table[p[1]] << 48) |
+                       ((uint64_t) table[p[2]] << 40) | ((uint64_t) table[p[3]] << 32) |
+                       ((uint64_t) table[p[4]] << 24) | ((uint64_t) table[p[5]] << 16) |
+                       ((uint64_t) table[p[6]] << 8) | (uint64_t) table[p[7]];
+    const uint64_t v = d & lane_mask;
+
+    *bits = ((v >> 56) & 0x1f) << 59 | ((v >> 48) & 0x1f) << 54 |
+            ((v >> 40) & 0x1f) << 49 | ((v >> 32) & 0x1f) << 44 |
+            ((v >> 24) & 0x1f) << 39 | ((v >> 16) & 0x1f) << 34 |
+            ((v >> 8) & 0x1f) << 29 | (v & 0x1f) << 24;
+    return v & 0x8080808080808080ULL;
+}
+
+base32_error_t base32_decode_slop(const base32_ctx_t *ctx,
+                                  const char *input,
+                                  size_t input_length,
+                                  uint8_t *output,
+                                  const size_t output_size,
+                                  size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+
+    // Strip up to six padding characters
+    for (int pad = 0; pad < 6 && input_length > 0 && input[input_length - 1] == '='; pad++) {
+        input_length--;
+    }
+
+    const size_t tail = input_length % 8;
+    if (tail == 1 || tail == 3 || tail == 6) {
+        return BASE32_ERROR_INVALID_LENGTH;
+    }
+
+    const size_t decoded_length = input_length / 8 * 5 + tail * 5 / 8;
+    if (output_size < decoded_length) {
+        return BASE32_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    const uint8_t *table = ctx->decode_table;
+    uint64_t invalid = 0;
+    uint64_t bits;
+    size_t i = 0;
+    size_t out_idx = 0;
+
+    // 8 characters -> 5 bytes per step, storing a full 8-byte word
+    for (; i + 8 <= input_length; i += 8, out_idx += 5) {
+        invalid |= decode_word(table, ctx->use_hex, input + i, UINT64_MAX, &bits);
+        store_be64(output + out_idx, bits);
+    }
+
+    // Tail: lanes past the end are masked out rather than branched around
+    invalid |= decode_word(table, ctx->use_hex, input + i, be64_prefix_mask(tail), &bits);
+    store_be64(output + out_idx, bits);
+
+    if (invalid) {
+        return BASE32_ERROR_INVALID_INPUT;
+    }
+
+    *output_length = decoded_length;
+    return BASE32_SUCCESS;
+}
+
+// Bytes carried by a final quantum of n characters; 0 marks impossible lengths
+static const uint8_t PARTIAL_BYTES[8] = {0, 0, 1, 0, 2, 3, 0, 4};
+
+base32_error_t base32_decode_strict(const base32_ctx_t *ctx,
+                                    const char *input,
+                                    const size_t input_length,
+                                    uint8_t *output,
+                                    const size_t output_size,
+                                    size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+
+    // Padding must be exactly what the encoder writes for this configuration
+    size_t pads = 0;
+    while (pads < input_length && input[input_length - 1 - pads] == '=') pads++;
+    const size_t length = input_length - pads;
+    const size_t partial = length % 8;
+    if (partial > 0 && PARTIAL_BYTES[partial] == 0) {
+        return BASE32_ERROR_INVALID_LENGTH;
+    }
+    if (pads != (ctx->use_padding && partial > 0 ? 8 - partial : 0)) {
+        return BASE32_ERROR_PADDING;
+    }
+
+    const size_t groups = length / 8;
+    const size_t decoded_length = groups * 5 + PARTIAL_BYTES[partial];
+    if (output_size < decoded_length) {
+        return BASE32_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    if (ctx->desc.decode_groups(ctx->decode_table, input, groups, output) != groups) {
+        return BASE32_ERROR_INVALID_INPUT;
+    }
+
+    // The final quantum's last character has 2, 4, 1 or 3 bits left over,
+    // which must be zero
+    if (partial > 0) {
+        const uint8_t *p = (const uint8_t *) input + groups * 8;
+        uint64_t n = 0;
+        uint8_t invalid = 0;
+        for (size_t k = 0; k < partial; k++) {
+            const uint8_t v = ctx->decode_table[p[k]];
+            invalid |= v;
+            n = n << 5 | (v & 0x1f);
+        }
+        if (invalid & 0xE0) {
+            return BASE32_ERROR_INVALID_INPUT;
+        }
+        const size_t bytes = PARTIAL_BYTES[partial];
+        const unsigned unused = (unsigned) (5 * partial - 8 * bytes);
+        if (n & ((1u << unused) - 1)) {
+            return BASE32_ERROR_PADDING;
+        }
+        n >>= unused;
+        for (size_t k = 0; k < bytes; k++) {
+            output[groups * 5 + k] = (uint8_t) (n >> (8 * (bytes - 1 - k)));
+        }
+    }
+
+    *output_length = decoded_length;
+    return BASE32_SUCCESS;
+}
+
 const char *base32_error_string(base32_error_t error) {
     switch (error) {
         case BASE32_SUCCESS: return "Success";
@@ -215,12 +488,256 @@ const char *base32_error_string(base32_error_t error) {
         case BASE32_ERROR_NULL_POINTER: return "Null pointer";
         case BASE32_ERROR_PADDING: return "Invalid padding";
         case BASE32_ERROR_MEMORY: return "Memory allocation failed";
+        case BASE32_ERROR_CALLBACK: return "Output callback aborted";
         default: return "Unknown error";
     }
 }
 
 void base32_free(base32_ctx_t *ctx) {
     if (ctx != NULL) {
-        free(ctx);
+        const bek_allocator_t allocator = ctx->allocator;
+        bek_free(&allocator, ctx, sizeof(base32_ctx_t));
     }
 }
+
+// Bulk kernel: 5 bytes -> 8 characters per group
+static void encode_groups(const char *alphabet, const uint8_t *input, const size_t groups, char *output) {
+    for (size_t g = 0; g < groups; g++, input += 5, output += 8) {
+        const uint64_t n = (uint64_t) input[0] << 32 | (uint64_t) input[1] << 24 |
+                           (uint64_t) input[2] << 16 | (uint64_t) input[3] << 8 | input[4];
+        for (int k = 0; k < 8; k++) {
+            output[k] = alphabet[(n >> (35 - 5 * k)) & 0x1f];
+        }
+    }
+}
+
+// Bulk kernel: 8 characters -> 5 bytes per group, stopping at a non-alphabet character
+static size_t decode_groups(const uint8_t *table, const char *input, const size_t groups, uint8_t *output) {
+    const uint8_t *p = (const uint8_t *) input;
+    for (size_t g = 0; g < groups; g++, p += 8, output += 5) {
+        uint64_t n = 0;
+        uint8_t invalid = 0;
+        for (int k = 0; k < 8; k++) {
+            const uint8_t v = table[p[k]];
+            invalid |= v;
+            n = n << 5 | (v & 0x1f);
+        }
+        if (invalid & 0xC0) return g;
+
+        output[0] = (uint8_t) (n >> 32);
+        output[1] = (uint8_t) (n >> 24);
+        output[2] = (uint8_t) (n >> 16);
+        output[3] = (uint8_t) (n >> 8);
+        output[4] = (uint8_t) n;
+    }
+    return groups;
+}
+
+// 8 characters -> 5 bytes per step; a group with a non-alphabet character falls
+// through to the byte loop, which reports where decoding stopped
+static inline size_t decode_groups_swar(const uint8_t *table, const int hex, const char *input,
+                                        const size_t groups, uint8_t *output) {
+    const uint8_t *p = (const uint8_t *) input;
+    size_t g = 0;
+    uint64_t values;
+    for (; BEK_SWAR && g < groups && swar_base32_classify(load_be64(p + 8 * g), hex, &values) == 0; g++) {
+        const uint64_t group = swar_pack5(values);
+        store_be32(output + 5 * g, (uint32_t) (group >> 8));
+        output[5 * g + 4] = (uint8_t) group;
+    }
+    return g + decode_groups(table, input + 8 * g, groups - g, output + 5 * g);
+}
+
+static size_t decode_groups_standard(const uint8_t *table, const char *input, const size_t groups, uint8_t *output) {
+    return decode_groups_swar(table, 0, input, groups, output);
+}
+
+static size_t decode_groups_hex(const uint8_t *table, const char *input, const size_t groups, uint8_t *output) {
+    return decode_groups_swar(table, 1, input, groups, output);
+}
+
+static base32_error_t to_error(const bek_error_t error) {
+    switch (error) {
+        case BEK_SUCCESS: return BASE32_SUCCESS;
+        case BEK_ERROR_INVALID_INPUT: return BASE32_ERROR_INVALID_INPUT;
+        case BEK_ERROR_INVALID_LENGTH: return BASE32_ERROR_INVALID_LENGTH;
+        case BEK_ERROR_BUFFER_TOO_SMALL: return BASE32_ERROR_BUFFER_TOO_SMALL;
+        case BEK_ERROR_NULL_POINTER: return BASE32_ERROR_NULL_POINTER;
+        case BEK_ERROR_PADDING: return BASE32_ERROR_PADDING;
+        case BEK_ERROR_CALLBACK: return BASE32_ERROR_CALLBACK;
+        default: return BASE32_ERROR_MEMORY;
+    }
+}
+
+base32_error_t base32_encode_update(const base32_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const uint8_t *input,
+                                    const size_t input_length,
+                                    size_t *input_consumed,
+                                    char *output,
+                                    const size_t output_size,
+                                    size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (input == NULL && input_length > 0) || input_consumed == NULL ||
+        (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_update(&ctx->desc, stream, input, input_length, input_consumed,
+                                      output, output_size, output_length));
+}
+
+base32_error_t base32_encode_final(const base32_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   char *output,
+                                   const size_t output_size,
+                                   size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_final(&ctx->desc, stream, output, output_size, output_length));
+}
+
+base32_error_t base32_decode_update(const base32_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const char *input,
+                                    const size_t input_length,
+                                    size_t *input_consumed,
+                                    uint8_t *output,
+                                    const size_t output_size,
+                                    size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (input == NULL && input_length > 0) || input_consumed == NULL ||
+        (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_update(&ctx->desc, stream, input, input_length, input_consumed,
+                                      output, output_size, output_length));
+}
+
+base32_error_t base32_decode_final(const base32_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   uint8_t *output,
+                                   const size_t output_size,
+                                   size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_final(&ctx->desc, stream, output, output_size, output_length));
+}
+
+base32_error_t base32_encode_iov(const base32_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 const int input_count,
+                                 const struct iovec *output,
+                                 const int output_count,
+                                 size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_iov(&ctx->desc, input, input_count, output, output_count, output_length));
+}
+
+base32_error_t base32_decode_iov(const base32_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 const int input_count,
+                                 const struct iovec *output,
+                                 const int output_count,
+                                 size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_iov(&ctx->desc, input, input_count, output, output_count, output_length));
+}
+
+base32_error_t base32_encode_to_sink(const base32_ctx_t *ctx,
+                                     const uint8_t *input,
+                                     const size_t input_length,
+                                     const bek_sink_fn sink,
+                                     void *user_data) {
+    if (ctx == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_to_sink(&ctx->desc, input, input_length, sink, user_data));
+}
+
+base32_error_t base32_decode_to_sink(const base32_ctx_t *ctx,
+                                     const char *input,
+                                     const size_t input_length,
+                                     const bek_sink_fn sink,
+                                     void *user_data) {
+    if (ctx == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_to_sink(&ctx->desc, input, input_length, sink, user_data));
+}
+
+base32_error_t base32_encode_ring(const base32_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_ring(&ctx->desc, input, output, output_length));
+}
+
+base32_error_t base32_decode_ring(const base32_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_ring(&ctx->desc, input, output, output_length));
+}
+
+base32_error_t base32_encode_to_buf(const base32_ctx_t *ctx,
+                                    const uint8_t *input,
+                                    const size_t input_length,
+                                    bek_buf_t *buf) {
+    if (ctx == NULL || buf == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+
+    // One byte more than the encoder may need, so the text always ends in
+    // '\0' even when the context omits the terminator
+    size_t size;
+    const base32_error_t size_check = base32_get_encode_size(input_length, ctx, &size);
+    if (size_check != BASE32_SUCCESS) return size_check;
+    if (bek_buf_reserve(buf, size + 1) != BEK_SUCCESS) {
+        return BASE32_ERROR_MEMORY;
+    }
+
+    size_t length;
+    const base32_error_t error = base32_encode(ctx, input, input_length, (char *) buf->data + buf->length,
+                                               buf->capacity - buf->length, &length);
+    if (error == BASE32_SUCCESS) {
+        buf->length += length;
+        buf->data[buf->length] = '\0';
+    }
+    return error;
+}
+
+base32_error_t base32_decode_to_buf(const base32_ctx_t *ctx,
+                                    const char *input,
+                                    const size_t input_length,
+                                    bek_buf_t *buf) {
+    if (ctx == NULL || buf == NULL) {
+        return BASE32_ERROR_NULL_POINTER;
+    }
+
+    size_t size;
+    const base32_error_t size_check = base32_get_decode_size(input_length, ctx, &size);
+    if (size_check != BASE32_SUCCESS) return size_check;
+    if (bek_buf_reserve(buf, size) != BEK_SUCCESS) {
+        return BASE32_ERROR_MEMORY;
+    }
+
+    size_t length;
+    const base32_error_t error = base32_decode(ctx, input, input_length, buf->data + buf->length,
+                                               buf->capacity - buf->length, &length);
+    if (error == BASE32_SUCCESS) buf->length += length;
+    return error;
+}
+
+const bek_codec_desc_t *base32_desc(const base32_ctx_t *ctx) {
+    return &ctx->desc;
+}
@@ -2,22 +2,31 @@
 #include <string.h>
 #include <base64.h>
 
-// Internal base64 alphabet and constants
-static const char BASE64_STANDARD_ALPHABET[] =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-static const char BASE64_URL_ALPHABET[] =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+#include "alloc.h"
+#include "bytes.h"
+#include "codec.h"
+#include "ignore.h"
+#include "stream.h"
+#include "swar.h"
+#include "tables.h"
 
 // Internal context structure
 struct base64_ctx_t {
-    char alphabet[64];
+    const char *alphabet;        // Shared read-only alphabet of the variant
+    const uint8_t *decode_table; // Shared read-only reverse table of the variant
     int use_padding;
     int url_safe;
     int line_length;
     char line_ending[3];
-    int current_line_length;
+    int omit_terminator;
+    bek_ignore_t ignore;       // Characters base64_decode skips
+    bek_codec_desc_t desc;     // Configuration as seen by the streaming engine
+    bek_allocator_t allocator; // Allocator the context was allocated with
 };
 
+static void encode_groups(const char *alphabet, const uint8_t *input, size_t groups, char *output);
+static size_t decode_groups(const uint8_t *table, const char *input, size_t groups, uint8_t *output);
+
 // Default configuration
 static const base64_config_t DEFAULT_CONFIG = {
     .use_padding = 1,
@@ -31,26 +40,54 @@ base64_error_t base64_init(base64_ctx_t **ctx, const base64_config_t *config) {
         return BASE64_ERROR_NULL_POINTER;
     }
 
+    // Use default config if not provided
+    const base64_config_t *effective_config = config ? config : &DEFAULT_CONFIG;
+
     // Allocate context
-    *ctx = malloc(sizeof(base64_ctx_t));
+    const bek_allocator_t allocator = bek_allocator(effective_config->allocator);
+    *ctx = bek_alloc(&allocator, sizeof(base64_ctx_t));
     if (*ctx == NULL) {
         return BASE64_ERROR_MEMORY;
     }
+    (*ctx)->allocator = allocator;
 
-    // Use default config if not provided
-    const base64_config_t *effective_config = config ? config : &DEFAULT_CONFIG;
-
-    // Set alphabet based on config
-    memcpy((*ctx)->alphabet,
-           effective_config->url_safe ? BASE64_URL_ALPHABET : BASE64_STANDARD_ALPHABET,
-           64);
+    // Point at the prebuilt tables of the selected variant
+    (*ctx)->alphabet = effective_config->url_safe ? bek_base64_url_alphabet : bek_base64_standard_alphabet;
+    (*ctx)->decode_table = effective_config->url_safe ? bek_base64_url_decode : bek_base64_standard_decode;
 
     // Copy configuration
     (*ctx)->use_padding = effective_config->use_padding;
     (*ctx)->url_safe = effective_config->url_safe;
     (*ctx)->line_length = effective_config->line_length;
-    (*ctx)->current_line_length = 0;
+    (*ctx)->omit_terminator = effective_config->omit_terminator;
     strncpy((*ctx)->line_ending, effective_config->line_ending, sizeof((*ctx)->line_ending) - 1);
+    (*ctx)->line_ending[sizeof((*ctx)->line_ending) - 1] = '\0';
+
+    // Skipping a character of the alphabet or padding would change the data
+    bek_ignore_init(&(*ctx)->ignore, effective_config->ignore ? effective_config->ignore : " \r\n");
+    for (int c = 0; c < 256; c++) {
+        if (bek_ignored(&(*ctx)->ignore, (uint8_t) c) && (c == '=' || (*ctx)->decode_table[c] < 64)) {
+            bek_free(&allocator, *ctx, sizeof(base64_ctx_t));
+            *ctx = NULL;
+            return BASE64_ERROR_INVALID_INPUT;
+        }
+    }
+
+    // Describe the configuration for the streaming engine
+    (*ctx)->desc = (bek_codec_desc_t){
+        .alphabet = (*ctx)->alphabet,
+        .decode_table = (*ctx)->decode_table,
+        .ignore = &(*ctx)->ignore,
+        .bits_per_char = 6,
+        .group_bytes = 3,
+        .group_chars = 4,
+        .use_padding = (*ctx)->use_padding,
+        .line_length = (*ctx)->line_length > 0 ? (size_t) (*ctx)->line_length : 0,
+        .line_ending = (*ctx)->line_ending,
+        .stores = effective_config->stores,
+        .encode_groups = encode_groups,
+        .decode_groups = decode_groups
+    };
 
     return BASE64_SUCCESS;
 }
@@ -63,7 +100,9 @@ base64_error_t base64_get_encode_size(const size_t input_length,
     }
 
     // Calculate base64 encoded size
-    size_t base_size = 4 * ((input_length + 2) / 3);
+    size_t base_size = ctx->use_padding
+                           ? 4 * ((input_length + 2) / 3)
+                           : 4 * (input_length / 3) + (input_length % 3 * 4 + 2) / 3;
 
     // Add line breaks if needed
     if (ctx->line_length > 0) {
@@ -71,7 +110,7 @@ base64_error_t base64_get_encode_size(const size_t input_length,
         base_size += line_breaks;
     }
 
-    *output_size = base_size + 1; // +1 for null terminator
+    *output_size = base_size + (ctx->omit_terminator ? 0 : 1); // +1 for null terminator
     return BASE64_SUCCESS;
 }
 
@@ -96,22 +135,28 @@ const char *base64_error_string(const base64_error_t error) {
         case BASE64_ERROR_NULL_POINTER: return "Null pointer";
         case BASE64_ERROR_PADDING: return "Invalid padding";
         case BASE64_ERROR_MEMORY: return "Memory allocation failed";
+        case BASE64_ERROR_CALLBACK: return "Output callback aborted";
         default: return "Unknown error";
     }
 }
 
 void base64_free(base64_ctx_t *ctx) {
     if (ctx != NULL) {
-        free(ctx);
+        const bek_allocator_t allocator = ctx->allocator;
+        bek_free(&allocator, ctx, sizeof(base64_ctx_t));
     }
 }
 
-// Helper function to find index in alphabet
-static int find_alphabet_index(const char c, const char *alphabet) {
-    for (int i = 0; i < 64; i++) {
-        if (alphabet[i] == c) return i;
+// Helper function to write one character, wrapping lines as configured
+static inline void put_char(const base64_ctx_t *ctx, char *output, size_t *output_index,
+                            size_t *column, const char c) {
+    output[(*output_index)++] = c;
+    if (ctx->line_length > 0 && ++*column == (size_t) ctx->line_length) {
+        for (const char *e = ctx->line_ending; *e != '\0'; e++) {
+            output[(*output_index)++] = *e;
+        }
+        *column = 0;
     }
-    return -1;
 }
 
 base64_error_t base64_encode(const base64_ctx_t *ctx,
@@ -132,9 +177,19 @@ base64_error_t base64_encode(const base64_ctx_t *ctx,
         return BASE64_ERROR_BUFFER_TOO_SMALL;
     }
 
+    // Output asked to bypass the cache goes through the engine
+    if (bek_use_nontemporal(&ctx->desc)) {
+        size_t length;
+        bek_encode_nontemporal(&ctx->desc, input, input_length, output, output_size, &length);
+        if (!ctx->omit_terminator) output[length] = '\0';
+        *output_length = length;
+        return BASE64_SUCCESS;
+    }
+
     size_t bits = 0;
     uint32_t buffer = 0;
     size_t output_index = 0;
+    size_t column = 0;
 
     for (size_t i = 0; i < input_length; ++i) {
         buffer <<= 8;
@@ -142,7 +197,7 @@ base64_error_t base64_encode(const base64_ctx_t *ctx,
         bits += 8;
 
         while (bits >= 6) {
-            output[output_index++] = ctx->alphabet[(buffer >> (bits - 6)) & 0x3f];
+            put_char(ctx, output, &output_index, &column, ctx->alphabet[(buffer >> (bits - 6)) & 0x3f]);
             buffer &= ~(0x3f << (bits - 6));
             bits -= 6;
         }
@@ -150,62 +205,119 @@ base64_error_t base64_encode(const base64_ctx_t *ctx,
 
     if (input_length % 3 == 1) {
         buffer <<= 4;
-        output[output_index++] = ctx->alphabet[buffer & 0x3f];
+        put_char(ctx, output, &output_index, &column, ctx->alphabet[buffer & 0x3f]);
         if (ctx->use_padding) {
-            output[output_index++] = '=';
-            output[output_index++] = '=';
+            put_char(ctx, output, &output_index, &column, '=');
+            put_char(ctx, output, &output_index, &column, '=');
         }
     } else if (input_length % 3 == 2) {
         buffer <<= 2;
-        output[output_index++] = ctx->alphabet[buffer & 0x3f];
+        put_char(ctx, output, &output_index, &column, ctx->alphabet[buffer & 0x3f]);
         if (ctx->use_padding) {
-            output[output_index++] = '=';
+            put_char(ctx, output, &output_index, &column, '=');
         }
     }
-    output[output_index] = '\0';
+    if (!ctx->omit_terminator) output[output_index] = '\0';
     *output_length = output_index;
 
     return BASE64_SUCCESS;
 }
 
-base64_error_t base64_decode(base64_ctx_t *ctx,
-                             const char *input,
-                             size_t input_length,
-                             uint8_t *output,
-                             size_t output_size,
-                             size_t *output_length) {
-    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
-        return BASE64_ERROR_NULL_POINTER;
+// Longest first line probed for a wrapped layout; MIME allows 76 characters
+#define MAX_WRAP_PROBE 1024
+
+// Length of the first line if it is a whole number of quanta ended by "\n" or
+// "\r\n" and the ending is in the ignore set, 0 otherwise
+static size_t wrapped_line_length(const base64_ctx_t *ctx, const char *input, const size_t input_length,
+                                  size_t *eol_length) {
+    const char *newline = memchr(input, '\n', input_length < MAX_WRAP_PROBE ? input_length : MAX_WRAP_PROBE);
+    if (newline == NULL || !bek_ignored(&ctx->ignore, '\n')) return 0;
+
+    size_t length = (size_t) (newline - input);
+    *eol_length = 1;
+    if (length > 0 && newline[-1] == '\r') {
+        if (!bek_ignored(&ctx->ignore, '\r')) return 0;
+        length--;
+        *eol_length = 2;
     }
+    return length % 4 == 0 ? length : 0;
+}
 
-    size_t required_size;
-    base64_error_t size_check = base64_get_decode_size(input_length, ctx, &required_size);
-    if (size_check != BASE64_SUCCESS) return size_check;
+// Decode runs of eight alphabet characters, two groups each, until a word
+// holds anything else; returns the number of characters decoded
+static size_t decode_words(const base64_ctx_t *ctx, const char *input, const size_t length, uint8_t *output) {
+    size_t i = 0;
+    for (uint64_t values; BEK_SWAR && i + 8 <= length &&
+         swar_base64_classify(load_be64((const uint8_t *) input + i), ctx->url_safe, &values) == 0;
+         i += 8, output += 6) {
+        const uint64_t bits = swar_pack6(values);
+        store_be24(output, (uint32_t) (bits >> 24));
+        store_be24(output + 3, (uint32_t) bits & 0xFFFFFF);
+    }
+    return i;
+}
 
-    if (output_size < required_size) {
-        return BASE64_ERROR_BUFFER_TOO_SMALL;
+// decode_words for UTF-16 text, narrowing each word of code units as it loads
+// it; a unit above 0xFF ends the run like any other invalid character
+static size_t decode_words16(const base64_ctx_t *ctx, const uint16_t *input, const size_t length, uint8_t *output) {
+    size_t i = 0;
+    for (uint64_t chars, values; BEK_SWAR && i + 8 <= length && load_narrow_be64(input + i, &chars) <= 0xFF &&
+         swar_base64_classify(chars, ctx->url_safe, &values) == 0;
+         i += 8, output += 6) {
+        const uint64_t bits = swar_pack6(values);
+        store_be24(output, (uint32_t) (bits >> 24));
+        store_be24(output + 3, (uint32_t) bits & 0xFFFFFF);
     }
+    return i;
+}
+
+// Decode one line of whole quanta; returns 0 at the first character outside
+// the alphabet, padding included, with the line's output partly written
+static int decode_line(const base64_ctx_t *ctx, const char *input, const size_t length, uint8_t *output) {
+    const size_t words = decode_words(ctx, input, length, output);
+    const size_t groups = (length - words) / 4;
+    return decode_groups(ctx->decode_table, input + words, groups, output + words / 4 * 3) == groups;
+}
 
+// Character loop: skips the ignore set anywhere, accepts padding and partial
+// final groups, and stops at the first padded group. Reads UTF-16 code units
+// when wide is set; units above 0xFF are invalid.
+static base64_error_t decode_chars(const base64_ctx_t *ctx,
+                                   const void *input,
+                                   const int wide,
+                                   const size_t input_length,
+                                   uint8_t *output,
+                                   size_t *output_length) {
     size_t out_idx = 0;
     uint32_t n = 0;
     int group_count = 0;
 
     for (size_t i = 0; i < input_length; i++) {
+        // Two whole groups at a time while no partial group is pending
+        if (group_count == 0) {
+            const size_t run = wide ? decode_words16(ctx, (const uint16_t *) input + i, input_length - i, output + out_idx)
+                                    : decode_words(ctx, (const char *) input + i, input_length - i, output + out_idx);
+            i += run;
+            out_idx += run / 4 * 3;
+        }
+        if (i >= input_length) break;
+        const unsigned c = text_at(input, wide, i);
+
         // Skip whitespace and line breaks
-        if (input[i] == ' ' || input[i] == '\n' || input[i] == '\r')
+        if (c <= 0xFF && bek_ignored(&ctx->ignore, (uint8_t) c))
             continue;
 
         // Check for padding
-        if (input[i] == '=') {
+        if (c == '=') {
             if (group_count >= 2) break;
             n <<= 6;
             group_count++;
             continue;
         }
 
-        // Find index in alphabet
-        int index = find_alphabet_index(input[i], ctx->alphabet);
-        if (index == -1) {
+        // Look up index in alphabet
+        const uint8_t index = c <= 0xFF ? ctx->decode_table[c] : BEK_CLASS_INVALID;
+        if (index >= 64) {
             return BASE64_ERROR_INVALID_INPUT;
         }
 
@@ -236,3 +348,626 @@ base64_error_t base64_decode(base64_ctx_t *ctx,
     *output_length = out_idx;
     return BASE64_SUCCESS;
 }
+
+base64_error_t base64_decode(const base64_ctx_t *ctx,
+                             const char *input,
+                             size_t input_length,
+                             uint8_t *output,
+                             size_t output_size,
+                             size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+
+    size_t required_size;
+    base64_error_t size_check = base64_get_decode_size(input_length, ctx, &required_size);
+    if (size_check != BASE64_SUCCESS) return size_check;
+
+    if (output_size < required_size) {
+        return BASE64_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    size_t i = 0;
+    size_t out_idx = 0;
+
+    // Wrapped text (MIME, PEM): once the first line gives the layout, decode
+    // whole lines and step over their endings
+    size_t eol_length;
+    const size_t line = wrapped_line_length(ctx, input, input_length, &eol_length);
+    if (line > 0) {
+        const char *ending = input + line;
+        while (i + line + eol_length <= input_length &&
+               memcmp(input + i + line, ending, eol_length) == 0 &&
+               decode_line(ctx, input + i, line, output + out_idx)) {
+            i += line + eol_length;
+            out_idx += line / 4 * 3;
+        }
+    }
+
+    // Runs of alphabet characters decode in place. From the first word that
+    // breaks a run, a block of the input is compacted and decoded whole with
+    // the line kernel, then the next run is tried. The last quantum, which
+    // may be padded, goes to the character loop, and so does everything from
+    // a block that holds padding or invalid input.
+    char block[BEK_COMPACT_BLOCK + 8];
+    while (i < input_length) {
+        const size_t run = decode_words(ctx, input + i, input_length - i, output + out_idx);
+        i += run;
+        out_idx += run / 4 * 3;
+
+        size_t taken;
+        const size_t kept = bek_compact(&ctx->ignore, input + i, input_length - i, block, BEK_COMPACT_BLOCK, &taken);
+        const int last = i + taken == input_length;
+        const size_t whole = !last ? kept : kept > 0 ? (kept - 1) & ~(size_t) 3 : 0;
+        if (!decode_line(ctx, block, whole, output + out_idx)) break;
+        out_idx += whole / 4 * 3;
+
+        if (last) {
+            size_t tail;
+            const base64_error_t error = decode_chars(ctx, block + whole, 0, kept - whole, output + out_idx, &tail);
+            if (error == BASE64_SUCCESS) *output_length = out_idx + tail;
+            return error;
+        }
+        i += taken;
+    }
+
+    size_t tail;
+    const base64_error_t error = decode_chars(ctx, input + i, 0, input_length - i, output + out_idx, &tail);
+    if (error == BASE64_SUCCESS) *output_length = out_idx + tail;
+    return error;
+}
+
+base64_error_t base64_encode_slop(const base64_ctx_t *ctx,
+                                  const uint8_t *input,
+                                  const size_t input_length,
+                                  char *output,
+                                  const size_t output_size,
+                                  size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+
+    if (ctx->line_length > 0) {
+        return base64_encode(ctx, input, input_length, output, output_size, output_length);
+    }
+
+    size_t required_size;
+    const base64_error_t size_check = base64_get_encode_size(input_length, ctx, &required_size);
+    if (size_check != BASE64_SUCCESS) return size_check;
+
+    if (output_size < required_size) {
+        return BASE64_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    const char *alphabet = ctx->alphabet;
+    size_t i = 0;
+    size_t output_index = 0;
+
+    // 6 input bytes -> 8 characters per step, loading a full 8-byte word
+    for (; i + 6 <= input_length; i += 6, output_index += 8) {
+        const uint64_t w = load_be64(input + i);
+        char *o = output + output_index;
+        o[0] = alphabet[(w >> 58) & 0x3f];
+        o[1] = alphabet[(w >> 52) & 0x3f];
+        o[2] = alphabet[(w >> 46) & 0x3f];
+        o[3] = alphabet[(w >> 40) & 0x3f];
+        o[4] = alphabet[(w >> 34) & 0x3f];
+        o[5] = alphabet[(w >> 28) & 0x3f];
+        o[6] = alphabet[(w >> 22) & 0x3f];
+        o[7] = alphabet[(w >> 16) & 0x3f];
+    }
+
+    // Tail: run one more full step over the masked word and keep what is valid
+    const size_t remaining = input_length - i;
+    const uint64_t w = load_be64(input + i) & be64_prefix_mask(remaining);
+    char *o = output + output_index;
+    o[0] = alphabet[(w >> 58) & 0x3f];
+    o[1] = alphabet[(w >> 52) & 0x3f];
+    o[2] = alphabet[(w >> 46) & 0x3f];
+    o[3] = alphabet[(w >> 40) & 0x3f];
+    o[4] = alphabet[(w >> 34) & 0x3f];
+    o[5] = alphabet[(w >> 28) & 0x3f];
+    o[6] = alphabet[(w >> 22) & 0x3f];
+    o[7] = alphabet[(w >> 16) & 0x3f];
+
+    output_index += (remaining * 4 + 2) / 3;
+    const size_t padding = ctx->use_padding ? (3 - remaining % 3) % 3 : 0;
+    output[output_index] = '=';
+    output[output_index + 1] = '=';
+    output_index += padding;
+
+    if (!ctx->omit_terminator) output[output_index] = '\0';
+    *output_length = output_index;
+
+    return BASE64_SUCCESS;
+}
+
+// Decode 8 characters into a 48-bit group; lanes outside lane_mask count as 'A'.
+// Returns non-zero if any kept lane is not in the alphabet.
+static inline uint64_t decode_word(const uint8_t *table, const char *input,
+                                   const uint64_t lane_mask, uint64_t *bits) {
+    const uint8_t *p = (const uint8_t *) input;
+    const uint64_t d = ((uint64_t) table[p[0]] << 56) | ((uint64_t) table[p[1]] << 48) |
+                       ((uint64_t) table[p[2]] << 40) | ((uint64_t) table[p[3]] << 32) |
+                       ((uint64_t) table[p[4]] << 24) | ((uint64_t) table[p[5]] << 16) |
+                       ((uint64_t) table[p[6]] << 8) | (uint64_t) table[p[7]];
+    const uint64_t v = d & lane_mask;
+
+    *bits = ((v >> 56) & 0x3f) << 58 | ((v >> 48) & 0x3f) << 52 |
+            ((v >> 40) & 0x3f) << 46 | ((v >> 32) & 0x3f) << 40 |
+            ((v >> 24) & 0x3f) << 34 | ((v >> 16) & 0x3f) << 28 |
+            ((v >> 8) & 0x3f) << 22 | (v & 0x3f) << 16;
+    return v & 0x8080808080808080ULL;
+}
+
+base64_error_t base64_decode_slop(const base64_ctx_t *ctx,
+                                  const char *input,
+                                  size_t input_length,
+                                  uint8_t *output,
+                                  const size_t output_size,
+                                  size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+
+    // Strip up to two padding characters
+    if (input_length > 0 && input[input_length - 1] == '=') input_length--;
+    if (input_length > 0 && input[input_length - 1] == '=') input_length--;
+
+    if (input_length % 4 == 1) {
+        return BASE64_ERROR_INVALID_LENGTH;
+    }
+
+    const size_t decoded_length = input_length / 4 * 3 + (input_length % 4) * 3 / 4;
+    if (output_size < decoded_length) {
+        return BASE64_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    const uint8_t *table = ctx->decode_table;
+    uint64_t invalid = 0;
+    uint64_t bits;
+    size_t i = 0;
+    size_t out_idx = 0;
+
+    // 8 characters -> 6 bytes per step, storing a full 8-byte word
+    for (; i + 8 <= input_length; i += 8, out_idx += 6) {
+        invalid |= decode_word(table, input + i, UINT64_MAX, &bits);
+        store_be64(output + out_idx, bits);
+    }
+
+    // Tail: lanes past the end are masked out rather than branched around
+    invalid |= decode_word(table, input + i, be64_prefix_mask(input_length - i), &bits);
+    store_be64(output + out_idx, bits);
+
+    if (invalid) {
+        return BASE64_ERROR_INVALID_INPUT;
+    }
+
+    *output_length = decoded_length;
+    return BASE64_SUCCESS;
+}
+
+base64_error_t base64_decode_strict(const base64_ctx_t *ctx,
+                                    const char *input,
+                                    const size_t input_length,
+                                    uint8_t *output,
+                                    const size_t output_size,
+                                    size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+
+    // Padding must be exactly what the encoder writes for this configuration
+    size_t pads = 0;
+    while (pads < input_length && input[input_length - 1 - pads] == '=') pads++;
+    const size_t length = input_length - pads;
+    const size_t partial = length % 4;
+    if (partial == 1) {
+        return BASE64_ERROR_INVALID_LENGTH;
+    }
+    if (pads != (ctx->use_padding && partial > 0 ? 4 - partial : 0)) {
+        return BASE64_ERROR_PADDING;
+    }
+
+    const size_t whole = length - partial;
+    const size_t decoded_length = whole / 4 * 3 + (partial > 0 ? partial - 1 : 0);
+    if (output_size < decoded_length) {
+        return BASE64_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    if (!decode_line(ctx, input, whole, output)) {
+        return BASE64_ERROR_INVALID_INPUT;
+    }
+
+    // The final 2 or 3 characters carry 1 or 2 bytes; the 4 or 2 bits left
+    // over must be zero
+    if (partial > 0) {
+        const uint8_t *table = ctx->decode_table;
+        const uint8_t *p = (const uint8_t *) input + whole;
+        const uint8_t a = table[p[0]], b = table[p[1]], c = partial == 3 ? table[p[2]] : 0;
+        if ((a | b | c) & 0xC0) {
+            return BASE64_ERROR_INVALID_INPUT;
+        }
+        if (partial == 2 ? b & 0x0F : c & 0x03) {
+            return BASE64_ERROR_PADDING;
+        }
+        const uint32_t n = (uint32_t) a << 18 | (uint32_t) b << 12 | (uint32_t) c << 6;
+        uint8_t *o = output + whole / 4 * 3;
+        o[0] = (uint8_t) (n >> 16);
+        if (partial == 3) o[1] = (uint8_t) (n >> 8);
+    }
+
+    *output_length = decoded_length;
+    return BASE64_SUCCESS;
+}
+
+// put_char for UTF-16 output
+static inline void put_unit(const base64_ctx_t *ctx, uint16_t *output, size_t *output_index,
+                            size_t *column, const char c) {
+    output[(*output_index)++] = (uint8_t) c;
+    if (ctx->line_length > 0 && ++*column == (size_t) ctx->line_length) {
+        for (const char *e = ctx->line_ending; *e != '\0'; e++) {
+            output[(*output_index)++] = (uint8_t) *e;
+        }
+        *column = 0;
+    }
+}
+
+// encode_groups with each character widened to a code unit as it is stored
+static void encode_groups16(const char *alphabet, const uint8_t *input, const size_t groups, uint16_t *output) {
+    for (size_t g = 0; g < groups; g++, input += 3, output += 4) {
+        const uint32_t n = (uint32_t) input[0] << 16 | (uint32_t) input[1] << 8 | input[2];
+        output[0] = (uint8_t) alphabet[(n >> 18) & 0x3f];
+        output[1] = (uint8_t) alphabet[(n >> 12) & 0x3f];
+        output[2] = (uint8_t) alphabet[(n >> 6) & 0x3f];
+        output[3] = (uint8_t) alphabet[n & 0x3f];
+    }
+}
+
+base64_error_t base64_encode_utf16(const base64_ctx_t *ctx,
+                                   const uint8_t *input,
+                                   const size_t input_length,
+                                   uint16_t *output,
+                                   const size_t output_size,
+                                   size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+
+    size_t required_size;
+    const base64_error_t size_check = base64_get_encode_size(input_length, ctx, &required_size);
+    if (size_check != BASE64_SUCCESS) return size_check;
+
+    if (output_size < required_size) {
+        return BASE64_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    const size_t line = ctx->line_length > 0 ? (size_t) ctx->line_length : 0;
+    const size_t groups = input_length / 3;
+    size_t g = 0;
+    size_t output_index = 0;
+    size_t column = 0;
+
+    while (g < groups) {
+        // Whole groups up to the end of the line go through the kernel; a
+        // group that straddles a line break is written a unit at a time
+        size_t run = groups - g;
+        if (line > 0 && run > (line - column) / 4) run = (line - column) / 4;
+        if (run == 0) {
+            char chars[4];
+            encode_groups(ctx->alphabet, input + 3 * g, 1, chars);
+            for (int k = 0; k < 4; k++) put_unit(ctx, output, &output_index, &column, chars[k]);
+            g++;
+            continue;
+        }
+
+        encode_groups16(ctx->alphabet, input + 3 * g, run, output + output_index);
+        g += run;
+        output_index += 4 * run;
+        column += 4 * run;
+        if (column == line) {
+            for (const char *e = ctx->line_ending; *e != '\0'; e++) output[output_index++] = (uint8_t) *e;
+            column = 0;
+        }
+    }
+
+    const size_t rest = input_length - 3 * groups;
+    if (rest > 0) {
+        const uint8_t *t = input + 3 * groups;
+        const uint32_t n = (uint32_t) t[0] << 16 | (rest == 2 ? (uint32_t) t[1] << 8 : 0);
+        put_unit(ctx, output, &output_index, &column, ctx->alphabet[n >> 18]);
+        put_unit(ctx, output, &output_index, &column, ctx->alphabet[(n >> 12) & 0x3f]);
+        if (rest == 2) put_unit(ctx, output, &output_index, &column, ctx->alphabet[(n >> 6) & 0x3f]);
+        for (size_t k = rest; ctx->use_padding && k < 3; k++) put_unit(ctx, output, &output_index, &column, '=');
+    }
+
+    if (!ctx->omit_terminator) output[output_index] = 0;
+    *output_length = output_index;
+
+    return BASE64_SUCCESS;
+}
+
+base64_error_t base64_decode_utf16(const base64_ctx_t *ctx,
+                                   const uint16_t *input,
+                                   const size_t input_length,
+                                   uint8_t *output,
+                                   const size_t output_size,
+                                   size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+
+    size_t required_size;
+    const base64_error_t size_check = base64_get_decode_size(input_length, ctx, &required_size);
+    if (size_check != BASE64_SUCCESS) return size_check;
+
+    if (output_size < required_size) {
+        return BASE64_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    size_t i = 0;
+    size_t out_idx = 0;
+
+    // The loop of base64_decode with the narrowing folded into the word loads
+    // and the compaction, so the code units are read once. A block holding a
+    // unit above 0xFF goes to the character loop like one holding invalid
+    // input.
+    char block[BEK_COMPACT_BLOCK + 8];
+    while (i < input_length) {
+        const size_t run = decode_words16(ctx, input + i, input_length - i, output + out_idx);
+        i += run;
+        out_idx += run / 4 * 3;
+
+        size_t taken;
+        int wide;
+        const size_t kept = bek_compact16(&ctx->ignore, input + i, input_length - i, block, BEK_COMPACT_BLOCK,
+                                          &taken, &wide);
+        const int last = i + taken == input_length;
+        const size_t whole = !last ? kept : kept > 0 ? (kept - 1) & ~(size_t) 3 : 0;
+        if (wide || !decode_line(ctx, block, whole, output + out_idx)) break;
+        out_idx += whole / 4 * 3;
+
+        if (last) {
+            size_t tail;
+            const base64_error_t error = decode_chars(ctx, block + whole, 0, kept - whole, output + out_idx, &tail);
+            if (error == BASE64_SUCCESS) *output_length = out_idx + tail;
+            return error;
+        }
+        i += taken;
+    }
+
+    size_t tail;
+    const base64_error_t error = decode_chars(ctx, input + i, 1, input_length - i, output + out_idx, &tail);
+    if (error == BASE64_SUCCESS) *output_length = out_idx + tail;
+    return error;
+}
+
+// Bulk kernel: 3 bytes -> 4 characters per group
+static void encode_groups(const char *alphabet, const uint8_t *input, const size_t groups, char *output) {
+    for (size_t g = 0; g < groups; g++, input += 3, output += 4) {
+        const uint32_t n = (uint32_t) input[0] << 16 | (uint32_t) input[1] << 8 | input[2];
+        output[0] = alphabet[(n >> 18) & 0x3f];
+        output[1] = alphabet[(n >> 12) & 0x3f];
+        output[2] = alphabet[(n >> 6) & 0x3f];
+        output[3] = alphabet[n & 0x3f];
+    }
+}
+
+// Bulk kernel: 4 characters -> 3 bytes per group, stopping at a non-alphabet character
+static size_t decode_groups(const uint8_t *table, const char *input, const size_t groups, uint8_t *output) {
+    const uint8_t *p = (const uint8_t *) input;
+    for (size_t g = 0; g < groups; g++, p += 4, output += 3) {
+        const uint8_t a = table[p[0]], b = table[p[1]], c = table[p[2]], d = table[p[3]];
+        if ((a | b | c | d) & 0xC0) return g;
+
+        const uint32_t n = (uint32_t) a << 18 | (uint32_t) b << 12 | (uint32_t) c << 6 | d;
+        output[0] = (uint8_t) (n >> 16);
+        output[1] = (uint8_t) (n >> 8);
+        output[2] = (uint8_t) n;
+    }
+    return groups;
+}
+
+static base64_error_t to_error(const bek_error_t error) {
+    switch (error) {
+        case BEK_SUCCESS: return BASE64_SUCCESS;
+        case BEK_ERROR_INVALID_INPUT: return BASE64_ERROR_INVALID_INPUT;
+        case BEK_ERROR_INVALID_LENGTH: return BASE64_ERROR_INVALID_LENGTH;
+        case BEK_ERROR_BUFFER_TOO_SMALL: return BASE64_ERROR_BUFFER_TOO_SMALL;
+        case BEK_ERROR_NULL_POINTER: return BASE64_ERROR_NULL_POINTER;
+        case BEK_ERROR_PADDING: return BASE64_ERROR_PADDING;
+        case BEK_ERROR_CALLBACK: return BASE64_ERROR_CALLBACK;
+        default: return BASE64_ERROR_MEMORY;
+    }
+}
+
+base64_error_t base64_encode_update(const base64_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const uint8_t *input,
+                                    const size_t input_length,
+                                    size_t *input_consumed,
+                                    char *output,
+                                    const size_t output_size,
+                                    size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (input == NULL && input_length > 0) || input_consumed == NULL ||
+        (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_update(&ctx->desc, stream, input, input_length, input_consumed,
+                                      output, output_size, output_length));
+}
+
+base64_error_t base64_encode_final(const base64_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   char *output,
+                                   const size_t output_size,
+                                   size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_final(&ctx->desc, stream, output, output_size, output_length));
+}
+
+base64_error_t base64_decode_update(const base64_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const char *input,
+                                    const size_t input_length,
+                                    size_t *input_consumed,
+                                    uint8_t *output,
+                                    const size_t output_size,
+                                    size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (input == NULL && input_length > 0) || input_consumed == NULL ||
+        (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_update(&ctx->desc, stream, input, input_length, input_consumed,
+                                      output, output_size, output_length));
+}
+
+base64_error_t base64_decode_final(const base64_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   uint8_t *output,
+                                   const size_t output_size,
+                                   size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_final(&ctx->desc, stream, output, output_size, output_length));
+}
+
+base64_error_t base64_encode_iov(const base64_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 const int input_count,
+                                 const struct iovec *output,
+                                 const int output_count,
+                                 size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_iov(&ctx->desc, input, input_count, output, output_count, output_length));
+}
+
+base64_error_t base64_decode_iov(const base64_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 const int input_count,
+                                 const struct iovec *output,
+                                 const int output_count,
+                                 size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_iov(&ctx->desc, input, input_count, output, output_count, output_length));
+}
+
+base64_error_t base64_encode_to_sink(const base64_ctx_t *ctx,
+                                     const uint8_t *input,
+                                     const size_t input_length,
+                                     const bek_sink_fn sink,
+                                     void *user_data) {
+    if (ctx == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_to_sink(&ctx->desc, input, input_length, sink, user_data));
+}
+
+base64_error_t base64_decode_to_sink(const base64_ctx_t *ctx,
+                                     const char *input,
+                                     const size_t input_length,
+                                     const bek_sink_fn sink,
+                                     void *user_data) {
+    if (ctx == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_to_sink(&ctx->desc, input, input_length, sink, user_data));
+}
+
+base64_error_t base64_encode_ring(const base64_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_ring(&ctx->desc, input, output, output_length));
+}
+
+base64_error_t base64_decode_ring(const base64_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_ring(&ctx->desc, input, output, output_length));
+}
+
+base64_error_t base64_encode_to_buf(const base64_ctx_t *ctx,
+                                    const uint8_t *input,
+                                    const size_t input_length,
+                                    bek_buf_t *buf) {
+    if (ctx == NULL || buf == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+
+    // One byte more than the encoder may need, so the text always ends in
+    // '\0' even when the context omits the terminator
+    size_t size;
+    const base64_error_t size_check = base64_get_encode_size(input_length, ctx, &size);
+    if (size_check != BASE64_SUCCESS) return size_check;
+    if (bek_buf_reserve(buf, size + 1) != BEK_SUCCESS) {
+        return BASE64_ERROR_MEMORY;
+    }
+
+    size_t length;
+    const base64_error_t error = base64_encode(ctx, input, input_length, (char *) buf->data + buf->length,
+                                               buf->capacity - buf->length, &length);
+    if (error == BASE64_SUCCESS) {
+        buf->length += length;
+        buf->data[buf->length] = '\0';
+    }
+    return error;
+}
+
+base64_error_t base64_decode_to_buf(const base64_ctx_t *ctx,
+                                    const char *input,
+                                    const size_t input_length,
+                                    bek_buf_t *buf) {
+    if (ctx == NULL || buf == NULL) {
+        return BASE64_ERROR_NULL_POINTER;
+    }
+
+    size_t size;
+    const base64_error_t size_check = base64_get_decode_size(input_length, ctx, &size);
+    if (size_check != BASE64_SUCCESS) return size_check;
+    if (bek_buf_reserve(buf, size) != BEK_SUCCESS) {
+        return BASE64_ERROR_MEMORY;
+    }
+
+    size_t length;
+    const base64_error_t error = base64_decode(ctx, input, input_length, buf->data + buf->length,
+                                               buf->capacity - buf->length, &length);
+    if (error == BASE64_SUCCESS) buf->length += length;
+    return error;
+}
+
+const bek_codec_desc_t *base64_desc(const base64_ctx_t *ctx) {
+    return &ctx->desc;
+}
+
+// Standard alphabet with padding, wrapped at 64 columns as RFC 7468 requires
+static const bek_codec_desc_t PEM_DESC = {
+    .alphabet = bek_base64_standard_alphabet,
+    .decode_table = bek_base64_standard_decode,
+    .bits_per_char = 6,
+    .group_bytes = 3,
+    .group_chars = 4,
+    .use_padding = 1,
+    .line_length = 64,
+    .line_ending = "\n",
+    .encode_groups = encode_groups,
+    .decode_groups = decode_groups
+};
+
+const bek_codec_desc_t *base64_pem_desc(void) {
+    return &PEM_DESC;
+}
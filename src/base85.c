@@ -0,0 +1,513 @@
+#include <stdlib.h>
+#include <string.h>
+#include "base85.h"
+
+#include "alloc.h"
+#include "bytes.h"
+#include "codec.h"
+#include "stream.h"
+#include "tables.h"
+
+// Internal context structure
+struct base85_ctx_t {
+    const char *alphabet;        // Shared read-only alphabet of the variant
+    const uint8_t *decode_table; // Shared read-only reverse table of the variant
+    int use_z85;
+    int line_length;
+    char line_ending[3];
+    int omit_terminator;
+    bek_codec_desc_t desc;     // Configuration as seen by the streaming engine
+    bek_allocator_t allocator; // Allocator the context was allocated with
+};
+
+static void encode_groups(const char *alphabet, const uint8_t *input, size_t groups, char *output);
+static size_t decode_groups(const uint8_t *table, const char *input, size_t groups, uint8_t *output);
+
+// Default configuration
+static const base85_config_t DEFAULT_CONFIG = {
+    .use_z85 = 0,
+    .line_length = 76,
+    .line_ending = "\n"
+};
+
+base85_error_t base85_init(base85_ctx_t **ctx, const base85_config_t *config) {
+    if (ctx == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+
+    // Use default config if not provided
+    const base85_config_t *effective_config = config ? config : &DEFAULT_CONFIG;
+
+    // Allocate context
+    const bek_allocator_t allocator = bek_allocator(effective_config->allocator);
+    *ctx = bek_alloc(&allocator, sizeof(base85_ctx_t));
+    if (*ctx == NULL) {
+        return BASE85_ERROR_MEMORY;
+    }
+    (*ctx)->allocator = allocator;
+
+    // Point at the prebuilt tables of the selected variant
+    (*ctx)->alphabet = effective_config->use_z85 ? bek_z85_alphabet : bek_ascii85_alphabet;
+    (*ctx)->decode_table = effective_config->use_z85 ? bek_z85_decode : bek_ascii85_decode;
+
+    // Copy configuration
+    (*ctx)->use_z85 = effective_config->use_z85;
+    (*ctx)->line_length = effective_config->line_length;
+    (*ctx)->omit_terminator = effective_config->omit_terminator;
+    strncpy((*ctx)->line_ending, effective_config->line_ending, sizeof((*ctx)->line_ending) - 1);
+    (*ctx)->line_ending[sizeof((*ctx)->line_ending) - 1] = '\0';
+
+    // Describe the configuration for the streaming engine
+    (*ctx)->desc = (bek_codec_desc_t){
+        .alphabet = (*ctx)->alphabet,
+        .decode_table = (*ctx)->decode_table,
+        .radix = 85,
+        .zero_groups = !(*ctx)->use_z85,
+        .group_bytes = 4,
+        .group_chars = 5,
+        .use_padding = 0,
+        .line_length = (*ctx)->line_length > 0 ? (size_t) (*ctx)->line_length : 0,
+        .line_ending = (*ctx)->line_ending,
+        .stores = effective_config->stores,
+        .encode_groups = encode_groups,
+        .decode_groups = decode_groups
+    };
+
+    return BASE85_SUCCESS;
+}
+
+base85_error_t base85_get_encode_size(size_t input_length,
+                                      const base85_ctx_t *ctx,
+                                      size_t *output_size) {
+    if (ctx == NULL || output_size == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+
+    // 5 characters per 4 bytes, n + 1 for a partial quantum of n bytes
+    size_t base_size = 5 * (input_length / 4) + (input_length % 4 ? input_length % 4 + 1 : 0);
+
+    // Add line breaks if needed
+    if (ctx->line_length > 0) {
+        size_t line_breaks = (base_size / ctx->line_length) * strlen(ctx->line_ending);
+        base_size += line_breaks;
+    }
+
+    *output_size = base_size + (ctx->omit_terminator ? 0 : 1); // +1 for null terminator
+    return BASE85_SUCCESS;
+}
+
+base85_error_t base85_get_decode_size(size_t input_length,
+                                      const base85_ctx_t *ctx,
+                                      size_t *output_size) {
+    if (ctx == NULL || output_size == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+
+    // Every Ascii85 character may be a 'z' standing for four zero bytes
+    *output_size = ctx->use_z85 ? (input_length + 4) / 5 * 4 : input_length * 4;
+    return BASE85_SUCCESS;
+}
+
+// 32-bit value -> 5 digits without a division instruction. The value is split
+// into two base-7225 (85^2) halves whose digit chains run independently; each
+// quotient is a multiply by a rounded-up reciprocal and a shift, exact over
+// the operand's range (checked exhaustively), and each remainder a
+// multiply-subtract.
+static inline void encode_value(const char *alphabet, const uint32_t n, char *output) {
+    const uint32_t high = (uint32_t) (((uint64_t) n * 2434904643u) >> 44); // n / 7225, n < 2^32
+    const uint32_t low = n - high * 7225;
+    const uint32_t d0 = (uint32_t) (((uint64_t) high * 148615u) >> 30);    // high / 7225, high < 594466
+    const uint32_t mid = high - d0 * 7225;
+    const uint32_t d1 = (mid * 12337u) >> 20;                              // mid / 85, mid < 7225
+    const uint32_t d3 = (low * 12337u) >> 20;                              // low / 85, low < 7225
+
+    output[0] = alphabet[d0];
+    output[1] = alphabet[d1];
+    output[2] = alphabet[mid - d1 * 85];
+    output[3] = alphabet[d3];
+    output[4] = alphabet[low - d3 * 85];
+}
+
+// 5 characters -> 32-bit value by multiply-accumulate. Returns non-zero if a
+// character is outside the alphabet (every class marker has the top bit set)
+// or the digits exceed 2^32 - 1, the largest being "s8W-!" / "%nSc0".
+static inline int decode_value(const uint8_t *table, const char *input, uint32_t *value) {
+    const uint8_t *p = (const uint8_t *) input;
+    const uint32_t d0 = table[p[0]], d1 = table[p[1]], d2 = table[p[2]], d3 = table[p[3]], d4 = table[p[4]];
+    const uint64_t n = (uint64_t) (d0 * 7225 + d1 * 85 + d2) * 7225 + d3 * 85 + d4;
+    *value = (uint32_t) n;
+    return ((d0 | d1 | d2 | d3 | d4) & 0x80) != 0 || n > UINT32_MAX;
+}
+
+// Helper function to write one character, wrapping lines as configured
+static inline void put_char(const base85_ctx_t *ctx, char *output, size_t *output_index,
+                            size_t *column, const char c) {
+    output[(*output_index)++] = c;
+    if (ctx->line_length > 0 && ++*column == (size_t) ctx->line_length) {
+        for (const char *e = ctx->line_ending; *e != '\0'; e++) {
+            output[(*output_index)++] = *e;
+        }
+        *column = 0;
+    }
+}
+
+base85_error_t base85_encode(const base85_ctx_t *ctx,
+                             const uint8_t *input,
+                             const size_t input_length,
+                             char *output,
+                             const size_t output_size,
+                             size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+
+    size_t required_size;
+    const base85_error_t size_check = base85_get_encode_size(input_length, ctx, &required_size);
+    if (size_check != BASE85_SUCCESS) return size_check;
+
+    if (output_size < required_size) {
+        return BASE85_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    // Output asked to bypass the cache goes through the engine
+    if (bek_use_nontemporal(&ctx->desc)) {
+        size_t length;
+        bek_encode_nontemporal(&ctx->desc, input, input_length, output, output_size, &length);
+        if (!ctx->omit_terminator) output[length] = '\0';
+        *output_length = length;
+        return BASE85_SUCCESS;
+    }
+
+    size_t i = 0;
+    size_t output_index = 0;
+    size_t column = 0;
+
+    if (ctx->line_length <= 0) {
+        for (; i + 4 <= input_length; i += 4, output_index += 5) {
+            encode_value(ctx->alphabet, load_be32(input + i), output + output_index);
+        }
+    }
+
+    for (; i + 4 <= input_length; i += 4) {
+        char group[5];
+        encode_value(ctx->alphabet, load_be32(input + i), group);
+        for (int k = 0; k < 5; k++) {
+            put_char(ctx, output, &output_index, &column, group[k]);
+        }
+    }
+
+    // Zero-fill the last partial quantum and keep one character per byte plus one
+    const size_t remaining = input_length - i;
+    if (remaining > 0) {
+        uint8_t last[4] = {0};
+        memcpy(last, input + i, remaining);
+        char group[5];
+        encode_value(ctx->alphabet, load_be32(last), group);
+        for (size_t k = 0; k <= remaining; k++) {
+            put_char(ctx, output, &output_index, &column, group[k]);
+        }
+    }
+
+    if (!ctx->omit_terminator) output[output_index] = '\0';
+    *output_length = output_index;
+
+    return BASE85_SUCCESS;
+}
+
+base85_error_t base85_decode(const base85_ctx_t *ctx,
+                             const char *input,
+                             const size_t input_length,
+                             uint8_t *output,
+                             const size_t output_size,
+                             size_t *output_length) {
+    if (ctx == NULL || input == NULL || output == NULL || output_length == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+
+    size_t required_size;
+    const base85_error_t size_check = base85_get_decode_size(input_length, ctx, &required_size);
+    if (size_check != BASE85_SUCCESS) return size_check;
+
+    if (output_size < required_size) {
+        return BASE85_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    const uint8_t *table = ctx->decode_table;
+    size_t output_len = 0;
+    uint64_t value = 0;
+    unsigned count = 0;
+
+    for (size_t i = 0; i < input_length; i++) {
+        // Whole groups at a time between quanta
+        if (count == 0) {
+            const size_t groups = decode_groups(table, input + i, (input_length - i) / 5, output + output_len);
+            i += 5 * groups;
+            output_len += 4 * groups;
+            if (i >= input_length) break;
+        }
+
+        const uint8_t digit = table[(uint8_t) input[i]];
+
+        // Skip whitespace and expand 'z' between quanta
+        if (digit == BEK_CLASS_SPACE) continue;
+        if (digit == BEK_CLASS_ZERO && count == 0) {
+            memset(output + output_len, 0, 4);
+            output_len += 4;
+            continue;
+        }
+        if (digit >= 85) {
+            return BASE85_ERROR_INVALID_INPUT;
+        }
+
+        value = value * 85 + digit;
+        if (++count == 5) {
+            if (value > UINT32_MAX) return BASE85_ERROR_INVALID_INPUT;
+            store_be32(output + output_len, (uint32_t) value);
+            output_len += 4;
+            value = 0;
+            count = 0;
+        }
+    }
+
+    // A partial quantum of n characters holds n - 1 bytes; the missing digits
+    // count as the largest one, undoing the encoder's zero fill
+    if (count == 1) {
+        return BASE85_ERROR_INVALID_LENGTH;
+    }
+    if (count > 0) {
+        for (unsigned k = count; k < 5; k++) {
+            value = value * 85 + 84;
+        }
+        if (value > UINT32_MAX) return BASE85_ERROR_INVALID_INPUT;
+        for (unsigned k = 0; k < count - 1; k++) {
+            output[output_len++] = (uint8_t) (value >> (24 - 8 * k));
+        }
+    }
+
+    *output_length = output_len;
+    return BASE85_SUCCESS;
+}
+
+const char *base85_error_string(base85_error_t error) {
+    switch (error) {
+        case BASE85_SUCCESS: return "Success";
+        case BASE85_ERROR_INVALID_INPUT: return "Invalid input";
+        case BASE85_ERROR_INVALID_LENGTH: return "Invalid length";
+        case BASE85_ERROR_BUFFER_TOO_SMALL: return "Buffer too small";
+        case BASE85_ERROR_NULL_POINTER: return "Null pointer";
+        case BASE85_ERROR_MEMORY: return "Memory allocation failed";
+        case BASE85_ERROR_CALLBACK: return "Output callback aborted";
+        default: return "Unknown error";
+    }
+}
+
+void base85_free(base85_ctx_t *ctx) {
+    if (ctx != NULL) {
+        const bek_allocator_t allocator = ctx->allocator;
+        bek_free(&allocator, ctx, sizeof(base85_ctx_t));
+    }
+}
+
+// Bulk kernel: 4 bytes -> 5 characters per group
+static void encode_groups(const char *alphabet, const uint8_t *input, const size_t groups, char *output) {
+    for (size_t g = 0; g < groups; g++, input += 4, output += 5) {
+        encode_value(alphabet, load_be32(input), output);
+    }
+}
+
+// Bulk kernel: 5 characters -> 4 bytes per group, stopping at a group that is
+// not five alphabet characters of a 32-bit value ('z' included)
+static size_t decode_groups(const uint8_t *table, const char *input, const size_t groups, uint8_t *output) {
+    for (size_t g = 0; g < groups; g++, input += 5, output += 4) {
+        uint32_t value;
+        if (decode_value(table, input, &value)) return g;
+        store_be32(output, value);
+    }
+    return groups;
+}
+
+static base85_error_t to_error(const bek_error_t error) {
+    switch (error) {
+        case BEK_SUCCESS: return BASE85_SUCCESS;
+        case BEK_ERROR_INVALID_INPUT: return BASE85_ERROR_INVALID_INPUT;
+        case BEK_ERROR_INVALID_LENGTH: return BASE85_ERROR_INVALID_LENGTH;
+        case BEK_ERROR_BUFFER_TOO_SMALL: return BASE85_ERROR_BUFFER_TOO_SMALL;
+        case BEK_ERROR_NULL_POINTER: return BASE85_ERROR_NULL_POINTER;
+        case BEK_ERROR_PADDING: return BASE85_ERROR_INVALID_INPUT;
+        case BEK_ERROR_CALLBACK: return BASE85_ERROR_CALLBACK;
+        default: return BASE85_ERROR_MEMORY;
+    }
+}
+
+base85_error_t base85_encode_update(const base85_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const uint8_t *input,
+                                    const size_t input_length,
+                                    size_t *input_consumed,
+                                    char *output,
+                                    const size_t output_size,
+                                    size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (input == NULL && input_length > 0) || input_consumed == NULL ||
+        (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_update(&ctx->desc, stream, input, input_length, input_consumed,
+                                      output, output_size, output_length));
+}
+
+base85_error_t base85_encode_final(const base85_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   char *output,
+                                   const size_t output_size,
+                                   size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_final(&ctx->desc, stream, output, output_size, output_length));
+}
+
+base85_error_t base85_decode_update(const base85_ctx_t *ctx,
+                                    bek_stream_t *stream,
+                                    const char *input,
+                                    const size_t input_length,
+                                    size_t *input_consumed,
+                                    uint8_t *output,
+                                    const size_t output_size,
+                                    size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (input == NULL && input_length > 0) || input_consumed == NULL ||
+        (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_update(&ctx->desc, stream, input, input_length, input_consumed,
+                                      output, output_size, output_length));
+}
+
+base85_error_t base85_decode_final(const base85_ctx_t *ctx,
+                                   bek_stream_t *stream,
+                                   uint8_t *output,
+                                   const size_t output_size,
+                                   size_t *output_length) {
+    if (ctx == NULL || stream == NULL || (output == NULL && output_size > 0) || output_length == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_final(&ctx->desc, stream, output, output_size, output_length));
+}
+
+base85_error_t base85_encode_iov(const base85_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 const int input_count,
+                                 const struct iovec *output,
+                                 const int output_count,
+                                 size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_iov(&ctx->desc, input, input_count, output, output_count, output_length));
+}
+
+base85_error_t base85_decode_iov(const base85_ctx_t *ctx,
+                                 const struct iovec *input,
+                                 const int input_count,
+                                 const struct iovec *output,
+                                 const int output_count,
+                                 size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_iov(&ctx->desc, input, input_count, output, output_count, output_length));
+}
+
+base85_error_t base85_encode_to_sink(const base85_ctx_t *ctx,
+                                     const uint8_t *input,
+                                     const size_t input_length,
+                                     const bek_sink_fn sink,
+                                     void *user_data) {
+    if (ctx == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_to_sink(&ctx->desc, input, input_length, sink, user_data));
+}
+
+base85_error_t base85_decode_to_sink(const base85_ctx_t *ctx,
+                                     const char *input,
+                                     const size_t input_length,
+                                     const bek_sink_fn sink,
+                                     void *user_data) {
+    if (ctx == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_to_sink(&ctx->desc, input, input_length, sink, user_data));
+}
+
+base85_error_t base85_encode_ring(const base85_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_encode_ring(&ctx->desc, input, output, output_length));
+}
+
+base85_error_t base85_decode_ring(const base85_ctx_t *ctx,
+                                  const bek_ring_t *input,
+                                  bek_ring_t *output,
+                                  size_t *output_length) {
+    if (ctx == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+    return to_error(bek_decode_ring(&ctx->desc, input, output, output_length));
+}
+
+base85_error_t base85_encode_to_buf(const base85_ctx_t *ctx,
+                                    const uint8_t *input,
+                                    const size_t input_length,
+                                    bek_buf_t *buf) {
+    if (ctx == NULL || buf == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+
+    // One byte more than the encoder may need, so the text always ends in
+    // '\0' even when the context omits the terminator
+    size_t size;
+    const base85_error_t size_check = base85_get_encode_size(input_length, ctx, &size);
+    if (size_check != BASE85_SUCCESS) return size_check;
+    if (bek_buf_reserve(buf, size + 1) != BEK_SUCCESS) {
+        return BASE85_ERROR_MEMORY;
+    }
+
+    size_t length;
+    const base85_error_t error = base85_encode(ctx, input, input_length, (char *) buf->data + buf->length,
+                                               buf->capacity - buf->length, &length);
+    if (error == BASE85_SUCCESS) {
+        buf->length += length;
+        buf->data[buf->length] = '\0';
+    }
+    return error;
+}
+
+base85_error_t base85_decode_to_buf(const base85_ctx_t *ctx,
+                                    const char *input,
+                                    const size_t input_length,
+                                    bek_buf_t *buf) {
+    if (ctx == NULL || buf == NULL) {
+        return BASE85_ERROR_NULL_POINTER;
+    }
+
+    size_t size;
+    const base85_error_t size_check = base85_get_decode_size(input_length, ctx, &size);
+    if (size_check != BASE85_SUCCESS) return size_check;
+    if (bek_buf_reserve(buf, size) != BEK_SUCCESS) {
+        return BASE85_ERROR_MEMORY;
+    }
+
+    size_t length;
+    const base85_error_t error = base85_decode(ctx, input, input_length, buf->data + buf->length,
+                                               buf->capacity - buf->length, &length);
+    if (error == BASE85_SUCCESS) buf->length += length;
+    return error;
+}
+
+const bek_codec_desc_t *base85_desc(const base85_ctx_t *ctx) {
+    return &ctx->desc;
+}
@@ -0,0 +1,71 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <bek.h>
+
+#include "alloc.h"
+
+// Smallest allocation, so short appends do not reallocate byte by byte
+#define BUF_MIN_CAPACITY 64
+
+void bek_buf_init(bek_buf_t *buf, const bek_allocator_t *allocator) {
+    if (buf != NULL) {
+        memset(buf, 0, sizeof(*buf));
+        buf->allocator = allocator;
+    }
+}
+
+bek_error_t bek_buf_reserve(bek_buf_t *buf, const size_t additional) {
+    if (buf == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+    if (additional > SIZE_MAX - buf->length) {
+        return BEK_ERROR_MEMORY;
+    }
+
+    const size_t needed = buf->length + additional;
+    if (needed <= buf->capacity) return BEK_SUCCESS;
+
+    // Geometric growth keeps a run of appends at amortised O(1) per byte
+    size_t capacity = buf->capacity <= SIZE_MAX / 2 ? buf->capacity * 2 : SIZE_MAX;
+    if (capacity < needed) capacity = needed;
+    if (capacity < BUF_MIN_CAPACITY) capacity = BUF_MIN_CAPACITY;
+
+    uint8_t *data = bek_alloc(buf->allocator, capacity);
+    if (data == NULL) {
+        return BEK_ERROR_MEMORY;
+    }
+    if (buf->length > 0) memcpy(data, buf->data, buf->length);
+    bek_free(buf->allocator, buf->data, buf->capacity);
+    buf->data = data;
+    buf->capacity = capacity;
+    return BEK_SUCCESS;
+}
+
+bek_error_t bek_buf_append(bek_buf_t *buf, const void *data, const size_t length) {
+    if (buf == NULL || (data == NULL && length > 0)) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    const bek_error_t error = bek_buf_reserve(buf, length);
+    if (error != BEK_SUCCESS) return error;
+
+    if (length > 0) memcpy(buf->data + buf->length, data, length);
+    buf->length += length;
+    return BEK_SUCCESS;
+}
+
+void bek_buf_clear(bek_buf_t *buf) {
+    if (buf != NULL) {
+        buf->length = 0;
+    }
+}
+
+void bek_buf_free(bek_buf_t *buf) {
+    if (buf != NULL) {
+        bek_free(buf->allocator, buf->data, buf->capacity);
+        buf->data = NULL;
+        buf->length = 0;
+        buf->capacity = 0;
+    }
+}
@@ -0,0 +1,139 @@
+#include <bek_checksum.h>
+
+#include "bytes.h"
+#include "codec.h"
+#include "stream.h"
+#include "tables.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define CRC32C_SSE42 1
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define CRC32C_ARM 1
+#endif
+
+// Raw bytes per step of the fused calls: the block and its text stay in L1
+// between the checksum and the codec
+#define FUSED_BLOCK 8192
+
+// Slicing by 8: one table lookup per byte, eight independent per word
+static uint32_t crc32c_software(uint32_t crc, const uint8_t *p, size_t length) {
+    const uint32_t (*t)[256] = bek_crc32c_table;
+    for (; length >= 8; p += 8, length -= 8) {
+        const uint64_t x = load_le64(p) ^ crc;
+        crc = t[7][x & 0xFF] ^ t[6][(x >> 8) & 0xFF] ^ t[5][(x >> 16) & 0xFF] ^ t[4][(x >> 24) & 0xFF] ^
+              t[3][(x >> 32) & 0xFF] ^ t[2][(x >> 40) & 0xFF] ^ t[1][(x >> 48) & 0xFF] ^ t[0][x >> 56];
+    }
+    for (; length > 0; p++, length--) {
+        crc = t[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#if CRC32C_SSE42
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_hardware(uint32_t crc, const uint8_t *p, size_t length) {
+    uint64_t crc64 = crc;
+    for (; length >= 8; p += 8, length -= 8) {
+        crc64 = _mm_crc32_u64(crc64, load_le64(p));
+    }
+    crc = (uint32_t) crc64;
+    for (; length > 0; p++, length--) {
+        crc = _mm_crc32_u8(crc, *p);
+    }
+    return crc;
+}
+#elif CRC32C_ARM
+static uint32_t crc32c_hardware(uint32_t crc, const uint8_t *p, size_t length) {
+    for (; length >= 8; p += 8, length -= 8) {
+        crc = __crc32cd(crc, load_le64(p));
+    }
+    for (; length > 0; p++, length--) {
+        crc = __crc32cb(crc, *p);
+    }
+    return crc;
+}
+#endif
+
+uint32_t bek_crc32c(const uint32_t crc, const void *data, const size_t length) {
+    if (data == NULL) return crc;
+
+#if CRC32C_SSE42
+    if (__builtin_cpu_supports("sse4.2")) return ~crc32c_hardware(~crc, data, length);
+#elif CRC32C_ARM
+    return ~crc32c_hardware(~crc, data, length);
+#endif
+    return ~crc32c_software(~crc, data, length);
+}
+
+bek_error_t bek_encode_crc32c(const bek_codec_t *codec,
+                              const uint8_t *input,
+                              const size_t input_length,
+                              char *output,
+                              const size_t output_size,
+                              size_t *output_length,
+                              uint32_t *crc) {
+    const bek_codec_desc_t *desc = bek_codec_desc(codec);
+    if (desc == NULL || (input == NULL && input_length > 0) || output_length == NULL || crc == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    size_t required_size;
+    bek_get_encode_size(codec, input_length, &required_size);
+    if (output_size < required_size) {
+        return BEK_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    // Checksum a block, then encode it while it is still in cache
+    bek_stream_t stream;
+    size_t out = 0, consumed, produced, tail;
+    bek_stream_init(&stream);
+    for (size_t in = 0; in < input_length; in += FUSED_BLOCK) {
+        const size_t block = input_length - in < FUSED_BLOCK ? input_length - in : FUSED_BLOCK;
+        *crc = bek_crc32c(*crc, input + in, block);
+        bek_encode_update(desc, &stream, input + in, block, &consumed, output + out, output_size - out, &produced);
+        out += produced;
+    }
+    const bek_error_t error = bek_encode_final(desc, &stream, output + out, output_size - out, &tail);
+
+    *output_length = out + tail;
+    return error;
+}
+
+bek_error_t bek_decode_crc32c(const bek_codec_t *codec,
+                              const char *input,
+                              const size_t input_length,
+                              uint8_t *output,
+                              const size_t output_size,
+                              size_t *output_length,
+                              uint32_t *crc) {
+    const bek_codec_desc_t *desc = bek_codec_desc(codec);
+    if (desc == NULL || (input == NULL && input_length > 0) || output_length == NULL || crc == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    // Decode a block of text, then checksum the bytes it produced while they
+    // are still in cache
+    bek_stream_t stream;
+    size_t out = 0, consumed, produced, tail = 0;
+    bek_error_t error = BEK_SUCCESS;
+    bek_stream_init(&stream);
+    for (size_t in = 0; in < input_length && error == BEK_SUCCESS; in += consumed) {
+        const size_t block = input_length - in < FUSED_BLOCK ? input_length - in : FUSED_BLOCK;
+        error = bek_decode_update(desc, &stream, input + in, block, &consumed,
+                                  output + out, output_size - out, &produced);
+        *crc = bek_crc32c(*crc, output + out, produced);
+        out += produced;
+        if (error == BEK_SUCCESS && consumed < block) {
+            error = BEK_ERROR_BUFFER_TOO_SMALL;
+        }
+    }
+    if (error == BEK_SUCCESS) {
+        error = bek_decode_final(desc, &stream, output + out, output_size - out, &tail);
+        *crc = bek_crc32c(*crc, output + out, tail);
+    }
+
+    *output_length = out + tail;
+    return error;
+}
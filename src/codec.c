@@ -0,0 +1,202 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "codec.h"
+
+const bek_codec_desc_t *bek_codec_desc(const bek_codec_t *codec) {
+    if (codec == NULL) return NULL;
+
+    switch (codec->kind) {
+        case BEK_CODEC_BASE64: return codec->ctx.base64 ? base64_desc(codec->ctx.base64) : NULL;
+        case BEK_CODEC_BASE32: return codec->ctx.base32 ? base32_desc(codec->ctx.base32) : NULL;
+        case BEK_CODEC_BASE16: return codec->ctx.base16 ? base16_desc(codec->ctx.base16) : NULL;
+        case BEK_CODEC_BASE85: return codec->ctx.base85 ? base85_desc(codec->ctx.base85) : NULL;
+        default: return NULL;
+    }
+}
+
+bek_error_t bek_get_encode_size(const bek_codec_t *codec,
+                                const size_t input_length,
+                                size_t *output_size) {
+    const bek_codec_desc_t *desc = bek_codec_desc(codec);
+    if (desc == NULL || output_size == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    // Characters for whole quanta plus the (optionally padded) tail
+    const size_t tail = input_length % desc->group_bytes;
+    size_t size = input_length / desc->group_bytes * desc->group_chars;
+    if (tail > 0 && desc->radix) {
+        size += tail + 1;
+    } else if (tail > 0) {
+        size += desc->use_padding ? desc->group_chars : (tail * 8 + desc->bits_per_char - 1) / desc->bits_per_char;
+    }
+
+    if (desc->line_length > 0) {
+        size += size / desc->line_length * strlen(desc->line_ending);
+    }
+
+    *output_size = size;
+    return BEK_SUCCESS;
+}
+
+bek_error_t bek_get_decode_size(const bek_codec_t *codec,
+                                const size_t input_length,
+                                size_t *output_size) {
+    const bek_codec_desc_t *desc = bek_codec_desc(codec);
+    if (desc == NULL || output_size == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    // A zero-group character alone stands for a whole quantum
+    *output_size = desc->zero_groups
+                       ? input_length * desc->group_bytes
+                       : (input_length + desc->group_chars - 1) / desc->group_chars * desc->group_bytes;
+    return BEK_SUCCESS;
+}
+
+bek_error_t bek_get_quantum(const bek_codec_t *codec,
+                            size_t *group_bytes,
+                            size_t *group_chars) {
+    const bek_codec_desc_t *desc = bek_codec_desc(codec);
+    if (desc == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    if (group_bytes != NULL) *group_bytes = desc->group_bytes;
+    if (group_chars != NULL) *group_chars = desc->group_chars;
+    return BEK_SUCCESS;
+}
+
+static size_t gcd(size_t a, size_t b) {
+    while (b != 0) {
+        const size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+size_t bek_encode_chunk_size(const bek_codec_t *codec, const size_t target) {
+    const bek_codec_desc_t *desc = bek_codec_desc(codec);
+    if (desc == NULL) return 0;
+
+    // Smallest run of whole quanta that also fills whole lines
+    size_t unit_chars = desc->group_chars;
+    if (desc->line_length > 0) {
+        unit_chars = unit_chars / gcd(unit_chars, desc->line_length) * desc->line_length;
+    }
+    const size_t unit = unit_chars / desc->group_chars * desc->group_bytes;
+
+    return target < unit ? unit : target / unit * unit;
+}
+
+bek_error_t bek_encode(const bek_codec_t *codec,
+                       const uint8_t *input,
+                       const size_t input_length,
+                       char *output,
+                       const size_t output_size,
+                       size_t *output_length) {
+    const bek_codec_desc_t *desc = bek_codec_desc(codec);
+    if (desc == NULL || (input == NULL && input_length > 0) || output_length == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    size_t required_size;
+    bek_get_encode_size(codec, input_length, &required_size);
+    if (output_size < required_size) {
+        return BEK_ERROR_BUFFER_TOO_SMALL;
+    }
+    if (bek_use_nontemporal(desc)) {
+        return bek_encode_nontemporal(desc, input, input_length, output, output_size, output_length);
+    }
+
+    bek_stream_t stream;
+    size_t consumed, produced, tail;
+    bek_stream_init(&stream);
+    bek_encode_update(desc, &stream, input, input_length, &consumed, output, output_size, &produced);
+    const bek_error_t error = bek_encode_final(desc, &stream, output + produced, output_size - produced, &tail);
+
+    *output_length = produced + tail;
+    return error;
+}
+
+bek_error_t bek_decode(const bek_codec_t *codec,
+                       const char *input,
+                       const size_t input_length,
+                       uint8_t *output,
+                       const size_t output_size,
+                       size_t *output_length) {
+    const bek_codec_desc_t *desc = bek_codec_desc(codec);
+    if (desc == NULL || (input == NULL && input_length > 0) || output_length == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    bek_stream_t stream;
+    size_t consumed, produced, tail = 0;
+    bek_stream_init(&stream);
+    bek_error_t error = bek_decode_update(desc, &stream, input, input_length, &consumed, output, output_size, &produced);
+    if (error == BEK_SUCCESS && consumed < input_length) {
+        error = BEK_ERROR_BUFFER_TOO_SMALL;
+    }
+    if (error == BEK_SUCCESS) {
+        error = bek_decode_final(desc, &stream, output + produced, output_size - produced, &tail);
+    }
+
+    *output_length = produced + tail;
+    return error;
+}
+
+bek_error_t bek_encode_to_buf(const bek_codec_t *codec,
+                              const uint8_t *input,
+                              const size_t input_length,
+                              bek_buf_t *buf) {
+    size_t size;
+    if (buf == NULL || bek_get_encode_size(codec, input_length, &size) != BEK_SUCCESS) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    bek_error_t error = bek_buf_reserve(buf, size + 1);
+    if (error != BEK_SUCCESS) return error;
+
+    size_t length;
+    error = bek_encode(codec, input, input_length, (char *) buf->data + buf->length, size, &length);
+    if (error == BEK_SUCCESS) {
+        buf->length += length;
+        buf->data[buf->length] = '\0';
+    }
+    return error;
+}
+
+bek_error_t bek_decode_to_buf(const bek_codec_t *codec,
+                              const char *input,
+                              const size_t input_length,
+                              bek_buf_t *buf) {
+    size_t size;
+    if (buf == NULL || bek_get_decode_size(codec, input_length, &size) != BEK_SUCCESS) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    bek_error_t error = bek_buf_reserve(buf, size);
+    if (error != BEK_SUCCESS) return error;
+
+    size_t length;
+    error = bek_decode(codec, input, input_length, buf->data + buf->length, size, &length);
+    if (error == BEK_SUCCESS) buf->length += length;
+    return error;
+}
+
+const char *bek_error_string(const bek_error_t error) {
+    switch (error) {
+        case BEK_SUCCESS: return "Success";
+        case BEK_ERROR_INVALID_INPUT: return "Invalid input";
+        case BEK_ERROR_INVALID_LENGTH: return "Invalid length";
+        case BEK_ERROR_BUFFER_TOO_SMALL: return "Buffer too small";
+        case BEK_ERROR_NULL_POINTER: return "Null pointer";
+        case BEK_ERROR_PADDING: return "Invalid padding";
+        case BEK_ERROR_MEMORY: return "Memory allocation failed";
+        case BEK_ERROR_CALLBACK: return "Output callback aborted";
+        case BEK_ERROR_IO: return "File operation failed";
+        default: return "Unknown error";
+    }
+}
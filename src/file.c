@@ -0,0 +1,262 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <bek_file.h>
+
+#include "alloc.h"
+#include "codec.h"
+#include "split.h"
+
+// One pass of work split into chunks that threads claim in order
+typedef struct file_job_t file_job_t;
+typedef bek_error_t (*chunk_fn)(file_job_t *job, size_t index);
+
+struct file_job_t {
+    const bek_codec_t *codec;
+    const bek_codec_desc_t *desc;
+    const uint8_t *input;
+    size_t input_length;
+    uint8_t *output;
+    size_t chunk_count;
+    size_t planned;         // Raw chunks the arrays below were allocated for
+    size_t *input_offsets;  // chunk_count + 1 boundaries into input
+    size_t *output_offsets; // chunk_count + 1 boundaries into output
+    size_t *counts;         // Significant characters per raw chunk (decode)
+    size_t last_length;     // Bytes produced by the final chunk (decode)
+    bek_allocator_t allocator;
+    chunk_fn fn;
+    atomic_size_t next;
+    atomic_int error;
+};
+
+static void *file_worker(void *arg) {
+    file_job_t *job = arg;
+
+    for (;;) {
+        const size_t index = atomic_fetch_add(&job->next, 1);
+        if (index >= job->chunk_count || atomic_load(&job->error) != BEK_SUCCESS) break;
+
+        const bek_error_t error = job->fn(job, index);
+        if (error != BEK_SUCCESS) {
+            int expected = BEK_SUCCESS;
+            atomic_compare_exchange_strong(&job->error, &expected, (int) error);
+        }
+    }
+    return NULL;
+}
+
+// Run job->fn over every chunk on up to `threads` threads, the caller included
+static bek_error_t run_chunks(file_job_t *job, chunk_fn fn, unsigned threads) {
+    job->fn = fn;
+    atomic_store(&job->next, 0);
+    atomic_store(&job->error, BEK_SUCCESS);
+
+    if (threads > job->chunk_count) threads = (unsigned) job->chunk_count;
+    const size_t helpers_size = threads > 1 ? (threads - 1) * sizeof(pthread_t) : 0;
+    pthread_t *helpers = threads > 1 ? bek_alloc(&job->allocator, helpers_size) : NULL;
+
+    unsigned started = 0;
+    if (helpers != NULL) {
+        while (started < threads - 1 && pthread_create(&helpers[started], NULL, file_worker, job) == 0) {
+            started++;
+        }
+    }
+    file_worker(job);
+    for (unsigned i = 0; i < started; ++i) {
+        pthread_join(helpers[i], NULL);
+    }
+    bek_free(&job->allocator, helpers, helpers_size);
+
+    return (bek_error_t) atomic_load(&job->error);
+}
+
+static bek_error_t encode_chunk(file_job_t *job, const size_t index) {
+    const size_t start = job->input_offsets[index];
+    const size_t size = job->output_offsets[index + 1] - job->output_offsets[index];
+    size_t length;
+
+    return bek_encode(job->codec, job->input + start, job->input_offsets[index + 1] - start,
+                      (char *) job->output + job->output_offsets[index], size, &length);
+}
+
+static bek_error_t count_chunk(file_job_t *job, const size_t index) {
+    const size_t start = job->input_offsets[index];
+    job->counts[index] = bek_count_significant(job->desc, job->input + start, job->input_offsets[index + 1] - start);
+    return BEK_SUCCESS;
+}
+
+static bek_error_t decode_chunk(file_job_t *job, const size_t index) {
+    const size_t start = job->input_offsets[index];
+    const size_t size = job->output_offsets[index + 1] - job->output_offsets[index];
+    size_t length;
+
+    const bek_error_t error = bek_decode(job->codec, (const char *) job->input + start,
+                                         job->input_offsets[index + 1] - start,
+                                         job->output + job->output_offsets[index], size, &length);
+    if (error != BEK_SUCCESS) return error;
+
+    // Only the final chunk may end in a short (padded) quantum
+    if (index + 1 == job->chunk_count) {
+        job->last_length = length;
+    } else if (length != size) {
+        return BEK_ERROR_INVALID_INPUT;
+    }
+    return BEK_SUCCESS;
+}
+
+static bek_error_t map_input(const char *path, int *fd, const uint8_t **data, size_t *length) {
+    struct stat st;
+
+    *fd = open(path, O_RDONLY);
+    if (*fd < 0) return BEK_ERROR_IO;
+    if (fstat(*fd, &st) != 0) return BEK_ERROR_IO;
+    if (!S_ISREG(st.st_mode)) {
+        errno = EINVAL;
+        return BEK_ERROR_IO;
+    }
+
+    *length = (size_t) st.st_size;
+    *data = NULL;
+    if (*length == 0) return BEK_SUCCESS;
+
+    void *map = mmap(NULL, *length, PROT_READ, MAP_PRIVATE, *fd, 0);
+    if (map == MAP_FAILED) return BEK_ERROR_IO;
+    posix_madvise(map, *length, POSIX_MADV_SEQUENTIAL);
+
+    *data = map;
+    return BEK_SUCCESS;
+}
+
+static bek_error_t map_output(const char *path, const size_t length, int *fd, uint8_t **data) {
+    *data = NULL;
+    *fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (*fd < 0) return BEK_ERROR_IO;
+    if (length == 0) return BEK_SUCCESS;
+
+    if (ftruncate(*fd, (off_t) length) != 0) return BEK_ERROR_IO;
+
+    void *map = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0);
+    if (map == MAP_FAILED) return BEK_ERROR_IO;
+    posix_madvise(map, length, POSIX_MADV_SEQUENTIAL);
+
+    *data = map;
+    return BEK_SUCCESS;
+}
+
+// Allocate raw chunk boundaries of chunk_size bytes each
+static bek_error_t split_input(file_job_t *job, const size_t chunk_size, const int decode) {
+    job->chunk_count = job->input_length == 0 ? 1 : (job->input_length + chunk_size - 1) / chunk_size;
+    job->planned = job->chunk_count;
+    job->input_offsets = bek_alloc(&job->allocator, (job->planned + 1) * sizeof(size_t));
+    job->output_offsets = bek_alloc(&job->allocator, (job->planned + 1) * sizeof(size_t));
+    job->counts = decode ? bek_alloc(&job->allocator, job->planned * sizeof(size_t)) : NULL;
+    if (job->input_offsets == NULL || job->output_offsets == NULL || (decode && job->counts == NULL)) {
+        return BEK_ERROR_MEMORY;
+    }
+
+    for (size_t index = 0; index <= job->chunk_count; ++index) {
+        const size_t offset = index * chunk_size;
+        job->input_offsets[index] = offset < job->input_length ? offset : job->input_length;
+    }
+    return BEK_SUCCESS;
+}
+
+static bek_error_t transcode_file(const bek_codec_t *codec,
+                                  const char *input_path,
+                                  const char *output_path,
+                                  const bek_file_options_t *options,
+                                  const int decode) {
+    const bek_codec_desc_t *desc = bek_codec_desc(codec);
+    if (desc == NULL || input_path == NULL || output_path == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    const unsigned threads = options != NULL && options->threads > 1 ? options->threads : 1;
+    size_t chunk_size = options != NULL && options->chunk_size > 0 ? options->chunk_size : BEK_FILE_DEFAULT_CHUNK_SIZE;
+
+    file_job_t job = {0};
+    job.codec = codec;
+    job.desc = desc;
+    job.allocator = bek_allocator(NULL);
+
+    int input_fd = -1, output_fd = -1;
+    size_t output_length = 0;
+    bek_error_t error = map_input(input_path, &input_fd, &job.input, &job.input_length);
+
+    if (error == BEK_SUCCESS) {
+        if (!decode) chunk_size = bek_encode_chunk_size(codec, chunk_size);
+        if (chunk_size < desc->group_chars) chunk_size = desc->group_chars;
+        error = split_input(&job, chunk_size, decode);
+    }
+
+    if (error == BEK_SUCCESS && decode) {
+        error = run_chunks(&job, count_chunk, threads);
+        job.chunk_count = bek_align_decode_chunks(desc, job.input, job.input_length, job.counts, job.chunk_count,
+                                                  job.input_offsets, job.output_offsets);
+    } else if (error == BEK_SUCCESS) {
+        // Full chunks end on a line boundary, so their output sizes are equal
+        size_t chunk_output;
+        bek_get_encode_size(codec, chunk_size, &chunk_output);
+        for (size_t index = 0; index < job.chunk_count; ++index) {
+            job.output_offsets[index] = index * chunk_output;
+        }
+        bek_get_encode_size(codec, job.input_length, &job.output_offsets[job.chunk_count]);
+    }
+
+    if (error == BEK_SUCCESS) {
+        output_length = job.output_offsets[job.chunk_count];
+        error = map_output(output_path, output_length, &output_fd, &job.output);
+    }
+
+    if (error == BEK_SUCCESS && output_length > 0) {
+        error = run_chunks(&job, decode ? decode_chunk : encode_chunk, threads);
+    }
+
+    // Keep errno from the first failure across the cleanup calls
+    int saved_errno = errno;
+
+    if (job.output != NULL) munmap(job.output, output_length);
+    if (job.input != NULL) munmap((void *) job.input, job.input_length);
+
+    if (error == BEK_SUCCESS && decode && output_length > 0) {
+        const size_t actual = job.output_offsets[job.chunk_count - 1] + job.last_length;
+        if (ftruncate(output_fd, (off_t) actual) != 0) {
+            error = BEK_ERROR_IO;
+            saved_errno = errno;
+        }
+    }
+    if (output_fd >= 0 && close(output_fd) != 0 && error == BEK_SUCCESS) {
+        error = BEK_ERROR_IO;
+        saved_errno = errno;
+    }
+    if (input_fd >= 0) close(input_fd);
+
+    bek_free(&job.allocator, job.input_offsets, (job.planned + 1) * sizeof(size_t));
+    bek_free(&job.allocator, job.output_offsets, (job.planned + 1) * sizeof(size_t));
+    bek_free(&job.allocator, job.counts, job.planned * sizeof(size_t));
+
+    errno = saved_errno;
+    return error;
+}
+
+bek_error_t bek_encode_file(const bek_codec_t *codec,
+                            const char *input_path,
+                            const char *output_path,
+                            const bek_file_options_t *options) {
+    return transcode_file(codec, input_path, output_path, options, 0);
+}
+
+bek_error_t bek_decode_file(const bek_codec_t *codec,
+                            const char *input_path,
+                            const char *output_path,
+                            const bek_file_options_t *options) {
+    return transcode_file(codec, input_path, output_path, options, 1);
+}
@@ -0,0 +1,25 @@
+#ifndef BEK_INTERNAL_ALLOC_H
+#define BEK_INTERNAL_ALLOC_H
+
+#include <stddef.h>
+
+#include "bek.h"
+
+// Every allocation of the library goes through these. An allocator of NULL
+// means the library allocator installed with bek_set_allocator(), malloc/free
+// by default. Blocks must be freed with the allocator and size they were
+// allocated with; objects that outlive a call keep a copy of the resolved
+// allocator (bek_allocator) for that.
+
+// The allocator NULL stands for at this moment
+bek_allocator_t bek_allocator(const bek_allocator_t *allocator);
+
+void *bek_alloc(const bek_allocator_t *allocator, size_t size);
+
+// Zeroed array of count elements; NULL on overflow
+void *bek_calloc(const bek_allocator_t *allocator, size_t count, size_t size);
+
+// No-op for NULL
+void bek_free(const bek_allocator_t *allocator, void *ptr, size_t size);
+
+#endif //BEK_INTERNAL_ALLOC_H
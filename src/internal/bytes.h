@@ -0,0 +1,76 @@
+#ifndef BEK_INTERNAL_BYTES_H
+#define BEK_INTERNAL_BYTES_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Big-endian word access, plus the little-endian load CRC-32C works on.
+// Compilers fold these into a single load/store plus byte swap, so the kernels
+// stay portable without intrinsics.
+
+static inline uint64_t load_be64(const uint8_t *p) {
+    return ((uint64_t) p[0] << 56) | ((uint64_t) p[1] << 48) |
+           ((uint64_t) p[2] << 40) | ((uint64_t) p[3] << 32) |
+           ((uint64_t) p[4] << 24) | ((uint64_t) p[5] << 16) |
+           ((uint64_t) p[6] << 8) | (uint64_t) p[7];
+}
+
+static inline uint32_t load_be32(const uint8_t *p) {
+    return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | (uint32_t) p[3];
+}
+
+static inline uint64_t load_le64(const uint8_t *p) {
+    return (uint64_t) p[0] | ((uint64_t) p[1] << 8) |
+           ((uint64_t) p[2] << 16) | ((uint64_t) p[3] << 24) |
+           ((uint64_t) p[4] << 32) | ((uint64_t) p[5] << 40) |
+           ((uint64_t) p[6] << 48) | ((uint64_t) p[7] << 56);
+}
+
+static inline void store_be64(uint8_t *p, const uint64_t v) {
+    p[0] = (uint8_t) (v >> 56);
+    p[1] = (uint8_t) (v >> 48);
+    p[2] = (uint8_t) (v >> 40);
+    p[3] = (uint8_t) (v >> 32);
+    p[4] = (uint8_t) (v >> 24);
+    p[5] = (uint8_t) (v >> 16);
+    p[6] = (uint8_t) (v >> 8);
+    p[7] = (uint8_t) v;
+}
+
+static inline void store_be32(uint8_t *p, const uint32_t v) {
+    p[0] = (uint8_t) (v >> 24);
+    p[1] = (uint8_t) (v >> 16);
+    p[2] = (uint8_t) (v >> 8);
+    p[3] = (uint8_t) v;
+}
+
+static inline void store_be24(uint8_t *p, const uint32_t v) {
+    p[0] = (uint8_t) (v >> 16);
+    p[1] = (uint8_t) (v >> 8);
+    p[2] = (uint8_t) v;
+}
+
+// Mask keeping the first n bytes (0..8) of a big-endian word
+static inline uint64_t be64_prefix_mask(const size_t n) {
+    return n == 0 ? 0 : UINT64_MAX << (8 * (8 - n));
+}
+
+// UTF-16 text, for the *_utf16 entry points. Code units are native-endian
+// uint16_t, as held by JavaScript engines and the JVM.
+
+// Eight code units narrowed to a character word in load_be64 order; returns
+// the units ORed together, so anything above 0xFF shows in the high byte
+static inline uint16_t load_narrow_be64(const uint16_t *p, uint64_t *chars) {
+    *chars = ((uint64_t) (uint8_t) p[0] << 56) | ((uint64_t) (uint8_t) p[1] << 48) |
+             ((uint64_t) (uint8_t) p[2] << 40) | ((uint64_t) (uint8_t) p[3] << 32) |
+             ((uint64_t) (uint8_t) p[4] << 24) | ((uint64_t) (uint8_t) p[5] << 16) |
+             ((uint64_t) (uint8_t) p[6] << 8) | (uint64_t) (uint8_t) p[7];
+    return (uint16_t) (p[0] | p[1] | p[2] | p[3] | p[4] | p[5] | p[6] | p[7]);
+}
+
+// Character i of narrow (char) or wide (UTF-16) text
+static inline unsigned text_at(const void *text, const int wide, const size_t i) {
+    return wide ? ((const uint16_t *) text)[i] : ((const uint8_t *) text)[i];
+}
+
+#endif //BEK_INTERNAL_BYTES_H
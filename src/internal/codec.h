@@ -0,0 +1,19 @@
+#ifndef BEK_INTERNAL_CODEC_H
+#define BEK_INTERNAL_CODEC_H
+
+#include "bek_codec.h"
+#include "stream.h"
+
+// Engine descriptors of each codec context
+const bek_codec_desc_t *base64_desc(const base64_ctx_t *ctx);
+const bek_codec_desc_t *base32_desc(const base32_ctx_t *ctx);
+const bek_codec_desc_t *base16_desc(const base16_ctx_t *ctx);
+const bek_codec_desc_t *base85_desc(const base85_ctx_t *ctx);
+
+// Context-free descriptor of the PEM flavour of base64
+const bek_codec_desc_t *base64_pem_desc(void);
+
+// Engine descriptor behind a codec handle, NULL if the handle is invalid
+const bek_codec_desc_t *bek_codec_desc(const bek_codec_t *codec);
+
+#endif //BEK_INTERNAL_CODEC_H
@@ -0,0 +1,116 @@
+#ifndef BEK_INTERNAL_IGNORE_H
+#define BEK_INTERNAL_IGNORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bytes.h"
+#include "swar.h"
+
+// Characters the one-shot decoders skip, as a 256-bit set built at init. The
+// compaction prefilter flags every character within [low, high], the range
+// spanned by the set below 0x80, and every character from 0x80 up; only those
+// are looked up in the set.
+
+typedef struct {
+    uint64_t bits[4];
+    uint8_t low;
+    uint8_t high;
+} bek_ignore_t;
+
+static inline void bek_ignore_init(bek_ignore_t *set, const char *chars) {
+    memset(set, 0, sizeof(*set));
+    set->low = 0x7F;
+    for (const uint8_t *c = (const uint8_t *) chars; *c != '\0'; c++) {
+        set->bits[*c >> 6] |= 1ULL << (*c & 63);
+        if (*c < 0x80 && *c < set->low) set->low = *c;
+        if (*c < 0x80 && *c > set->high) set->high = *c;
+    }
+    if (set->low > set->high) {
+        // Nothing below 0x80: an empty range
+        set->low = 1;
+        set->high = 0;
+    }
+}
+
+static inline int bek_ignored(const bek_ignore_t *set, const uint8_t c) {
+    return (int) (set->bits[c >> 6] >> (c & 63)) & 1;
+}
+
+// Characters compacted per step: big enough to amortise the block setup, small
+// enough to stay in L1 between the compaction and the decode kernel
+#define BEK_COMPACT_BLOCK 4096
+
+// Copy input to block up to capacity characters, dropping the ignore set, and
+// store the number of input characters consumed in *taken. Eight characters
+// are tested at a time against the set's range: words with nothing flagged are
+// copied whole, the others up to the first flagged lane and then lane by lane
+// without branches, every lane stored and the output position advanced past
+// the ones kept. Characters that are
+// not ignored, padding and invalid input included, are kept for the decoder to
+// judge. block needs capacity + 8 bytes. Returns the number of characters
+// kept.
+static inline size_t bek_compact(const bek_ignore_t *set, const char *input, const size_t length,
+                                 char *block, const size_t capacity, size_t *taken) {
+    size_t i = 0, kept = 0;
+    for (; BEK_SWAR && i + 8 <= length && kept + 8 <= capacity; i += 8) {
+        const uint64_t chars = load_be64((const uint8_t *) input + i);
+        const uint64_t flags = (swar_in_range(chars & SWAR_LOW7, set->low, set->high) | chars) & SWAR_HIGH;
+        memcpy(block + kept, input + i, 8);
+        if (flags == 0) {
+            kept += 8;
+            continue;
+        }
+        const unsigned first = swar_first_flagged(flags);
+        kept += first;
+        for (unsigned k = first; k < 8; k++) {
+            const uint8_t c = (uint8_t) input[i + k];
+            block[kept] = (char) c;
+            kept += (size_t) !bek_ignored(set, c);
+        }
+    }
+    for (; i < length && kept < capacity; i++) {
+        block[kept] = input[i];
+        kept += (size_t) !bek_ignored(set, (uint8_t) input[i]);
+    }
+    *taken = i;
+    return kept;
+}
+
+// bek_compact for UTF-16 input: each code unit is narrowed to a character as
+// it is copied, so the decode kernels never see the wide text. *wide is set if
+// any unit consumed is above 0xFF; the block is then meaningless and the
+// caller falls back to its character loop, which rejects the unit.
+static inline size_t bek_compact16(const bek_ignore_t *set, const uint16_t *input, const size_t length,
+                                   char *block, const size_t capacity, size_t *taken, int *wide) {
+    size_t i = 0, kept = 0;
+    uint16_t units = 0;
+    for (; BEK_SWAR && i + 8 <= length && kept + 8 <= capacity; i += 8) {
+        uint64_t chars;
+        units |= load_narrow_be64(input + i, &chars);
+        const uint64_t flags = (swar_in_range(chars & SWAR_LOW7, set->low, set->high) | chars) & SWAR_HIGH;
+        store_be64((uint8_t *) block + kept, chars);
+        if (flags == 0) {
+            kept += 8;
+            continue;
+        }
+        const unsigned first = swar_first_flagged(flags);
+        kept += first;
+        for (unsigned k = first; k < 8; k++) {
+            const uint8_t c = (uint8_t) input[i + k];
+            block[kept] = (char) c;
+            kept += (size_t) !bek_ignored(set, c);
+        }
+    }
+    for (; i < length && kept < capacity; i++) {
+        units |= input[i];
+        block[kept] = (char) (uint8_t) input[i];
+        kept += (size_t) !bek_ignored(set, (uint8_t) input[i]);
+    }
+    *taken = i;
+    *wide = units > 0xFF;
+    return kept;
+}
+
+#endif //BEK_INTERNAL_IGNORE_H
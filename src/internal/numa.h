@@ -0,0 +1,17 @@
+#ifndef BEK_INTERNAL_NUMA_H
+#define BEK_INTERNAL_NUMA_H
+
+#include "bek.h"
+
+// Node of every CPU, -1 for CPUs that are not online; a single node 0 when
+// the kernel reports no NUMA layout. *cpu_nodes holds *cpu_count entries and
+// is allocated with allocator.
+bek_error_t bek_numa_cpu_nodes(const bek_allocator_t *allocator, int **cpu_nodes, unsigned *cpu_count);
+
+// page_node of the system topology; negative for pages not faulted in yet
+int bek_numa_page_node(void *user_data, const void *address);
+
+// Pin the calling thread to cpu; non-zero if it could not be
+int bek_numa_pin(unsigned cpu);
+
+#endif //BEK_INTERNAL_NUMA_H
@@ -0,0 +1,21 @@
+#ifndef BEK_INTERNAL_SPLIT_H
+#define BEK_INTERNAL_SPLIT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stream.h"
+
+// Number of characters in input that the decoder does not skip
+size_t bek_count_significant(const bek_codec_desc_t *desc, const uint8_t *input, size_t length);
+
+// Move raw chunk boundaries forward so every chunk but the last decodes whole
+// quanta, and fill in where each chunk lands in the output. input_offsets
+// holds chunk_count + 1 raw boundaries and counts the significant characters
+// between them; output_offsets receives chunk_count + 1 entries, the last one
+// being the maximum decoded size. Returns the possibly smaller chunk count.
+size_t bek_align_decode_chunks(const bek_codec_desc_t *desc, const uint8_t *input, size_t length,
+                               const size_t *counts, size_t chunk_count,
+                               size_t *input_offsets, size_t *output_offsets);
+
+#endif //BEK_INTERNAL_SPLIT_H
@@ -0,0 +1,93 @@
+#ifndef BEK_INTERNAL_STREAM_H
+#define BEK_INTERNAL_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include "bek.h"
+#include "ignore.h"
+
+// Decode table classes; alphabet values are always below 0x80
+#define BEK_CLASS_ZERO 0xFC
+#define BEK_CLASS_PAD 0xFD
+#define BEK_CLASS_SPACE 0xFE
+#define BEK_CLASS_INVALID 0xFF
+
+// Everything the shared engine needs to know about a codec configuration
+typedef struct {
+    const char *alphabet;          // Encode alphabet
+    const uint8_t *decode_table;   // Alphabet index or BEK_CLASS_* per character
+    const bek_ignore_t *ignore;    // Characters decoders skip (NULL for BEK_CLASS_SPACE)
+    unsigned bits_per_char;        // 6, 5 or 4; unused when radix is set
+    unsigned radix;                // 85 for base85 digits, 0 for bit-packed alphabets
+    int zero_groups;               // BEK_CLASS_ZERO stands for a quantum of zero bytes
+    unsigned group_bytes;          // Bytes per quantum
+    unsigned group_chars;          // Characters per quantum
+    int use_padding;
+    size_t line_length;            // 0 for no line breaks
+    const char *line_ending;
+    bek_store_mode_t stores;       // Output stores of one-shot encodes
+
+    // Bulk kernels over whole quanta without line breaks. decode_groups stops
+    // before the first quantum containing a non-alphabet character and returns
+    // the number of quanta decoded.
+    void (*encode_groups)(const char *alphabet, const uint8_t *input, size_t groups, char *output);
+    size_t (*decode_groups)(const uint8_t *table, const char *input, size_t groups, uint8_t *output);
+} bek_codec_desc_t;
+
+// Whether decoders step over c without counting it
+static inline int bek_skipped(const bek_codec_desc_t *desc, const uint8_t c) {
+    return desc->ignore != NULL ? bek_ignored(desc->ignore, c) : desc->decode_table[c] == BEK_CLASS_SPACE;
+}
+
+bek_error_t bek_encode_update(const bek_codec_desc_t *desc, bek_stream_t *stream,
+                               const uint8_t *input, size_t input_length, size_t *input_consumed,
+                               char *output, size_t output_size, size_t *output_length);
+
+bek_error_t bek_encode_final(const bek_codec_desc_t *desc, bek_stream_t *stream,
+                              char *output, size_t output_size, size_t *output_length);
+
+// Whether one-shot encodes should use bek_encode_nontemporal
+int bek_use_nontemporal(const bek_codec_desc_t *desc);
+
+// One-shot encode that stages output in L1 and writes it out with
+// non-temporal stores; output_size must hold the whole encoding
+bek_error_t bek_encode_nontemporal(const bek_codec_desc_t *desc,
+                                    const uint8_t *input, size_t input_length,
+                                    char *output, size_t output_size, size_t *output_length);
+
+bek_error_t bek_decode_update(const bek_codec_desc_t *desc, bek_stream_t *stream,
+                               const char *input, size_t input_length, size_t *input_consumed,
+                               uint8_t *output, size_t output_size, size_t *output_length);
+
+bek_error_t bek_decode_final(const bek_codec_desc_t *desc, bek_stream_t *stream,
+                              uint8_t *output, size_t output_size, size_t *output_length);
+
+bek_error_t bek_encode_iov(const bek_codec_desc_t *desc,
+                            const struct iovec *input, int input_count,
+                            const struct iovec *output, int output_count,
+                            size_t *output_length);
+
+bek_error_t bek_decode_iov(const bek_codec_desc_t *desc,
+                            const struct iovec *input, int input_count,
+                            const struct iovec *output, int output_count,
+                            size_t *output_length);
+
+bek_error_t bek_encode_to_sink(const bek_codec_desc_t *desc,
+                                const uint8_t *input, size_t input_length,
+                                bek_sink_fn sink, void *user_data);
+
+bek_error_t bek_decode_to_sink(const bek_codec_desc_t *desc,
+                                const char *input, size_t input_length,
+                                bek_sink_fn sink, void *user_data);
+
+bek_error_t bek_encode_ring(const bek_codec_desc_t *desc,
+                             const bek_ring_t *input, bek_ring_t *output,
+                             size_t *output_length);
+
+bek_error_t bek_decode_ring(const bek_codec_desc_t *desc,
+                             const bek_ring_t *input, bek_ring_t *output,
+                             size_t *output_length);
+
+#endif //BEK_INTERNAL_STREAM_H
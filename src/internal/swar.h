@@ -0,0 +1,142 @@
+#ifndef BEK_INTERNAL_SWAR_H
+#define BEK_INTERNAL_SWAR_H
+
+#include <stdint.h>
+
+// SIMD-within-a-register kernels: eight characters are classified and
+// converted per 64-bit word with plain integer arithmetic, so they work on any
+// target without vector instructions. Characters are held big-endian, first
+// character in the most significant byte (see load_be64).
+//
+// Each classify kernel writes the alphabet value of every character into the
+// matching byte of *values and returns non-zero if any character is outside
+// the alphabet; *values is meaningless in that case. The pack kernels then
+// squeeze the per-byte values into contiguous bits.
+//
+// They replace the branchy per-character loops of the whole-buffer decoders and
+// the base32 table gathers. The base64 and hex slop and streaming kernels keep
+// their table gathers, which measured faster (bench_swar) on x86-64.
+// Defining BEK_NO_SWAR makes the codecs fall back to their byte loops.
+
+#ifdef BEK_NO_SWAR
+#define BEK_SWAR 0
+#else
+#define BEK_SWAR 1
+#endif
+
+#define SWAR_ONES 0x0101010101010101ULL
+#define SWAR_HIGH 0x8080808080808080ULL
+#define SWAR_LOW7 0x7F7F7F7F7F7F7F7FULL
+
+// The range tests below work on 7-bit lanes so that adding a per-lane constant
+// below 0x80 never carries into the next lane; callers reject characters with
+// the top bit set separately.
+
+// 0x80 in every 7-bit lane of x that is at least c, garbage in the low bits
+static inline uint64_t swar_at_least(const uint64_t x, const uint64_t c) {
+    return x + (0x80 - c) * SWAR_ONES;
+}
+
+// 0x80 in every 7-bit lane of x within [low, high]
+static inline uint64_t swar_in_range(const uint64_t x, const uint64_t low, const uint64_t high) {
+    return swar_at_least(x, low) & ~swar_at_least(x, high + 1) & SWAR_HIGH;
+}
+
+// 0x80 in every 7-bit lane of x equal to c
+static inline uint64_t swar_equal(const uint64_t x, const uint64_t c) {
+    const uint64_t zero = x ^ c * SWAR_ONES;
+    return ~((zero + SWAR_LOW7) | zero) & SWAR_HIGH;
+}
+
+// 0x01 in every lane flagged with 0x80
+static inline uint64_t swar_lsb(const uint64_t flags) {
+    return flags >> 7;
+}
+
+// Index of the first lane flagged with 0x80, counting from the most
+// significant byte; flags must not be zero
+static inline unsigned swar_first_flagged(const uint64_t flags) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned) __builtin_clzll(flags) / 8;
+#else
+    unsigned lane = 0;
+    while (!(flags & (0x80ULL << (56 - 8 * lane)))) lane++;
+    return lane;
+#endif
+}
+
+// Hex digits of either case -> nibble values
+static inline uint64_t swar_hex_classify(const uint64_t chars, uint64_t *values) {
+    const uint64_t x = chars & SWAR_LOW7;
+    const uint64_t folded = x | 0x20 * SWAR_ONES;
+    const uint64_t valid = swar_in_range(x, '0', '9') | swar_in_range(folded, 'a', 'f');
+    // The low nibble of '0'-'9' is the value, that of 'A'-'F' and 'a'-'f' is
+    // value - 9; letters are the digits with bit 6 set
+    *values = (x & 0x0F * SWAR_ONES) + ((x >> 6) & SWAR_ONES) * 9;
+    return (valid & ~chars) ^ SWAR_HIGH;
+}
+
+// Base64 characters -> 6-bit values; url selects '-' and '_' over '+' and '/'
+static inline uint64_t swar_base64_classify(const uint64_t chars, const int url, uint64_t *values) {
+    const uint64_t x = chars & SWAR_LOW7;
+    const uint64_t letters = swar_in_range(x | 0x20 * SWAR_ONES, 'a', 'z');
+    const uint64_t digits = swar_in_range(x, '0', '9');
+    const uint64_t v62 = swar_equal(x, url ? '-' : '+');
+    const uint64_t v63 = swar_equal(x, url ? '_' : '/');
+
+    // Every class is x & 0x3F plus a small offset: letters lose 1 ('A' is 0x41)
+    // and another 6 when lowercase, so the subtraction never borrows across
+    // lanes of valid characters
+    const uint64_t base = x & 0x3F * SWAR_ONES;
+    const uint64_t lowercase = (x >> 5) & swar_lsb(letters);
+    const uint64_t add = swar_lsb(digits) * 4 +
+                         swar_lsb(v62) * (62 - ((url ? '-' : '+') & 0x3F)) +
+                         swar_lsb(v63) * (63 - ((url ? '_' : '/') & 0x3F));
+    *values = base + add - swar_lsb(letters) - lowercase * 6;
+    return ((letters | digits | v62 | v63) & ~chars) ^ SWAR_HIGH;
+}
+
+// Base32 characters -> 5-bit values; hex selects the extended hex alphabet
+static inline uint64_t swar_base32_classify(const uint64_t chars, const int hex, uint64_t *values) {
+    const uint64_t x = chars & SWAR_LOW7;
+    const uint64_t base = x & 0x1F * SWAR_ONES;
+    uint64_t valid;
+    if (hex) {
+        // '0'-'9' have low bits 16-25, 'A'-'V' have 1-22
+        const uint64_t digits = swar_in_range(x, '0', '9');
+        valid = digits | swar_in_range(x, 'A', 'V');
+        *values = base + 9 * SWAR_ONES - swar_lsb(digits) * 25;
+    } else {
+        // 'A'-'Z' have low bits 1-26, '2'-'7' have 18-23
+        const uint64_t digits = swar_in_range(x, '2', '7');
+        valid = digits | swar_in_range(x, 'A', 'Z');
+        *values = base + swar_lsb(digits) * 9 - SWAR_ONES;
+    }
+    return (valid & ~chars) ^ SWAR_HIGH;
+}
+
+// Eight nibbles -> 32 bits
+static inline uint32_t swar_pack4(uint64_t x) {
+    x = ((x & 0x0F000F000F000F00ULL) >> 4) | (x & 0x000F000F000F000FULL);
+    x = ((x & 0x00FF000000FF0000ULL) >> 8) | (x & 0x000000FF000000FFULL);
+    x = ((x & 0x0000FFFF00000000ULL) >> 16) | (x & 0x000000000000FFFFULL);
+    return (uint32_t) x;
+}
+
+// Eight 5-bit values -> 40 bits
+static inline uint64_t swar_pack5(uint64_t x) {
+    x = ((x & 0x1F001F001F001F00ULL) >> 3) | (x & 0x001F001F001F001FULL);
+    x = ((x & 0x03FF000003FF0000ULL) >> 6) | (x & 0x000003FF000003FFULL);
+    x = ((x & 0x000FFFFF00000000ULL) >> 12) | (x & 0x00000000000FFFFFULL);
+    return x;
+}
+
+// Eight 6-bit values -> 48 bits
+static inline uint64_t swar_pack6(uint64_t x) {
+    x = ((x & 0x3F003F003F003F00ULL) >> 2) | (x & 0x003F003F003F003FULL);
+    x = ((x & 0x0FFF00000FFF0000ULL) >> 4) | (x & 0x00000FFF00000FFFULL);
+    x = ((x & 0x00FFFFFF00000000ULL) >> 8) | (x & 0x0000000000FFFFFFULL);
+    return x;
+}
+
+#endif //BEK_INTERNAL_SWAR_H
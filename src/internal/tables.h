@@ -0,0 +1,30 @@
+#ifndef BEK_INTERNAL_TABLES_H
+#define BEK_INTERNAL_TABLES_H
+
+#include <stdint.h>
+
+// Encode alphabets of every supported variant
+extern const char bek_base64_standard_alphabet[65];
+extern const char bek_base64_url_alphabet[65];
+extern const char bek_base32_standard_alphabet[33];
+extern const char bek_base32_hex_alphabet[33];
+extern const char bek_base16_upper_alphabet[17];
+extern const char bek_base16_lower_alphabet[17];
+extern const char bek_ascii85_alphabet[86];
+extern const char bek_z85_alphabet[86];
+
+// Decode tables: alphabet index per character, or one of the BEK_CLASS_*
+// markers from stream.h
+extern const uint8_t bek_base64_standard_decode[256];
+extern const uint8_t bek_base64_url_decode[256];
+extern const uint8_t bek_base32_standard_decode[256];
+extern const uint8_t bek_base32_hex_decode[256];
+extern const uint8_t bek_base16_decode[256];
+extern const uint8_t bek_ascii85_decode[256];
+extern const uint8_t bek_z85_decode[256];
+
+// CRC-32C slicing tables: entry c of table k is the CRC of byte c followed by
+// k zero bytes
+extern const uint32_t bek_crc32c_table[8][256];
+
+#endif //BEK_INTERNAL_TABLES_H
@@ -0,0 +1,102 @@
+#include <stdalign.h>
+#include <string.h>
+
+#include "stream.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define NT_STORES 1
+#else
+#define NT_STORES 0
+#endif
+
+// Output is encoded into a stage that stays in L1 and leaves it a cache line
+// at a time; lines are written whole so the stores never read them back
+#define NT_LINE 64
+#define NT_STAGE 4096
+
+// How far the input is prefetched ahead of the encoder, about one stage. A
+// non-temporal prefetch hint this far ahead measured slower: the lines could
+// leave L1 before the encoder got to them.
+#define NT_PREFETCH 4096
+
+int bek_use_nontemporal(const bek_codec_desc_t *desc) {
+    return desc->stores == BEK_STORE_NONTEMPORAL;
+}
+
+// Copy to output, which has the same offset within a cache line as stage;
+// whole lines go around the cache, partial ones at either end do not
+static void store_out(char *output, const char *stage, size_t length) {
+    const size_t head = (NT_LINE - (uintptr_t) output % NT_LINE) % NT_LINE;
+    if (!NT_STORES || length < head + NT_LINE) {
+        memcpy(output, stage, length);
+        return;
+    }
+    memcpy(output, stage, head);
+    output += head;
+    stage += head;
+    length -= head;
+
+#if NT_STORES
+    for (; length >= NT_LINE; length -= NT_LINE, output += NT_LINE, stage += NT_LINE) {
+        const __m128i *from = (const __m128i *) stage;
+        __m128i *to = (__m128i *) output;
+        _mm_stream_si128(to, _mm_load_si128(from));
+        _mm_stream_si128(to + 1, _mm_load_si128(from + 1));
+        _mm_stream_si128(to + 2, _mm_load_si128(from + 2));
+        _mm_stream_si128(to + 3, _mm_load_si128(from + 3));
+    }
+#endif
+    memcpy(output, stage, length);
+}
+
+bek_error_t bek_encode_nontemporal(const bek_codec_desc_t *desc,
+                                    const uint8_t *input, const size_t input_length,
+                                    char *output, const size_t output_size, size_t *output_length) {
+    alignas(NT_LINE) char stage[NT_STAGE];
+    bek_stream_t stream;
+    bek_stream_init(&stream);
+
+    // Stage offsets mirror output addresses modulo the line size, so only
+    // the first and last lines are partial
+    size_t begin = (uintptr_t) output % NT_LINE;
+    size_t used = begin;
+    size_t in = 0, out = 0, prefetched = 0;
+    int done = 0;
+
+    while (!done) {
+        size_t consumed = 0, produced;
+        if (in < input_length) {
+#if defined(__GNUC__) || defined(__clang__)
+            const size_t ahead = input_length - in > NT_PREFETCH ? in + NT_PREFETCH : input_length;
+            for (; prefetched < ahead; prefetched += NT_LINE) {
+                __builtin_prefetch(input + prefetched, 0, 3);
+            }
+#endif
+            bek_encode_update(desc, &stream, input + in, input_length - in, &consumed,
+                              stage + used, NT_STAGE - used, &produced);
+            in += consumed;
+        } else {
+            done = bek_encode_final(desc, &stream, stage + used, NT_STAGE - used, &produced) == BEK_SUCCESS;
+        }
+        used += produced;
+
+        // Write out whole lines; a partial one waits for the next block
+        const size_t end = done ? used : used / NT_LINE * NT_LINE;
+        if (end > begin) {
+            if (out + (end - begin) > output_size) return BEK_ERROR_BUFFER_TOO_SMALL;
+            store_out(output + out, stage + begin, end - begin);
+            out += end - begin;
+            memmove(stage, stage + end, used - end);
+            used -= end;
+            begin = 0;
+        }
+    }
+
+#if NT_STORES
+    // Order the streamed lines before anything the caller stores next
+    _mm_sfence();
+#endif
+    *output_length = out;
+    return BEK_SUCCESS;
+}
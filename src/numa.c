@@ -0,0 +1,148 @@
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <bek_pool.h>
+
+#include "alloc.h"
+#include "numa.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+// Huge pages are 2 MiB on x86-64 and arm64 with 4 KiB base pages; outputs are
+// rounded up to them so MAP_HUGETLB accepts the length
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// Highest CPU number a cpu_set_t can describe
+#ifdef CPU_SETSIZE
+#define MAX_CPUS CPU_SETSIZE
+#else
+#define MAX_CPUS 1024
+#endif
+
+#ifdef __linux__
+// Mark the CPUs of a sysfs cpulist such as "0-3,8-11" as belonging to node
+static void parse_cpulist(const char *list, const int node, int *nodes, unsigned *count) {
+    const char *p = list;
+    while (*p >= '0' && *p <= '9') {
+        char *end;
+        const unsigned long first = strtoul(p, &end, 10);
+        unsigned long last = first;
+        if (*end == '-') last = strtoul(end + 1, &end, 10);
+        for (unsigned long cpu = first; cpu <= last && cpu < MAX_CPUS; ++cpu) {
+            nodes[cpu] = node;
+            if (cpu + 1 > *count) *count = (unsigned) cpu + 1;
+        }
+        p = *end == ',' ? end + 1 : end;
+    }
+}
+
+static unsigned read_sysfs_nodes(int *nodes) {
+    unsigned count = 0;
+    DIR *dir = opendir("/sys/devices/system/node");
+    if (dir == NULL) return 0;
+
+    const struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        unsigned node;
+        char tail;
+        if (sscanf(entry->d_name, "node%u%c", &node, &tail) != 1) continue;
+
+        char path[64], list[4096];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+        FILE *file = fopen(path, "r");
+        if (file == NULL) continue;
+        if (fgets(list, sizeof(list), file) != NULL) parse_cpulist(list, (int) node, nodes, &count);
+        fclose(file);
+    }
+    closedir(dir);
+    return count;
+}
+#endif
+
+bek_error_t bek_numa_cpu_nodes(const bek_allocator_t *allocator, int **cpu_nodes, unsigned *cpu_count) {
+    int nodes[MAX_CPUS];
+    for (unsigned cpu = 0; cpu < MAX_CPUS; ++cpu) nodes[cpu] = -1;
+
+    unsigned count = 0;
+#ifdef __linux__
+    count = read_sysfs_nodes(nodes);
+#endif
+    if (count == 0) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        count = online > 0 ? (unsigned) (online < MAX_CPUS ? online : MAX_CPUS) : 1;
+        for (unsigned cpu = 0; cpu < count; ++cpu) nodes[cpu] = 0;
+    }
+
+    *cpu_nodes = bek_alloc(allocator, count * sizeof(int));
+    if (*cpu_nodes == NULL) {
+        return BEK_ERROR_MEMORY;
+    }
+    memcpy(*cpu_nodes, nodes, count * sizeof(int));
+    *cpu_count = count;
+    return BEK_SUCCESS;
+}
+
+int bek_numa_page_node(void *user_data, const void *address) {
+    (void) user_data;
+#if defined(__linux__) && defined(SYS_move_pages)
+    // move_pages without target nodes only reports where each page is
+    const uintptr_t mask = (uintptr_t) sysconf(_SC_PAGESIZE) - 1;
+    const void *page = (const void *) ((uintptr_t) address & ~mask);
+    int status = -1;
+    if (syscall(SYS_move_pages, 0, 1UL, &page, NULL, &status, 0) != 0) return -1;
+    return status;
+#else
+    (void) address;
+    return -1;
+#endif
+}
+
+int bek_numa_pin(const unsigned cpu) {
+#ifdef __linux__
+    if (cpu >= MAX_CPUS) return -1;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void) cpu;
+    return -1;
+#endif
+}
+
+static size_t huge_length(const size_t size) {
+    return size > SIZE_MAX - HUGE_PAGE_SIZE ? 0 : (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+void *bek_pool_map_output(const size_t size) {
+    const size_t length = huge_length(size);
+    if (length == 0) return NULL;
+
+    void *data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    // Fails unless huge pages have been reserved
+    data = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (data == MAP_FAILED) {
+        data = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) return NULL;
+#ifdef MADV_HUGEPAGE
+        madvise(data, length, MADV_HUGEPAGE);
+#endif
+    }
+    return data;
+}
+
+void bek_pool_unmap_output(void *data, const size_t size) {
+    if (data != NULL) munmap(data, huge_length(size));
+}
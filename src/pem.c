@@ -0,0 +1,189 @@
+#include <string.h>
+
+#include <bek_pem.h>
+
+#include "codec.h"
+#include "stream.h"
+
+#define PEM_BEGIN "-----BEGIN "
+#define PEM_END "-----END "
+#define PEM_DASHES "-----"
+
+// RFC 7468 wraps the body at 64 characters: 16 quanta, 48 bytes
+#define PEM_LINE_CHARS 64
+#define PEM_LINE_GROUPS 16
+#define PEM_LINE_BYTES 48
+
+static int has_prefix(const char *p, const char *end, const char *prefix, const size_t length) {
+    return (size_t) (end - p) >= length && memcmp(p, prefix, length) == 0;
+}
+
+// Skip trailing blanks and one line ending; returns the start of the next
+// line, end at the end of the input, or NULL if anything else follows
+static const char *next_line(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    if (p == end) return p;
+    if (*p == '\n') return p + 1;
+    if (*p == '\r' && p + 1 < end && p[1] == '\n') return p + 2;
+    return NULL;
+}
+
+// First "-----" at or after p
+static const char *find_dashes(const char *p, const char *end) {
+    while ((p = memchr(p, '-', (size_t) (end - p))) != NULL) {
+        if (has_prefix(p, end, PEM_DASHES, 5)) return p;
+        p++;
+    }
+    return NULL;
+}
+
+bek_error_t bek_pem_next(const char *input,
+                         const size_t input_length,
+                         size_t *offset,
+                         bek_pem_block_t *block) {
+    if ((input == NULL && input_length > 0) || offset == NULL || block == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    const char *end = input + input_length;
+    const char *p = input + (*offset < input_length ? *offset : input_length);
+    memset(block, 0, sizeof(*block));
+
+    // A BEGIN line starts at a '-' that starts a line; anything else is
+    // explanatory text between blocks
+    const char *begin;
+    for (;;) {
+        begin = p < end ? memchr(p, '-', (size_t) (end - p)) : NULL;
+        if (begin == NULL) {
+            *offset = input_length;
+            return BEK_SUCCESS;
+        }
+        if ((begin == input || begin[-1] == '\n') && has_prefix(begin, end, PEM_BEGIN, 11)) break;
+        p = begin + 1;
+    }
+
+    const char *label = begin + 11;
+    const char *close = find_dashes(label, end);
+    const char *body = close != NULL ? next_line(close + 5, end) : NULL;
+    if (body == NULL) {
+        return BEK_ERROR_INVALID_INPUT;
+    }
+    const size_t label_length = (size_t) (close - label);
+
+    // '-' is not in the base64 alphabet, so the first one in the body starts
+    // the END line
+    const char *footer = memchr(body, '-', (size_t) (end - body));
+    if (footer == NULL || (footer > body && footer[-1] != '\n') ||
+        !has_prefix(footer, end, PEM_END, 9) ||
+        !has_prefix(footer + 9, end, label, label_length) ||
+        !has_prefix(footer + 9 + label_length, end, PEM_DASHES, 5)) {
+        return BEK_ERROR_INVALID_INPUT;
+    }
+    const char *after = next_line(footer + 14 + label_length, end);
+    if (after == NULL) {
+        return BEK_ERROR_INVALID_INPUT;
+    }
+
+    block->label = label;
+    block->label_length = label_length;
+    block->body = body;
+    block->body_length = (size_t) (footer - body);
+    *offset = (size_t) (after - input);
+    return BEK_SUCCESS;
+}
+
+size_t bek_pem_get_decode_size(const bek_pem_block_t *block) {
+    return block != NULL ? (block->body_length + 3) / 4 * 3 : 0;
+}
+
+bek_error_t bek_pem_decode(const bek_pem_block_t *block,
+                           uint8_t *output,
+                           const size_t output_size,
+                           size_t *output_length) {
+    if (block == NULL || (block->body == NULL && block->body_length > 0) ||
+        (output == NULL && output_size > 0) || output_length == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    const bek_codec_desc_t *desc = base64_pem_desc();
+    const char *p = block->body;
+    const char *end = p + block->body_length;
+    size_t out = 0;
+
+    // Full lines: 16 quanta, then the line ending at its fixed offset. The
+    // last line, padding and other wrap widths drop to the general decoder.
+    while (end - p > PEM_LINE_CHARS && output_size - out >= PEM_LINE_BYTES) {
+        const char *eol = p + PEM_LINE_CHARS;
+        const size_t eol_length = *eol == '\n' ? 1 : *eol == '\r' && eol + 1 < end && eol[1] == '\n' ? 2 : 0;
+        if (eol_length == 0 ||
+            desc->decode_groups(desc->decode_table, p, PEM_LINE_GROUPS, output + out) != PEM_LINE_GROUPS) {
+            break;
+        }
+        out += PEM_LINE_BYTES;
+        p = eol + eol_length;
+    }
+
+    bek_stream_t stream;
+    size_t consumed, produced, tail = 0;
+    bek_stream_init(&stream);
+    bek_error_t error = bek_decode_update(desc, &stream, p, (size_t) (end - p), &consumed,
+                                          output + out, output_size - out, &produced);
+    if (error == BEK_SUCCESS && consumed < (size_t) (end - p)) {
+        error = BEK_ERROR_BUFFER_TOO_SMALL;
+    }
+    if (error == BEK_SUCCESS) {
+        error = bek_decode_final(desc, &stream, output + out + produced, output_size - out - produced, &tail);
+    }
+
+    *output_length = out + produced + tail;
+    return error;
+}
+
+size_t bek_pem_get_encode_size(const size_t label_length, const size_t input_length) {
+    const size_t chars = (input_length + 2) / 3 * 4;
+    const size_t lines = (chars + PEM_LINE_CHARS - 1) / PEM_LINE_CHARS;
+    return (11 + label_length + 6) + chars + lines + (9 + label_length + 6);
+}
+
+static char *append(char *output, const char *text, const size_t length) {
+    memcpy(output, text, length);
+    return output + length;
+}
+
+bek_error_t bek_pem_encode(const char *label,
+                           const uint8_t *input,
+                           const size_t input_length,
+                           char *output,
+                           const size_t output_size,
+                           size_t *output_length) {
+    if (label == NULL || (input == NULL && input_length > 0) || output == NULL || output_length == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    const size_t label_length = strlen(label);
+    if (output_size < bek_pem_get_encode_size(label_length, input_length)) {
+        return BEK_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    char *o = append(output, PEM_BEGIN, 11);
+    o = append(o, label, label_length);
+    o = append(o, PEM_DASHES "\n", 6);
+
+    // The wrapped base64 path ends every full line itself
+    const bek_codec_desc_t *desc = base64_pem_desc();
+    bek_stream_t stream;
+    size_t consumed, produced, tail;
+    bek_stream_init(&stream);
+    bek_encode_update(desc, &stream, input, input_length, &consumed, o, output_size - (size_t) (o - output), &produced);
+    o += produced;
+    bek_encode_final(desc, &stream, o, output_size - (size_t) (o - output), &tail);
+    o += tail;
+    if (o[-1] != '\n') *o++ = '\n';
+
+    o = append(o, PEM_END, 9);
+    o = append(o, label, label_length);
+    o = append(o, PEM_DASHES "\n", 6);
+
+    *output_length = (size_t) (o - output);
+    return BEK_SUCCESS;
+}
@@ -0,0 +1,605 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <bek_pool.h>
+
+#include "alloc.h"
+#include "codec.h"
+#include "numa.h"
+#include "split.h"
+
+typedef enum {
+    TASK_BATCH = 0, // Run jobs [job, job + count) whole
+    TASK_SPLIT,     // Cut one large job into pieces
+    TASK_PIECE      // Run one piece of a split job
+} task_kind_t;
+
+typedef struct {
+    task_kind_t kind;
+    size_t job;
+    size_t count;
+    size_t input_offset;
+    size_t input_length;
+    size_t output_offset;
+    size_t output_size;
+    int last;       // Final piece of a split job
+    int node;       // Node holding the piece's input, negative if unknown
+} task_t;
+
+// Mutex-protected deque: the owner works at the bottom, thieves take the top
+typedef struct {
+    pthread_mutex_t lock;
+    task_t *tasks;
+    size_t capacity;
+    size_t top;
+    size_t length;
+} task_deque_t;
+
+typedef struct {
+    int split;          // Job runs as pieces and its status lives here
+    atomic_int status;  // First error among the pieces
+} job_state_t;
+
+struct bek_pool_t {
+    unsigned thread_count;     // Including the caller of bek_pool_run
+    unsigned deque_count;      // Allocated deques and thread slots
+    pthread_t *threads;
+    task_deque_t *deques;      // One per thread, the caller's is last
+    atomic_uint next_index;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    atomic_size_t queued;      // Tasks sitting in deques
+    atomic_size_t outstanding; // Tasks queued or running
+    int shutdown;
+
+    bek_job_t *jobs;
+    job_state_t *states;
+    bek_allocator_t allocator; // Resolved when the pool is created
+
+    // NUMA placement; thread_nodes is NULL unless created NUMA-aware
+    int *thread_nodes;         // Node of each thread, negative for the caller's
+    unsigned *thread_cpus;     // CPU each worker pins itself to
+    int (*page_node)(void *user_data, const void *address);
+    void *page_user_data;
+    atomic_uint next_placed;   // Round-robin position for placing pieces
+
+    atomic_size_t pieces;
+    atomic_size_t pieces_placed;
+    atomic_size_t pieces_local;
+};
+
+static int deque_push(const bek_allocator_t *allocator, task_deque_t *deque, const task_t *task) {
+    pthread_mutex_lock(&deque->lock);
+    if (deque->length == deque->capacity) {
+        const size_t capacity = deque->capacity ? deque->capacity * 2 : 64;
+        task_t *tasks = bek_alloc(allocator, capacity * sizeof(task_t));
+        if (tasks == NULL) {
+            pthread_mutex_unlock(&deque->lock);
+            return -1;
+        }
+        for (size_t i = 0; i < deque->length; ++i) {
+            tasks[i] = deque->tasks[(deque->top + i) % deque->capacity];
+        }
+        bek_free(allocator, deque->tasks, deque->capacity * sizeof(task_t));
+        deque->tasks = tasks;
+        deque->capacity = capacity;
+        deque->top = 0;
+    }
+    deque->tasks[(deque->top + deque->length) % deque->capacity] = *task;
+    deque->length++;
+    pthread_mutex_unlock(&deque->lock);
+    return 0;
+}
+
+static int deque_pop_bottom(task_deque_t *deque, task_t *task) {
+    int found = 0;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->length > 0) {
+        deque->length--;
+        *task = deque->tasks[(deque->top + deque->length) % deque->capacity];
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+static int deque_steal_top(task_deque_t *deque, task_t *task) {
+    int found = 0;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->length > 0) {
+        *task = deque->tasks[deque->top];
+        deque->top = (deque->top + 1) % deque->capacity;
+        deque->length--;
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+static void wake_all(bek_pool_t *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_broadcast(&pool->changed);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static void execute_task(bek_pool_t *pool, unsigned self, const task_t *task);
+
+// Queue a task on a thread's deque, running it inline if the deque cannot grow
+static void schedule(bek_pool_t *pool, const unsigned self, const unsigned target, const task_t *task) {
+    atomic_fetch_add(&pool->outstanding, 1);
+    atomic_fetch_add(&pool->queued, 1);
+    if (deque_push(&pool->allocator, &pool->deques[target], task) != 0) {
+        atomic_fetch_sub(&pool->queued, 1);
+        atomic_fetch_sub(&pool->outstanding, 1);
+        execute_task(pool, self, task);
+    }
+}
+
+static int find_task(bek_pool_t *pool, const unsigned self, task_t *task) {
+    int found = deque_pop_bottom(&pool->deques[self], task);
+    // NUMA-aware pools steal from their own node before crossing to another
+    for (int pass = pool->thread_nodes != NULL ? 0 : 1; !found && pass < 2; ++pass) {
+        for (unsigned i = 1; !found && i < pool->thread_count; ++i) {
+            const unsigned victim = (self + i) % pool->thread_count;
+            if (pass == 0 && pool->thread_nodes[victim] != pool->thread_nodes[self]) continue;
+            found = deque_steal_top(&pool->deques[victim], task);
+        }
+    }
+    if (found) atomic_fetch_sub(&pool->queued, 1);
+    return found;
+}
+
+static void finish_task(bek_pool_t *pool) {
+    if (atomic_fetch_sub(&pool->outstanding, 1) == 1) {
+        wake_all(pool);
+    }
+}
+
+static void run_whole(const bek_pool_t *pool, const size_t index) {
+    bek_job_t *job = &pool->jobs[index];
+    job->output_length = 0;
+    job->status = job->op == BEK_JOB_DECODE
+                      ? bek_decode(job->codec, job->input, job->input_length,
+                                   job->output, job->output_size, &job->output_length)
+                      : bek_encode(job->codec, job->input, job->input_length,
+                                   job->output, job->output_size, &job->output_length);
+}
+
+static void fail_job(bek_pool_t *pool, const size_t index, const bek_error_t error) {
+    int expected = BEK_SUCCESS;
+    atomic_compare_exchange_strong(&pool->states[index].status, &expected, (int) error);
+}
+
+// Piece boundaries of a large decode job, aligned to whole quanta; the offset
+// arrays hold count + 1 entries and the aligned count is at most count
+static size_t plan_decode(const bek_allocator_t *allocator, const bek_job_t *job, const bek_codec_desc_t *desc,
+                          const size_t count, size_t *input_offsets, size_t *output_offsets) {
+    const uint8_t *input = job->input;
+    size_t *counts = bek_alloc(allocator, count * sizeof(size_t));
+    if (counts == NULL) {
+        return 0;
+    }
+
+    for (size_t i = 0; i <= count; ++i) {
+        const size_t offset = i * BEK_POOL_PIECE_SIZE;
+        input_offsets[i] = offset < job->input_length ? offset : job->input_length;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        counts[i] = bek_count_significant(desc, input + input_offsets[i], input_offsets[i + 1] - input_offsets[i]);
+    }
+
+    const size_t aligned = bek_align_decode_chunks(desc, input, job->input_length, counts, count,
+                                                   input_offsets, output_offsets);
+    bek_free(allocator, counts, count * sizeof(size_t));
+    return aligned;
+}
+
+// Thread to queue a piece on: the next worker of the node holding its input,
+// or the splitting thread if the node is unknown or has no workers
+static unsigned place_piece(bek_pool_t *pool, const unsigned self, task_t *piece) {
+    piece->node = -1;
+    if (pool->thread_nodes == NULL) return self;
+
+    const uint8_t *input = (const uint8_t *) pool->jobs[piece->job].input + piece->input_offset;
+    piece->node = pool->page_node(pool->page_user_data, input);
+    if (piece->node < 0) return self;
+
+    const unsigned start = atomic_fetch_add(&pool->next_placed, 1);
+    for (unsigned i = 0; i < pool->thread_count; ++i) {
+        const unsigned thread = (start + i) % pool->thread_count;
+        if (pool->thread_nodes[thread] == piece->node) {
+            atomic_fetch_add(&pool->pieces_placed, 1);
+            return thread;
+        }
+    }
+    return self;
+}
+
+static void split_job(bek_pool_t *pool, const unsigned self, const size_t index) {
+    bek_job_t *job = &pool->jobs[index];
+    const bek_codec_desc_t *desc = bek_codec_desc(job->codec);
+    if (desc == NULL || job->input == NULL || job->output == NULL) {
+        run_whole(pool, index);
+        return;
+    }
+
+    const int decode = job->op == BEK_JOB_DECODE;
+    const size_t piece = decode ? BEK_POOL_PIECE_SIZE : bek_encode_chunk_size(job->codec, BEK_POOL_PIECE_SIZE);
+    const size_t planned = (job->input_length + piece - 1) / piece;
+    const size_t offsets_size = (planned + 1) * sizeof(size_t);
+    size_t *input_offsets = bek_alloc(&pool->allocator, offsets_size);
+    size_t *output_offsets = bek_alloc(&pool->allocator, offsets_size);
+    size_t count = 0;
+    size_t required = 0;
+
+    if (input_offsets == NULL || output_offsets == NULL) {
+        // Leave count at 0
+    } else if (decode) {
+        count = plan_decode(&pool->allocator, job, desc, planned, input_offsets, output_offsets);
+        // Every piece but the last has an exact size that must fit
+        required = count > 0 ? output_offsets[count - 1] : 0;
+    } else {
+        size_t piece_output;
+        count = planned;
+        bek_get_encode_size(job->codec, piece, &piece_output);
+        for (size_t i = 0; i < count; ++i) {
+            input_offsets[i] = i * piece;
+            output_offsets[i] = i * piece_output;
+        }
+        input_offsets[count] = job->input_length;
+        bek_get_encode_size(job->codec, job->input_length, &output_offsets[count]);
+        required = output_offsets[count];
+    }
+
+    if (count == 0) {
+        // Out of memory for the plan; fall back to one piece
+        run_whole(pool, index);
+    } else if (job->output_size < required) {
+        job->output_length = 0;
+        job->status = BEK_ERROR_BUFFER_TOO_SMALL;
+    } else {
+        pool->states[index].split = 1;
+        atomic_store(&pool->states[index].status, BEK_SUCCESS);
+        job->output_length = output_offsets[count];
+
+        for (size_t i = 0; i < count; ++i) {
+            const size_t end = output_offsets[i + 1] < job->output_size ? output_offsets[i + 1] : job->output_size;
+            task_t piece = {
+                .kind = TASK_PIECE,
+                .job = index,
+                .input_offset = input_offsets[i],
+                .input_length = input_offsets[i + 1] - input_offsets[i],
+                .output_offset = output_offsets[i],
+                .output_size = end - output_offsets[i],
+                .last = i + 1 == count,
+            };
+            schedule(pool, self, place_piece(pool, self, &piece), &piece);
+        }
+        wake_all(pool);
+    }
+
+    bek_free(&pool->allocator, input_offsets, offsets_size);
+    bek_free(&pool->allocator, output_offsets, offsets_size);
+}
+
+static void run_piece(bek_pool_t *pool, const unsigned self, const task_t *task) {
+    bek_job_t *job = &pool->jobs[task->job];
+    const uint8_t *input = (const uint8_t *) job->input + task->input_offset;
+    uint8_t *output = (uint8_t *) job->output + task->output_offset;
+    size_t length;
+    bek_error_t error;
+
+    if (job->op == BEK_JOB_DECODE) {
+        error = bek_decode(job->codec, (const char *) input, task->input_length, output, task->output_size, &length);
+        // Padding may only shorten the final piece
+        if (error == BEK_SUCCESS && task->last) {
+            job->output_length = task->output_offset + length;
+        } else if (error == BEK_SUCCESS && length != task->output_size) {
+            error = BEK_ERROR_INVALID_INPUT;
+        }
+    } else {
+        error = bek_encode(job->codec, input, task->input_length, (char *) output, task->output_size, &length);
+    }
+
+    if (error != BEK_SUCCESS) fail_job(pool, task->job, error);
+
+    atomic_fetch_add(&pool->pieces, 1);
+    if (task->node >= 0 && pool->thread_nodes[self] == task->node) atomic_fetch_add(&pool->pieces_local, 1);
+}
+
+static void execute_task(bek_pool_t *pool, const unsigned self, const task_t *task) {
+    switch (task->kind) {
+        case TASK_BATCH:
+            for (size_t i = 0; i < task->count; ++i) {
+                run_whole(pool, task->job + i);
+            }
+            break;
+        case TASK_SPLIT:
+            split_job(pool, self, task->job);
+            break;
+        case TASK_PIECE:
+            run_piece(pool, self, task);
+            break;
+    }
+}
+
+static void *worker_main(void *arg) {
+    bek_pool_t *pool = arg;
+    const unsigned self = atomic_fetch_add(&pool->next_index, 1);
+    task_t task;
+
+    // Best effort: a CPU outside the affinity mask or a made-up topology
+    // leaves the worker unpinned
+    if (pool->thread_cpus != NULL) bek_numa_pin(pool->thread_cpus[self]);
+
+    for (;;) {
+        if (find_task(pool, self, &task)) {
+            execute_task(pool, self, &task);
+            finish_task(pool);
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->shutdown && atomic_load(&pool->queued) == 0) {
+            pthread_cond_wait(&pool->changed, &pool->lock);
+        }
+        const int shutdown = pool->shutdown;
+        pthread_mutex_unlock(&pool->lock);
+        if (shutdown) return NULL;
+    }
+}
+
+// Number of CPUs with a node; gaps in the CPU numbering have none
+static unsigned usable_cpus(const bek_numa_topology_t *topology) {
+    unsigned usable = 0;
+    for (unsigned cpu = 0; cpu < topology->cpu_count; ++cpu) {
+        if (topology->cpu_nodes[cpu] >= 0) usable++;
+    }
+    return usable;
+}
+
+// CPU at position k of the order that takes the first CPU of every node, then
+// the second of every node that has one, and so on; k must be below the
+// number of CPUs with a node
+static unsigned interleaved_cpu(const bek_numa_topology_t *topology, const int node_count, unsigned k) {
+    for (unsigned round = 0;; ++round) {
+        for (int node = 0; node < node_count; ++node) {
+            unsigned seen = 0;
+            for (unsigned cpu = 0; cpu < topology->cpu_count; ++cpu) {
+                if (topology->cpu_nodes[cpu] != node) continue;
+                if (seen++ == round) {
+                    if (k-- == 0) return cpu;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Spread the workers evenly over the nodes; the caller's thread stays unplaced
+static void place_threads(bek_pool_t *pool, const bek_numa_topology_t *topology) {
+    const unsigned usable = usable_cpus(topology);
+    int node_count = 0;
+    for (unsigned cpu = 0; cpu < topology->cpu_count; ++cpu) {
+        if (topology->cpu_nodes[cpu] >= node_count) node_count = topology->cpu_nodes[cpu] + 1;
+    }
+
+    for (unsigned i = 0; i < pool->deque_count; ++i) {
+        pool->thread_nodes[i] = -1;
+        pool->thread_cpus[i] = UINT_MAX;
+    }
+    for (unsigned i = 0; usable > 0 && i + 1 < pool->deque_count; ++i) {
+        const unsigned cpu = interleaved_cpu(topology, node_count, i % usable);
+        pool->thread_cpus[i] = cpu;
+        pool->thread_nodes[i] = topology->cpu_nodes[cpu];
+    }
+}
+
+// topology is NULL for a pool that ignores NUMA
+static bek_error_t pool_create(bek_pool_t **pool, const unsigned threads, const bek_numa_topology_t *topology) {
+    const bek_allocator_t allocator = bek_allocator(NULL);
+    *pool = bek_calloc(&allocator, 1, sizeof(bek_pool_t));
+    if (*pool == NULL) {
+        return BEK_ERROR_MEMORY;
+    }
+
+    bek_pool_t *p = *pool;
+    p->allocator = allocator;
+    p->thread_count = threads;
+    p->deque_count = threads;
+    p->deques = bek_calloc(&allocator, threads, sizeof(task_deque_t));
+    p->threads = bek_calloc(&allocator, threads, sizeof(pthread_t));
+    if (topology != NULL) {
+        p->thread_nodes = bek_alloc(&allocator, threads * sizeof(int));
+        p->thread_cpus = bek_alloc(&allocator, threads * sizeof(unsigned));
+    }
+    if (p->deques == NULL || p->threads == NULL ||
+        (topology != NULL && (p->thread_nodes == NULL || p->thread_cpus == NULL))) {
+        bek_free(&allocator, p->deques, threads * sizeof(task_deque_t));
+        bek_free(&allocator, p->threads, threads * sizeof(pthread_t));
+        bek_free(&allocator, p->thread_nodes, threads * sizeof(int));
+        bek_free(&allocator, p->thread_cpus, threads * sizeof(unsigned));
+        bek_free(&allocator, p, sizeof(bek_pool_t));
+        *pool = NULL;
+        return BEK_ERROR_MEMORY;
+    }
+    if (topology != NULL) {
+        place_threads(p, topology);
+        p->page_node = topology->page_node;
+        p->page_user_data = topology->user_data;
+    }
+
+    for (unsigned i = 0; i < threads; ++i) {
+        pthread_mutex_init(&p->deques[i].lock, NULL);
+    }
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->changed, NULL);
+
+    // The last deque belongs to the thread calling bek_pool_run
+    for (unsigned i = 0; i + 1 < threads; ++i) {
+        if (pthread_create(&p->threads[i], NULL, worker_main, p) != 0) {
+            p->thread_count = i + 1;
+            bek_pool_free(p);
+            *pool = NULL;
+            return BEK_ERROR_MEMORY;
+        }
+    }
+    return BEK_SUCCESS;
+}
+
+bek_error_t bek_pool_create(bek_pool_t **pool, unsigned threads) {
+    if (pool == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    if (threads == 0) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (unsigned) online : 1;
+    }
+    return pool_create(pool, threads, NULL);
+}
+
+bek_error_t bek_pool_create_numa(bek_pool_t **pool, const bek_numa_options_t *options) {
+    if (pool == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    bek_numa_topology_t topology;
+    int *cpu_nodes = NULL;
+    if (options != NULL && options->topology != NULL) {
+        topology = *options->topology;
+        if (topology.cpu_nodes == NULL || topology.page_node == NULL) {
+            return BEK_ERROR_NULL_POINTER;
+        }
+    } else {
+        const bek_error_t error = bek_numa_cpu_nodes(NULL, &cpu_nodes, &topology.cpu_count);
+        if (error != BEK_SUCCESS) {
+            return error;
+        }
+        topology.cpu_nodes = cpu_nodes;
+        topology.page_node = bek_numa_page_node;
+        topology.user_data = NULL;
+    }
+
+    const unsigned usable = usable_cpus(&topology);
+    const unsigned threads = options != NULL && options->threads > 0 ? options->threads
+                             : usable > 0                           ? usable
+                                                                    : 1;
+    const bek_error_t error = pool_create(pool, threads, &topology);
+    bek_free(NULL, cpu_nodes, topology.cpu_count * sizeof(int));
+    return error;
+}
+
+void bek_pool_get_stats(const bek_pool_t *pool, bek_pool_stats_t *stats) {
+    if (pool == NULL || stats == NULL) return;
+    stats->pieces = atomic_load(&pool->pieces);
+    stats->pieces_placed = atomic_load(&pool->pieces_placed);
+    stats->pieces_local = atomic_load(&pool->pieces_local);
+}
+
+void bek_pool_free(bek_pool_t *pool) {
+    if (pool == NULL) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->changed);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (unsigned i = 0; i + 1 < pool->thread_count; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (unsigned i = 0; i < pool->thread_count; ++i) {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+        bek_free(&pool->allocator, pool->deques[i].tasks, pool->deques[i].capacity * sizeof(task_t));
+    }
+    pthread_cond_destroy(&pool->changed);
+    pthread_mutex_destroy(&pool->lock);
+    const bek_allocator_t allocator = pool->allocator;
+    const unsigned threads = pool->deque_count;
+    bek_free(&allocator, pool->deques, threads * sizeof(task_deque_t));
+    bek_free(&allocator, pool->threads, threads * sizeof(pthread_t));
+    bek_free(&allocator, pool->thread_nodes, threads * sizeof(int));
+    bek_free(&allocator, pool->thread_cpus, threads * sizeof(unsigned));
+    bek_free(&allocator, pool, sizeof(bek_pool_t));
+}
+
+bek_error_t bek_pool_run(bek_pool_t *pool, bek_job_t *jobs, const size_t job_count) {
+    if (pool == NULL || (jobs == NULL && job_count > 0)) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+    if (job_count == 0) {
+        return BEK_SUCCESS;
+    }
+
+    pool->states = bek_calloc(&pool->allocator, job_count, sizeof(job_state_t));
+    if (pool->states == NULL) {
+        return BEK_ERROR_MEMORY;
+    }
+    pool->jobs = jobs;
+
+    // Deal batches of small jobs and split tasks for large ones round-robin
+    const unsigned self = pool->thread_count - 1;
+    unsigned target = 0;
+    task_t batch = {.kind = TASK_BATCH};
+    size_t batch_bytes = 0;
+
+    for (size_t i = 0; i <= job_count; ++i) {
+        const int large = i < job_count && jobs[i].input_length > BEK_POOL_SPLIT_SIZE;
+        if (batch.count > 0 && (i == job_count || large || batch_bytes >= BEK_POOL_BATCH_SIZE)) {
+            schedule(pool, self, target, &batch);
+            target = (target + 1) % pool->thread_count;
+            batch.count = 0;
+            batch_bytes = 0;
+        }
+        if (i == job_count) break;
+
+        if (large) {
+            const task_t split = {.kind = TASK_SPLIT, .job = i};
+            schedule(pool, self, target, &split);
+            target = (target + 1) % pool->thread_count;
+        } else {
+            if (batch.count == 0) batch.job = i;
+            batch.count++;
+            batch_bytes += jobs[i].input_length;
+        }
+    }
+    wake_all(pool);
+
+    // Work alongside the pool until every task has finished
+    task_t task;
+    for (;;) {
+        if (find_task(pool, self, &task)) {
+            execute_task(pool, self, &task);
+            finish_task(pool);
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        while (atomic_load(&pool->queued) == 0 && atomic_load(&pool->outstanding) > 0) {
+            pthread_cond_wait(&pool->changed, &pool->lock);
+        }
+        const int done = atomic_load(&pool->outstanding) == 0;
+        pthread_mutex_unlock(&pool->lock);
+        if (done) break;
+    }
+
+    bek_error_t result = BEK_SUCCESS;
+    for (size_t i = 0; i < job_count; ++i) {
+        if (pool->states[i].split) {
+            jobs[i].status = (bek_error_t) atomic_load(&pool->states[i].status);
+            if (jobs[i].status != BEK_SUCCESS) jobs[i].output_length = 0;
+        }
+        if (result == BEK_SUCCESS) result = jobs[i].status;
+    }
+
+    bek_free(&pool->allocator, pool->states, job_count * sizeof(job_state_t));
+    pool->states = NULL;
+    pool->jobs = NULL;
+    return result;
+}
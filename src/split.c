@@ -0,0 +1,56 @@
+#include "split.h"
+
+// Characters a decoder input character stands for: none for skipped ones, a
+// whole quantum for a zero-group character
+static size_t weight(const bek_codec_desc_t *desc, const uint8_t c) {
+    if (bek_skipped(desc, c)) return 0;
+    return desc->decode_table[c] == BEK_CLASS_ZERO ? desc->group_chars : 1;
+}
+
+size_t bek_count_significant(const bek_codec_desc_t *desc, const uint8_t *input, const size_t length) {
+    size_t count = 0;
+    for (size_t i = 0; i < length; ++i) {
+        count += weight(desc, input[i]);
+    }
+    return count;
+}
+
+size_t bek_align_decode_chunks(const bek_codec_desc_t *desc, const uint8_t *input, const size_t length,
+                               const size_t *counts, size_t chunk_count,
+                               size_t *input_offsets, size_t *output_offsets) {
+    const size_t group_chars = desc->group_chars;
+    const size_t group_bytes = desc->group_bytes;
+    size_t raw_prefix = 0, position = 0, prefix = 0, total = 0;
+
+    for (size_t index = 0; index < chunk_count; ++index) {
+        total += counts[index];
+    }
+
+    for (size_t index = 1; index < chunk_count; ++index) {
+        raw_prefix += counts[index - 1];
+        if (input_offsets[index] >= position) {
+            position = input_offsets[index];
+            prefix = raw_prefix;
+        }
+
+        for (size_t excess = (group_chars - prefix % group_chars) % group_chars;
+             excess > 0 && position < length; ++position) {
+            if (!bek_skipped(desc, input[position])) {
+                excess--;
+                prefix++;
+            }
+        }
+
+        if (position == length) {
+            chunk_count = index;
+            break;
+        }
+        input_offsets[index] = position;
+        output_offsets[index] = prefix / group_chars * group_bytes;
+    }
+
+    input_offsets[chunk_count] = length;
+    output_offsets[0] = 0;
+    output_offsets[chunk_count] = (total + group_chars - 1) / group_chars * group_bytes;
+    return chunk_count;
+}
@@ -0,0 +1,473 @@
+#include <string.h>
+
+#include "stream.h"
+
+void bek_stream_init(bek_stream_t *stream) {
+    if (stream != NULL) {
+        memset(stream, 0, sizeof(*stream));
+    }
+}
+
+// Deliver as much pending output as fits, returning the number of bytes written
+static size_t flush_pending(bek_stream_t *stream, uint8_t *output, const size_t space) {
+    size_t n = stream->pending_length - stream->pending_offset;
+    if (n > space) n = space;
+    if (n == 0) return 0;
+
+    memcpy(output, stream->pending + stream->pending_offset, n);
+    stream->pending_offset += n;
+    if (stream->pending_offset == stream->pending_length) {
+        stream->pending_offset = 0;
+        stream->pending_length = 0;
+    }
+    return n;
+}
+
+static void pend_line_ending(const bek_codec_desc_t *desc, bek_stream_t *stream) {
+    for (const char *e = desc->line_ending; *e != '\0'; e++) {
+        stream->pending[stream->pending_length++] = (uint8_t) *e;
+    }
+    stream->column = 0;
+}
+
+static void pend_char(const bek_codec_desc_t *desc, bek_stream_t *stream, const char c) {
+    stream->pending[stream->pending_length++] = (uint8_t) c;
+    if (desc->line_length > 0 && ++stream->column == desc->line_length) {
+        pend_line_ending(desc, stream);
+    }
+}
+
+// Encode a partial base85 quantum: zero-filled, its first count + 1 digits
+// carry every byte
+static void pend_radix_group(const bek_codec_desc_t *desc, bek_stream_t *stream) {
+    uint64_t value = stream->bits << (8 * (desc->group_bytes - stream->count));
+    char digits[8];
+    for (unsigned k = desc->group_chars; k-- > 0;) {
+        digits[k] = desc->alphabet[value % desc->radix];
+        value /= desc->radix;
+    }
+    for (unsigned k = 0; k <= stream->count; k++) {
+        pend_char(desc, stream, digits[k]);
+    }
+    stream->bits = 0;
+    stream->count = 0;
+}
+
+// Encode the partial quantum into pending, padding it if this is the end
+static void pend_encoded_group(const bek_codec_desc_t *desc, bek_stream_t *stream, const int final) {
+    if (desc->radix) {
+        pend_radix_group(desc, stream);
+        return;
+    }
+
+    const unsigned bpc = desc->bits_per_char;
+    const unsigned total_bits = stream->count * 8;
+    const unsigned chars = (total_bits + bpc - 1) / bpc;
+    const uint64_t value = stream->bits << (64 - total_bits);
+
+    for (unsigned k = 0; k < chars; k++) {
+        pend_char(desc, stream, desc->alphabet[(value >> (64 - bpc * (k + 1))) & ((1u << bpc) - 1)]);
+    }
+    if (final && desc->use_padding) {
+        for (unsigned k = chars; k < desc->group_chars; k++) {
+            pend_char(desc, stream, '=');
+        }
+    }
+    stream->bits = 0;
+    stream->count = 0;
+}
+
+bek_error_t bek_encode_update(const bek_codec_desc_t *desc, bek_stream_t *stream,
+                               const uint8_t *input, const size_t input_length, size_t *input_consumed,
+                               char *output, const size_t output_size, size_t *output_length) {
+    const size_t group_bytes = desc->group_bytes;
+    const size_t group_chars = desc->group_chars;
+    size_t in_pos = 0;
+    size_t out_pos = 0;
+
+    for (;;) {
+        out_pos += flush_pending(stream, (uint8_t *) output + out_pos, output_size - out_pos);
+        if (stream->pending_length > 0 || in_pos == input_length) break;
+
+        // Fast path: whole quanta straight into the caller's buffer
+        if (stream->count == 0) {
+            size_t groups = (input_length - in_pos) / group_bytes;
+            const size_t space = (output_size - out_pos) / group_chars;
+            if (groups > space) groups = space;
+            if (desc->line_length > 0) {
+                const size_t line_room = (desc->line_length - stream->column) / group_chars;
+                if (groups > line_room) groups = line_room;
+            }
+
+            if (groups > 0) {
+                desc->encode_groups(desc->alphabet, input + in_pos, groups, output + out_pos);
+                in_pos += groups * group_bytes;
+                out_pos += groups * group_chars;
+                if (desc->line_length > 0) {
+                    stream->column += groups * group_chars;
+                    if (stream->column == desc->line_length) pend_line_ending(desc, stream);
+                }
+                continue;
+            }
+        }
+
+        // Slow path: one byte into the partial quantum
+        stream->bits = (stream->bits << 8) | input[in_pos++];
+        if (++stream->count == group_bytes) {
+            pend_encoded_group(desc, stream, 0);
+        }
+    }
+
+    *input_consumed = in_pos;
+    *output_length = out_pos;
+    return BEK_SUCCESS;
+}
+
+bek_error_t bek_encode_final(const bek_codec_desc_t *desc, bek_stream_t *stream,
+                              char *output, const size_t output_size, size_t *output_length) {
+    size_t out_pos = flush_pending(stream, (uint8_t *) output, output_size);
+
+    if (stream->pending_length == 0 && stream->count > 0) {
+        pend_encoded_group(desc, stream, 1);
+        out_pos += flush_pending(stream, (uint8_t *) output + out_pos, output_size - out_pos);
+    }
+
+    *output_length = out_pos;
+    return stream->pending_length > 0 ? BEK_ERROR_BUFFER_TOO_SMALL : BEK_SUCCESS;
+}
+
+// A partial quantum of count characters is valid if no character is wasted
+static int is_valid_tail(const bek_codec_desc_t *desc, const unsigned count) {
+    if (desc->radix) return count > 1;
+    return count * desc->bits_per_char % 8 < desc->bits_per_char;
+}
+
+// Move the decoded bytes of the partial quantum into pending. Missing base85
+// digits count as the largest digit, so the kept bytes are those the encoder
+// started from; a quantum whose value does not fit its bytes is rejected.
+static bek_error_t pend_decoded_group(const bek_codec_desc_t *desc, bek_stream_t *stream) {
+    unsigned bytes;
+    uint64_t value;
+    if (desc->radix) {
+        value = stream->bits;
+        for (unsigned k = stream->count; k < desc->group_chars; k++) {
+            value = value * desc->radix + desc->radix - 1;
+        }
+        if (value >> (8 * desc->group_bytes) != 0) return BEK_ERROR_INVALID_INPUT;
+        bytes = stream->count - 1;
+        value >>= 8 * (desc->group_bytes - bytes);
+    } else {
+        const unsigned total_bits = stream->count * desc->bits_per_char;
+        bytes = total_bits / 8;
+        value = stream->bits >> (total_bits - bytes * 8);
+    }
+
+    for (unsigned k = 0; k < bytes; k++) {
+        stream->pending[stream->pending_length++] = (uint8_t) (value >> (8 * (bytes - 1 - k)));
+    }
+    stream->bits = 0;
+    stream->count = 0;
+    return BEK_SUCCESS;
+}
+
+bek_error_t bek_decode_update(const bek_codec_desc_t *desc, bek_stream_t *stream,
+                               const char *input, const size_t input_length, size_t *input_consumed,
+                               uint8_t *output, const size_t output_size, size_t *output_length) {
+    const size_t group_bytes = desc->group_bytes;
+    const size_t group_chars = desc->group_chars;
+    bek_error_t status = BEK_SUCCESS;
+    size_t in_pos = 0;
+    size_t out_pos = 0;
+
+    for (;;) {
+        out_pos += flush_pending(stream, output + out_pos, output_size - out_pos);
+        if (stream->pending_length > 0 || in_pos == input_length) break;
+
+        // Fast path: whole quanta of alphabet characters
+        if (stream->count == 0 && stream->padding == 0) {
+            size_t groups = (input_length - in_pos) / group_chars;
+            const size_t space = (output_size - out_pos) / group_bytes;
+            if (groups > space) groups = space;
+
+            if (groups > 0) {
+                const size_t done = desc->decode_groups(desc->decode_table, input + in_pos, groups, output + out_pos);
+                in_pos += done * group_chars;
+                out_pos += done * group_bytes;
+                if (done == groups) continue;
+            }
+        }
+
+        // Slow path: one character, which may be whitespace or padding
+        const uint8_t c = (uint8_t) input[in_pos];
+        if (bek_skipped(desc, c)) {
+            in_pos++;
+            continue;
+        }
+        const uint8_t value = desc->decode_table[c];
+        if (value == BEK_CLASS_PAD) {
+            if (stream->count == 0 || !is_valid_tail(desc, stream->count)) {
+                status = BEK_ERROR_PADDING;
+                break;
+            }
+            in_pos++;
+            if (stream->count + ++stream->padding == group_chars) {
+                pend_decoded_group(desc, stream);
+            }
+            continue;
+        }
+        if (value == BEK_CLASS_ZERO && stream->count == 0 && stream->padding == 0) {
+            in_pos++;
+            memset(stream->pending, 0, group_bytes);
+            stream->pending_length = group_bytes;
+            continue;
+        }
+        if (value >= BEK_CLASS_ZERO || stream->padding > 0) {
+            status = BEK_ERROR_INVALID_INPUT;
+            break;
+        }
+
+        in_pos++;
+        stream->bits = desc->radix ? stream->bits * desc->radix + value : (stream->bits << desc->bits_per_char) | value;
+        if (++stream->count == group_chars) {
+            status = pend_decoded_group(desc, stream);
+            if (status != BEK_SUCCESS) break;
+        }
+    }
+
+    *input_consumed = in_pos;
+    *output_length = out_pos;
+    return status;
+}
+
+bek_error_t bek_decode_final(const bek_codec_desc_t *desc, bek_stream_t *stream,
+                              uint8_t *output, const size_t output_size, size_t *output_length) {
+    size_t out_pos = flush_pending(stream, output, output_size);
+
+    if (stream->pending_length == 0 && stream->count > 0) {
+        if (!is_valid_tail(desc, stream->count)) {
+            *output_length = out_pos;
+            return BEK_ERROR_INVALID_LENGTH;
+        }
+        const bek_error_t status = pend_decoded_group(desc, stream);
+        if (status != BEK_SUCCESS) {
+            *output_length = out_pos;
+            return status;
+        }
+        out_pos += flush_pending(stream, output + out_pos, output_size - out_pos);
+    }
+
+    *output_length = out_pos;
+    return stream->pending_length > 0 ? BEK_ERROR_BUFFER_TOO_SMALL : BEK_SUCCESS;
+}
+
+// Output position within an iovec list
+typedef struct {
+    const struct iovec *iov;
+    int count;
+    int index;
+    size_t offset;
+} iov_cursor_t;
+
+// Return the writable remainder of the current segment, skipping full ones
+static uint8_t *cursor_space(iov_cursor_t *cursor, size_t *space) {
+    while (cursor->index < cursor->count && cursor->offset == cursor->iov[cursor->index].iov_len) {
+        cursor->index++;
+        cursor->offset = 0;
+    }
+    if (cursor->index == cursor->count) {
+        *space = 0;
+        return NULL;
+    }
+    *space = cursor->iov[cursor->index].iov_len - cursor->offset;
+    return (uint8_t *) cursor->iov[cursor->index].iov_base + cursor->offset;
+}
+
+typedef bek_error_t (*update_fn)(const bek_codec_desc_t *, bek_stream_t *, const void *, size_t,
+                                  size_t *, void *, size_t, size_t *);
+typedef bek_error_t (*final_fn)(const bek_codec_desc_t *, bek_stream_t *, void *, size_t, size_t *);
+
+// Run a stream over every input segment, spilling output across segments
+static bek_error_t transcode_iov(const bek_codec_desc_t *desc, const update_fn update, const final_fn final,
+                                  const struct iovec *input, const int input_count,
+                                  const struct iovec *output, const int output_count,
+                                  size_t *output_length) {
+    if (desc == NULL || output_length == NULL ||
+        (input == NULL && input_count > 0) || (output == NULL && output_count > 0)) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    bek_stream_t stream;
+    bek_stream_init(&stream);
+    iov_cursor_t cursor = {output, output_count, 0, 0};
+    size_t total = 0;
+    size_t space;
+
+    for (int i = 0; i < input_count; i++) {
+        const uint8_t *data = input[i].iov_base;
+        size_t left = input[i].iov_len;
+
+        while (left > 0) {
+            uint8_t *dest = cursor_space(&cursor, &space);
+            size_t consumed, produced;
+            const bek_error_t status = update(desc, &stream, data, left, &consumed, dest, space, &produced);
+            if (status != BEK_SUCCESS) return status;
+            if (consumed == 0 && produced == 0) return BEK_ERROR_BUFFER_TOO_SMALL;
+
+            data += consumed;
+            left -= consumed;
+            cursor.offset += produced;
+            total += produced;
+        }
+    }
+
+    for (;;) {
+        uint8_t *dest = cursor_space(&cursor, &space);
+        size_t produced;
+        const bek_error_t status = final(desc, &stream, dest, space, &produced);
+        cursor.offset += produced;
+        total += produced;
+        if (status != BEK_ERROR_BUFFER_TOO_SMALL || produced == 0) {
+            *output_length = total;
+            return status;
+        }
+    }
+}
+
+static bek_error_t encode_update(const bek_codec_desc_t *desc, bek_stream_t *stream,
+                                  const void *input, const size_t input_length, size_t *input_consumed,
+                                  void *output, const size_t output_size, size_t *output_length) {
+    return bek_encode_update(desc, stream, input, input_length, input_consumed, output, output_size, output_length);
+}
+
+static bek_error_t encode_final(const bek_codec_desc_t *desc, bek_stream_t *stream,
+                                 void *output, const size_t output_size, size_t *output_length) {
+    return bek_encode_final(desc, stream, output, output_size, output_length);
+}
+
+static bek_error_t decode_update(const bek_codec_desc_t *desc, bek_stream_t *stream,
+                                  const void *input, const size_t input_length, size_t *input_consumed,
+                                  void *output, const size_t output_size, size_t *output_length) {
+    return bek_decode_update(desc, stream, input, input_length, input_consumed, output, output_size, output_length);
+}
+
+static bek_error_t decode_final(const bek_codec_desc_t *desc, bek_stream_t *stream,
+                                 void *output, const size_t output_size, size_t *output_length) {
+    return bek_decode_final(desc, stream, output, output_size, output_length);
+}
+
+bek_error_t bek_encode_iov(const bek_codec_desc_t *desc,
+                            const struct iovec *input, const int input_count,
+                            const struct iovec *output, const int output_count,
+                            size_t *output_length) {
+    return transcode_iov(desc, encode_update, encode_final,
+                         input, input_count, output, output_count, output_length);
+}
+
+bek_error_t bek_decode_iov(const bek_codec_desc_t *desc,
+                            const struct iovec *input, const int input_count,
+                            const struct iovec *output, const int output_count,
+                            size_t *output_length) {
+    return transcode_iov(desc, decode_update, decode_final,
+                         input, input_count, output, output_count, output_length);
+}
+
+// Run a stream through a fixed block, handing each full block to the sink
+static bek_error_t transcode_sink(const bek_codec_desc_t *desc, const update_fn update, const final_fn final,
+                                   const uint8_t *input, size_t input_length,
+                                   const bek_sink_fn sink, void *user_data) {
+    if (desc == NULL || (input == NULL && input_length > 0) || sink == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    uint8_t block[BEK_SINK_BLOCK_SIZE];
+    size_t used = 0;
+    bek_stream_t stream;
+    bek_stream_init(&stream);
+
+    for (;;) {
+        const int finishing = input_length == 0;
+        size_t consumed = 0, produced;
+        const bek_error_t status = finishing
+                                        ? final(desc, &stream, block + used, sizeof(block) - used, &produced)
+                                        : update(desc, &stream, input, input_length, &consumed,
+                                                 block + used, sizeof(block) - used, &produced);
+        if (status != BEK_SUCCESS && status != BEK_ERROR_BUFFER_TOO_SMALL) return status;
+
+        input += consumed;
+        input_length -= consumed;
+        used += produced;
+
+        const int done = finishing && status == BEK_SUCCESS;
+        if (used == sizeof(block) || (done && used > 0)) {
+            if (sink(user_data, block, used) != 0) return BEK_ERROR_CALLBACK;
+            used = 0;
+        }
+        if (done) return BEK_SUCCESS;
+    }
+}
+
+bek_error_t bek_encode_to_sink(const bek_codec_desc_t *desc,
+                                const uint8_t *input, const size_t input_length,
+                                const bek_sink_fn sink, void *user_data) {
+    return transcode_sink(desc, encode_update, encode_final, input, input_length, sink, user_data);
+}
+
+bek_error_t bek_decode_to_sink(const bek_codec_desc_t *desc,
+                                const char *input, const size_t input_length,
+                                const bek_sink_fn sink, void *user_data) {
+    return transcode_sink(desc, decode_update, decode_final, (const uint8_t *) input, input_length, sink, user_data);
+}
+
+// Describe length bytes starting at offset as up to two segments of the ring
+static int ring_segments(const bek_ring_t *ring, const size_t offset, const size_t length, struct iovec iov[2]) {
+    const size_t first = ring->capacity - offset < length ? ring->capacity - offset : length;
+    iov[0].iov_base = ring->base + offset;
+    iov[0].iov_len = first;
+    iov[1].iov_base = ring->base;
+    iov[1].iov_len = length - first;
+    return iov[1].iov_len > 0 ? 2 : 1;
+}
+
+static int ring_is_valid(const bek_ring_t *ring) {
+    return ring->length <= ring->capacity && (ring->head < ring->capacity || ring->capacity == 0);
+}
+
+// Transcode the used region of one ring into the free region of another
+static bek_error_t transcode_ring(const bek_codec_desc_t *desc, const int encode,
+                                   const bek_ring_t *input, bek_ring_t *output,
+                                   size_t *output_length) {
+    if (desc == NULL || input == NULL || output == NULL || output_length == NULL ||
+        (input->base == NULL && input->capacity > 0) || (output->base == NULL && output->capacity > 0)) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+    if (!ring_is_valid(input) || !ring_is_valid(output)) {
+        return BEK_ERROR_INVALID_LENGTH;
+    }
+
+    struct iovec in[2], out[2];
+    const int in_count = input->length > 0 ? ring_segments(input, input->head, input->length, in) : 0;
+    const size_t tail = output->capacity > 0 ? (output->head + output->length) % output->capacity : 0;
+    const int out_count = ring_segments(output, tail, output->capacity - output->length, out);
+
+    size_t produced = 0;
+    const bek_error_t status = encode
+                                    ? bek_encode_iov(desc, in, in_count, out, out_count, &produced)
+                                    : bek_decode_iov(desc, in, in_count, out, out_count, &produced);
+    if (status == BEK_SUCCESS) {
+        output->length += produced;
+        *output_length = produced;
+    }
+    return status;
+}
+
+bek_error_t bek_encode_ring(const bek_codec_desc_t *desc,
+                             const bek_ring_t *input, bek_ring_t *output,
+                             size_t *output_length) {
+    return transcode_ring(desc, 1, input, output, output_length);
+}
+
+bek_error_t bek_decode_ring(const bek_codec_desc_t *desc,
+                             const bek_ring_t *input, bek_ring_t *output,
+                             size_t *output_length) {
+    return transcode_ring(desc, 0, input, output, output_length);
+}
@@ -0,0 +1,108 @@
+#include "stream.h"
+#include "tables.h"
+
+// All tables are built by the preprocessor: each entry macro maps a character
+// code to its table value and BEK_TABLE_256 expands it for codes 0..255.
+
+#define BEK_TABLE_4(f, n) f(n), f((n) + 1), f((n) + 2), f((n) + 3)
+#define BEK_TABLE_16(f, n) BEK_TABLE_4(f, n), BEK_TABLE_4(f, (n) + 4), BEK_TABLE_4(f, (n) + 8), BEK_TABLE_4(f, (n) + 12)
+#define BEK_TABLE_64(f, n) BEK_TABLE_16(f, n), BEK_TABLE_16(f, (n) + 16), BEK_TABLE_16(f, (n) + 32), BEK_TABLE_16(f, (n) + 48)
+#define BEK_TABLE_256(f) BEK_TABLE_64(f, 0), BEK_TABLE_64(f, 64), BEK_TABLE_64(f, 128), BEK_TABLE_64(f, 192)
+
+#define BEK_IN_RANGE(c, lo, hi) ((c) >= (lo) && (c) <= (hi))
+
+// Characters that are not part of an alphabet
+#define BEK_PADDED_CLASS(c) \
+    ((c) == ' ' || (c) == '\n' || (c) == '\r' ? BEK_CLASS_SPACE : (c) == '=' ? BEK_CLASS_PAD : BEK_CLASS_INVALID)
+#define BEK_HEX_CLASS(c) \
+    ((c) == ' ' || BEK_IN_RANGE(c, '\t', '\r') ? BEK_CLASS_SPACE : BEK_CLASS_INVALID)
+
+#define BASE64_COMMON_ENTRY(c, tail) \
+    (BEK_IN_RANGE(c, 'A', 'Z') ? (c) - 'A' : \
+     BEK_IN_RANGE(c, 'a', 'z') ? (c) - 'a' + 26 : \
+     BEK_IN_RANGE(c, '0', '9') ? (c) - '0' + 52 : tail)
+#define BASE64_STANDARD_ENTRY(c) \
+    BASE64_COMMON_ENTRY(c, (c) == '+' ? 62 : (c) == '/' ? 63 : BEK_PADDED_CLASS(c))
+#define BASE64_URL_ENTRY(c) \
+    BASE64_COMMON_ENTRY(c, (c) == '-' ? 62 : (c) == '_' ? 63 : BEK_PADDED_CLASS(c))
+
+#define BASE32_STANDARD_ENTRY(c) \
+    (BEK_IN_RANGE(c, 'A', 'Z') ? (c) - 'A' : \
+     BEK_IN_RANGE(c, '2', '7') ? (c) - '2' + 26 : BEK_PADDED_CLASS(c))
+#define BASE32_HEX_ENTRY(c) \
+    (BEK_IN_RANGE(c, '0', '9') ? (c) - '0' : \
+     BEK_IN_RANGE(c, 'A', 'V') ? (c) - 'A' + 10 : BEK_PADDED_CLASS(c))
+
+// Accepts both letter cases
+#define BASE16_ENTRY(c) \
+    (BEK_IN_RANGE(c, '0', '9') ? (c) - '0' : \
+     BEK_IN_RANGE(c, 'A', 'F') ? (c) - 'A' + 10 : \
+     BEK_IN_RANGE(c, 'a', 'f') ? (c) - 'a' + 10 : BEK_HEX_CLASS(c))
+
+// Ascii85 is the contiguous run '!'..'u'; 'z' abbreviates a quantum of zeros
+#define ASCII85_ENTRY(c) \
+    (BEK_IN_RANGE(c, '!', 'u') ? (c) - '!' : (c) == 'z' ? BEK_CLASS_ZERO : BEK_HEX_CLASS(c))
+
+// Z85 (ZeroMQ RFC 32) orders digits, lowercase, uppercase, then 23 symbols
+#define Z85_SYMBOL(c) \
+    ((c) == '.' ? 62 : (c) == '-' ? 63 : (c) == ':' ? 64 : (c) == '+' ? 65 : (c) == '=' ? 66 : \
+     (c) == '^' ? 67 : (c) == '!' ? 68 : (c) == '/' ? 69 : (c) == '*' ? 70 : (c) == '?' ? 71 : \
+     (c) == '&' ? 72 : (c) == '<' ? 73 : (c) == '>' ? 74 : (c) == '(' ? 75 : (c) == ')' ? 76 : \
+     (c) == '[' ? 77 : (c) == ']' ? 78 : (c) == '{' ? 79 : (c) == '}' ? 80 : (c) == '@' ? 81 : \
+     (c) == '%' ? 82 : (c) == '$' ? 83 : (c) == '#' ? 84 : BEK_HEX_CLASS(c))
+#define Z85_ENTRY(c) \
+    (BEK_IN_RANGE(c, '0', '9') ? (c) - '0' : \
+     BEK_IN_RANGE(c, 'a', 'z') ? (c) - 'a' + 10 : \
+     BEK_IN_RANGE(c, 'A', 'Z') ? (c) - 'A' + 36 : Z85_SYMBOL(c))
+
+// CRC-32C (Castagnoli, reflected polynomial 0x82F63B78) for slicing by 8.
+// Entry c of table k is the CRC of byte c followed by k zero bytes. That is
+// linear in the bits of c, so each table is the XOR of one constant per set
+// bit and the preprocessor never nests the entry macro.
+#define CRC32C_BITS(c, k0, k1, k2, k3, k4, k5, k6, k7) \
+    (((c) & 0x01 ? k0 : 0) ^ ((c) & 0x02 ? k1 : 0) ^ ((c) & 0x04 ? k2 : 0) ^ ((c) & 0x08 ? k3 : 0) ^ \
+     ((c) & 0x10 ? k4 : 0) ^ ((c) & 0x20 ? k5 : 0) ^ ((c) & 0x40 ? k6 : 0) ^ ((c) & 0x80 ? k7 : 0))
+#define CRC32C_ENTRY_0(c) CRC32C_BITS(c, 0xF26B8303u, 0xE13B70F7u, 0xC79A971Fu, 0x8AD958CFu, \
+                                      0x105EC76Fu, 0x20BD8EDEu, 0x417B1DBCu, 0x82F63B78u)
+#define CRC32C_ENTRY_1(c) CRC32C_BITS(c, 0x13A29877u, 0x274530EEu, 0x4E8A61DCu, 0x9D14C3B8u, \
+                                      0x3FC5F181u, 0x7F8BE302u, 0xFF17C604u, 0xFBC3FAF9u)
+#define CRC32C_ENTRY_2(c) CRC32C_BITS(c, 0xA541927Eu, 0x4F6F520Du, 0x9EDEA41Au, 0x38513EC5u, \
+                                      0x70A27D8Au, 0xE144FB14u, 0xC76580D9u, 0x8B277743u)
+#define CRC32C_ENTRY_3(c) CRC32C_BITS(c, 0xDD45AAB8u, 0xBF672381u, 0x7B2231F3u, 0xF64463E6u, \
+                                      0xE964B13Du, 0xD725148Bu, 0xABA65FE7u, 0x52A0C93Fu)
+#define CRC32C_ENTRY_4(c) CRC32C_BITS(c, 0x38116FACu, 0x7022DF58u, 0xE045BEB0u, 0xC5670B91u, \
+                                      0x8F2261D3u, 0x1BA8B557u, 0x37516AAEu, 0x6EA2D55Cu)
+#define CRC32C_ENTRY_5(c) CRC32C_BITS(c, 0xEF306B19u, 0xDB8CA0C3u, 0xB2F53777u, 0x6006181Fu, \
+                                      0xC00C303Eu, 0x85F4168Du, 0x0E045BEBu, 0x1C08B7D6u)
+#define CRC32C_ENTRY_6(c) CRC32C_BITS(c, 0x68032CC8u, 0xD0065990u, 0xA5E0C5D1u, 0x4E2DFD53u, \
+                                      0x9C5BFAA6u, 0x3D5B83BDu, 0x7AB7077Au, 0xF56E0EF4u)
+#define CRC32C_ENTRY_7(c) CRC32C_BITS(c, 0x493C7D27u, 0x9278FA4Eu, 0x211D826Du, 0x423B04DAu, \
+                                      0x847609B4u, 0x0D006599u, 0x1A00CB32u, 0x34019664u)
+
+const char bek_base64_standard_alphabet[65] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+const char bek_base64_url_alphabet[65] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+const char bek_base32_standard_alphabet[33] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+const char bek_base32_hex_alphabet[33] = "0123456789ABCDEFGHIJKLMNOPQRSTUV";
+const char bek_base16_upper_alphabet[17] = "0123456789ABCDEF";
+const char bek_base16_lower_alphabet[17] = "0123456789abcdef";
+const char bek_ascii85_alphabet[86] =
+        "!\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstu";
+const char bek_z85_alphabet[86] =
+        "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ.-:+=^!/*?&<>()[]{}@%$#";
+
+const uint8_t bek_base64_standard_decode[256] = {BEK_TABLE_256(BASE64_STANDARD_ENTRY)};
+const uint8_t bek_base64_url_decode[256] = {BEK_TABLE_256(BASE64_URL_ENTRY)};
+const uint8_t bek_base32_standard_decode[256] = {BEK_TABLE_256(BASE32_STANDARD_ENTRY)};
+const uint8_t bek_base32_hex_decode[256] = {BEK_TABLE_256(BASE32_HEX_ENTRY)};
+const uint8_t bek_base16_decode[256] = {BEK_TABLE_256(BASE16_ENTRY)};
+const uint8_t bek_ascii85_decode[256] = {BEK_TABLE_256(ASCII85_ENTRY)};
+const uint8_t bek_z85_decode[256] = {BEK_TABLE_256(Z85_ENTRY)};
+
+const uint32_t bek_crc32c_table[8][256] = {
+    {BEK_TABLE_256(CRC32C_ENTRY_0)}, {BEK_TABLE_256(CRC32C_ENTRY_1)},
+    {BEK_TABLE_256(CRC32C_ENTRY_2)}, {BEK_TABLE_256(CRC32C_ENTRY_3)},
+    {BEK_TABLE_256(CRC32C_ENTRY_4)}, {BEK_TABLE_256(CRC32C_ENTRY_5)},
+    {BEK_TABLE_256(CRC32C_ENTRY_6)}, {BEK_TABLE_256(CRC32C_ENTRY_7)}
+};
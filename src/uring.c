@@ -0,0 +1,373 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+
+#include <bek_uring.h>
+
+#include "alloc.h"
+#include "codec.h"
+
+#ifdef BEK_HAVE_IO_URING
+
+#include <fcntl.h>
+#include <liburing.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+typedef enum {
+    SLOT_FREE = 0,
+    SLOT_READING,
+    SLOT_READY,  // Read complete, waiting for its turn to be transcoded
+    SLOT_WRITING
+} slot_state_t;
+
+typedef struct {
+    slot_state_t state;
+    uint8_t *input;
+    size_t input_length;  // Bytes expected from the read
+    size_t input_filled;  // Bytes read so far
+    off_t input_offset;
+    uint8_t *output;
+    size_t output_length; // Bytes to write
+    size_t output_done;   // Bytes written so far
+    off_t output_offset;
+} slot_t;
+
+typedef struct {
+    const bek_codec_desc_t *desc;
+    int decode;
+    struct io_uring ring;
+    int input_fd;
+    int output_fd;
+    slot_t *slots;
+    unsigned slot_count;
+    uint8_t *memory;      // slot_count slots of block_size + output_capacity
+    bek_allocator_t allocator;
+    size_t block_size;
+    size_t output_capacity;
+    size_t input_size;
+    size_t block_count;
+    bek_stream_t stream;
+    off_t written;        // Output offset of the next transcoded block
+    unsigned in_flight;
+} uring_job_t;
+
+static int submit_read(uring_job_t *job, const unsigned index) {
+    slot_t *slot = &job->slots[index];
+    struct io_uring_sqe *sqe = io_uring_get_sqe(&job->ring);
+    if (sqe == NULL) return -EBUSY;
+
+    io_uring_prep_read_fixed(sqe, job->input_fd, slot->input + slot->input_filled,
+                             (unsigned) (slot->input_length - slot->input_filled),
+                             slot->input_offset + (off_t) slot->input_filled, (int) index);
+    io_uring_sqe_set_data64(sqe, index);
+    job->in_flight++;
+    return 0;
+}
+
+static int submit_write(uring_job_t *job, const unsigned index) {
+    slot_t *slot = &job->slots[index];
+    struct io_uring_sqe *sqe = io_uring_get_sqe(&job->ring);
+    if (sqe == NULL) return -EBUSY;
+
+    io_uring_prep_write_fixed(sqe, job->output_fd, slot->output + slot->output_done,
+                              (unsigned) (slot->output_length - slot->output_done),
+                              slot->output_offset + (off_t) slot->output_done, (int) (job->slot_count + index));
+    io_uring_sqe_set_data64(sqe, index);
+    job->in_flight++;
+    return 0;
+}
+
+// Run the streaming kernel over one block in file order; the last block also
+// flushes the final quantum
+static bek_error_t transcode_block(uring_job_t *job, slot_t *slot, const int last) {
+    size_t consumed, produced, tail = 0;
+    bek_error_t error;
+
+    if (job->decode) {
+        error = bek_decode_update(job->desc, &job->stream, (const char *) slot->input, slot->input_length,
+                                  &consumed, slot->output, job->output_capacity, &produced);
+        if (error == BEK_SUCCESS && last) {
+            error = bek_decode_final(job->desc, &job->stream, slot->output + produced,
+                                     job->output_capacity - produced, &tail);
+        }
+    } else {
+        error = bek_encode_update(job->desc, &job->stream, slot->input, slot->input_length,
+                                  &consumed, (char *) slot->output, job->output_capacity, &produced);
+        if (error == BEK_SUCCESS && last) {
+            error = bek_encode_final(job->desc, &job->stream, (char *) slot->output + produced,
+                                     job->output_capacity - produced, &tail);
+        }
+    }
+    if (error == BEK_SUCCESS && consumed < slot->input_length) {
+        error = BEK_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    slot->output_length = produced + tail;
+    slot->output_done = 0;
+    slot->output_offset = job->written;
+    job->written += (off_t) slot->output_length;
+    return error;
+}
+
+static bek_error_t handle_completion(uring_job_t *job, const struct io_uring_cqe *cqe) {
+    const unsigned index = (unsigned) io_uring_cqe_get_data64(cqe);
+    slot_t *slot = &job->slots[index];
+    job->in_flight--;
+
+    if (cqe->res < 0) {
+        errno = -cqe->res;
+        return BEK_ERROR_IO;
+    }
+
+    if (slot->state == SLOT_READING) {
+        if (cqe->res == 0) {
+            // File shrank underneath us
+            errno = EIO;
+            return BEK_ERROR_IO;
+        }
+        slot->input_filled += (size_t) cqe->res;
+        if (slot->input_filled < slot->input_length) {
+            return submit_read(job, index) == 0 ? BEK_SUCCESS : BEK_ERROR_IO;
+        }
+        slot->state = SLOT_READY;
+    } else {
+        slot->output_done += (size_t) cqe->res;
+        if (slot->output_done < slot->output_length) {
+            return submit_write(job, index) == 0 ? BEK_SUCCESS : BEK_ERROR_IO;
+        }
+        slot->state = SLOT_FREE;
+    }
+    return BEK_SUCCESS;
+}
+
+static bek_error_t run_ring(uring_job_t *job) {
+    size_t next_read = 0, next_process = 0;
+
+    for (;;) {
+        // Refill free slots with the next blocks of the file
+        while (next_read < job->block_count && job->slots[next_read % job->slot_count].state == SLOT_FREE) {
+            const unsigned index = (unsigned) (next_read % job->slot_count);
+            slot_t *slot = &job->slots[index];
+            const size_t offset = next_read * job->block_size;
+            slot->input_offset = (off_t) offset;
+            slot->input_length = job->input_size - offset < job->block_size ? job->input_size - offset : job->block_size;
+            slot->input_filled = 0;
+            slot->state = SLOT_READING;
+            if (submit_read(job, index) != 0) return BEK_ERROR_IO;
+            next_read++;
+        }
+
+        // Transcode completed reads in file order and queue their writes
+        while (next_process < job->block_count && job->slots[next_process % job->slot_count].state == SLOT_READY) {
+            const unsigned index = (unsigned) (next_process % job->slot_count);
+            slot_t *slot = &job->slots[index];
+            next_process++;
+
+            const bek_error_t error = transcode_block(job, slot, next_process == job->block_count);
+            if (error != BEK_SUCCESS) return error;
+
+            if (slot->output_length == 0) {
+                slot->state = SLOT_FREE;
+            } else {
+                slot->state = SLOT_WRITING;
+                if (submit_write(job, index) != 0) return BEK_ERROR_IO;
+            }
+        }
+
+        const int submitted = io_uring_submit(&job->ring);
+        if (submitted < 0) {
+            errno = -submitted;
+            return BEK_ERROR_IO;
+        }
+        if (job->in_flight == 0) {
+            // Slots freed without I/O may have made room for more reads
+            if (next_read < job->block_count) continue;
+            return BEK_SUCCESS;
+        }
+
+        struct io_uring_cqe *cqe;
+        const int waited = io_uring_wait_cqe(&job->ring, &cqe);
+        if (waited < 0) {
+            errno = -waited;
+            return BEK_ERROR_IO;
+        }
+
+        // Drain everything that is already complete before refilling
+        unsigned head, seen = 0;
+        bek_error_t error = BEK_SUCCESS;
+        io_uring_for_each_cqe(&job->ring, head, cqe) {
+            if (error == BEK_SUCCESS) error = handle_completion(job, cqe);
+            seen++;
+        }
+        io_uring_cq_advance(&job->ring, seen);
+        if (error != BEK_SUCCESS) return error;
+    }
+}
+
+// Wait for in-flight requests so no kernel write lands in freed memory
+static void drain_ring(uring_job_t *job) {
+    io_uring_submit(&job->ring);
+    while (job->in_flight > 0) {
+        struct io_uring_cqe *cqe;
+        if (io_uring_wait_cqe(&job->ring, &cqe) < 0) break;
+        io_uring_cqe_seen(&job->ring, cqe);
+        job->in_flight--;
+    }
+}
+
+static bek_error_t setup_job(uring_job_t *job, const bek_uring_options_t *options) {
+    const unsigned depth = options != NULL && options->queue_depth > 0 ? options->queue_depth : BEK_URING_DEFAULT_QUEUE_DEPTH;
+    job->block_size = options != NULL && options->block_size > 0 ? options->block_size : BEK_URING_DEFAULT_BLOCK_SIZE;
+    job->slot_count = depth;
+
+    // Room for one block, a carried partial quantum and the stream's pending bytes
+    const bek_codec_desc_t *desc = job->desc;
+    if (job->decode && desc->zero_groups) {
+        // A zero-group character alone stands for a whole quantum
+        job->output_capacity = (job->block_size + desc->group_chars) * desc->group_bytes;
+    } else if (job->decode) {
+        job->output_capacity = (job->block_size + desc->group_chars) / desc->group_chars * desc->group_bytes;
+    } else {
+        const size_t chars = (job->block_size + 2 * desc->group_bytes) / desc->group_bytes * desc->group_chars;
+        job->output_capacity = chars + (desc->line_length > 0 ? chars / desc->line_length + 1 : 0) * 2;
+    }
+    job->output_capacity += sizeof(job->stream.pending);
+
+    const size_t slot_bytes = job->block_size + job->output_capacity;
+    job->memory = bek_alloc(&job->allocator, depth * slot_bytes);
+    job->slots = bek_calloc(&job->allocator, depth, sizeof(slot_t));
+    struct iovec *buffers = bek_alloc(&job->allocator, 2 * depth * sizeof(struct iovec));
+    if (job->memory == NULL || job->slots == NULL || buffers == NULL) {
+        bek_free(&job->allocator, buffers, 2 * depth * sizeof(struct iovec));
+        return BEK_ERROR_MEMORY;
+    }
+
+    for (unsigned i = 0; i < depth; ++i) {
+        job->slots[i].input = job->memory + i * slot_bytes;
+        job->slots[i].output = job->slots[i].input + job->block_size;
+        buffers[i].iov_base = job->slots[i].input;
+        buffers[i].iov_len = job->block_size;
+        buffers[depth + i].iov_base = job->slots[i].output;
+        buffers[depth + i].iov_len = job->output_capacity;
+    }
+
+    int result = io_uring_queue_init(2 * depth, &job->ring, 0);
+    if (result == 0) {
+        result = io_uring_register_buffers(&job->ring, buffers, 2 * depth);
+        if (result != 0) io_uring_queue_exit(&job->ring);
+    }
+    bek_free(&job->allocator, buffers, 2 * depth * sizeof(struct iovec));
+
+    if (result != 0) {
+        errno = -result;
+        return BEK_ERROR_IO;
+    }
+    return BEK_SUCCESS;
+}
+
+static bek_error_t transcode_file_uring(const bek_codec_t *codec,
+                                        const char *input_path,
+                                        const char *output_path,
+                                        const bek_uring_options_t *options,
+                                        const int decode) {
+    const bek_codec_desc_t *desc = bek_codec_desc(codec);
+    if (desc == NULL || input_path == NULL || output_path == NULL) {
+        return BEK_ERROR_NULL_POINTER;
+    }
+
+    uring_job_t job = {0};
+    job.desc = desc;
+    job.decode = decode;
+    job.allocator = bek_allocator(NULL);
+    job.output_fd = -1;
+    bek_stream_init(&job.stream);
+
+    struct stat st;
+    job.input_fd = open(input_path, O_RDONLY);
+    if (job.input_fd < 0) return BEK_ERROR_IO;
+    if (fstat(job.input_fd, &st) != 0) {
+        const int saved_errno = errno;
+        close(job.input_fd);
+        errno = saved_errno;
+        return BEK_ERROR_IO;
+    }
+    job.input_size = (size_t) st.st_size;
+
+    bek_error_t error = BEK_SUCCESS;
+    job.output_fd = open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (job.output_fd < 0) error = BEK_ERROR_IO;
+
+    int ring_ready = 0;
+    if (error == BEK_SUCCESS) {
+        error = setup_job(&job, options);
+        ring_ready = error == BEK_SUCCESS;
+    }
+
+    if (error == BEK_SUCCESS) {
+        job.block_count = (job.input_size + job.block_size - 1) / job.block_size;
+        error = run_ring(&job);
+    }
+
+    int saved_errno = errno;
+    if (ring_ready) {
+        drain_ring(&job);
+        io_uring_queue_exit(&job.ring);
+    }
+    bek_free(&job.allocator, job.memory, job.slot_count * (job.block_size + job.output_capacity));
+    bek_free(&job.allocator, job.slots, job.slot_count * sizeof(slot_t));
+
+    if (job.output_fd >= 0 && close(job.output_fd) != 0 && error == BEK_SUCCESS) {
+        error = BEK_ERROR_IO;
+        saved_errno = errno;
+    }
+    close(job.input_fd);
+
+    errno = saved_errno;
+    return error;
+}
+
+bek_error_t bek_encode_file_uring(const bek_codec_t *codec,
+                                  const char *input_path,
+                                  const char *output_path,
+                                  const bek_uring_options_t *options) {
+    return transcode_file_uring(codec, input_path, output_path, options, 0);
+}
+
+bek_error_t bek_decode_file_uring(const bek_codec_t *codec,
+                                  const char *input_path,
+                                  const char *output_path,
+                                  const bek_uring_options_t *options) {
+    return transcode_file_uring(codec, input_path, output_path, options, 1);
+}
+
+#else
+
+bek_error_t bek_encode_file_uring(const bek_codec_t *codec,
+                                  const char *input_path,
+                                  const char *output_path,
+                                  const bek_uring_options_t *options) {
+    (void) codec;
+    (void) input_path;
+    (void) output_path;
+    (void) options;
+    errno = ENOSYS;
+    return BEK_ERROR_IO;
+}
+
+bek_error_t bek_decode_file_uring(const bek_codec_t *codec,
+                                  const char *input_path,
+                                  const char *output_path,
+                                  const bek_uring_options_t *options) {
+    (void) codec;
+    (void) input_path;
+    (void) output_path;
+    (void) options;
+    errno = ENOSYS;
+    return BEK_ERROR_IO;
+}
+
+#endif
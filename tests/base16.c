@@ -1,6 +1,7 @@
 #include <unity.h>
 #include "base16.h"
 
+#include <stdio.h>
 #include <string.h>
 
 struct Base16TestVector {
@@ -81,3 +82,283 @@ void test_base16_decode(void) {
     base16_free(ctx);
 }
 
+
+// Test the padded-buffer (slop) variants against the regular vectors
+void test_base16_slop(void) {
+    base16_config_t config = {1, 0, 0, 0};
+    base16_ctx_t *ctx;
+    base16_init(&ctx, &config);
+
+    uint8_t input[128 + BASE16_SLOP_BYTES];
+    char encoded[128 + BASE16_SLOP_BYTES];
+    uint8_t decoded[128 + BASE16_SLOP_BYTES];
+
+    for (int i = 0; i < sizeof(base16TestVectors) / sizeof(base16TestVectors[0]); i++) {
+        const struct Base16TestVector *tv = &base16TestVectors[i];
+        const size_t length = strlen(tv->input);
+        size_t output_length = 0;
+        memset(input, 0xA5, sizeof(input));  // Garbage in the slop region must not leak
+        memcpy(input, tv->input, length);
+
+        assert_base16_error(base16_encode_slop(ctx, input, length, encoded, 128, &output_length), BASE16_SUCCESS);
+        TEST_ASSERT_EQUAL_STRING(tv->encoded_upper, encoded);
+
+        assert_base16_error(base16_decode_slop(ctx, encoded, output_length, decoded, 128, &output_length), BASE16_SUCCESS);
+        TEST_ASSERT_EQUAL(length, output_length);
+        TEST_ASSERT_EQUAL_MEMORY(tv->input, decoded, length);
+    }
+
+    size_t output_length;
+    memcpy(encoded, "66 6F", 5);
+    assert_base16_error(base16_decode_slop(ctx, encoded, 5, decoded, 128, &output_length), BASE16_ERROR_INVALID_LENGTH);
+    memcpy(encoded, "666G", 4);
+    assert_base16_error(base16_decode_slop(ctx, encoded, 4, decoded, 128, &output_length), BASE16_ERROR_INVALID_INPUT);
+
+    base16_free(ctx);
+}
+
+// Test exact-size encoding without a terminator, with odd line lengths
+void test_base16_no_terminator(void) {
+    base16_config_t config = {1, 3, "\n", 1};
+    base16_ctx_t *ctx;
+    base16_init(&ctx, &config);
+
+    char encoded[16];
+    size_t output_size, output_length;
+    memset(encoded, '#', sizeof(encoded));
+
+    base16_get_encode_size(3, ctx, &output_size);
+    TEST_ASSERT_EQUAL(8, output_size);
+    assert_base16_error(base16_encode(ctx, (const uint8_t *)"foo", 3, encoded, output_size, &output_length), BASE16_SUCCESS);
+    TEST_ASSERT_EQUAL(output_size, output_length);
+    TEST_ASSERT_EQUAL_STRING_LEN("666\nF6F\n#", encoded, 9);
+
+    base16_free(ctx);
+}
+
+// Test scatter/gather encoding and decoding with quanta split across segments
+void test_base16_iov(void) {
+    base16_config_t config = {1, 0, 0, 0};
+    base16_ctx_t *ctx;
+    base16_init(&ctx, &config);
+
+    char encoded[128];
+    uint8_t decoded[128];
+    size_t output_length;
+
+    struct iovec input[] = {{"he", 2}, {"llo", 3}};
+    struct iovec output[] = {{encoded, 3}, {encoded + 3, 125}};
+    assert_base16_error(base16_encode_iov(ctx, input, 2, output, 2, &output_length), BASE16_SUCCESS);
+    TEST_ASSERT_EQUAL(10, output_length);
+    TEST_ASSERT_EQUAL_STRING_LEN("68656C6C6F", encoded, 10);
+
+    struct iovec text[] = {{"686", 3}, {"56c 6c6f", 8}};
+    struct iovec bytes[] = {{decoded, 128}};
+    assert_base16_error(base16_decode_iov(ctx, text, 2, bytes, 1, &output_length), BASE16_SUCCESS);
+    TEST_ASSERT_EQUAL(5, output_length);
+    TEST_ASSERT_EQUAL_MEMORY("hello", decoded, 5);
+
+    struct iovec odd[] = {{"686", 3}};
+    assert_base16_error(base16_decode_iov(ctx, odd, 1, bytes, 1, &output_length), BASE16_ERROR_INVALID_LENGTH);
+
+    base16_free(ctx);
+}
+
+// Compare the fixed-length encoders with the generic encoder on every byte value
+void test_base16_fixed(void) {
+    base16_config_t upper_config = {1, 0, "", 1};
+    base16_config_t lower_config = {0, 0, "", 1};
+    base16_ctx_t *upper, *lower;
+    base16_init(&upper, &upper_config);
+    base16_init(&lower, &lower_config);
+
+    uint8_t input[256];
+    for (int i = 0; i < 256; i++) input[i] = (uint8_t) i;
+
+    char expected[512], actual[512];
+    size_t output_length;
+    for (int offset = 0; offset + 64 <= 256; offset += 64) {
+        base16_encode(upper, input + offset, 64, expected, sizeof(expected), &output_length);
+        base16_encode_64(input + offset, actual, 1);
+        TEST_ASSERT_EQUAL_MEMORY(expected, actual, 128);
+
+        base16_encode(lower, input + offset, 64, expected, sizeof(expected), &output_length);
+        base16_encode_64(input + offset, actual, 0);
+        TEST_ASSERT_EQUAL_MEMORY(expected, actual, 128);
+    }
+
+    base16_encode(lower, input + 200, 20, expected, sizeof(expected), &output_length);
+    base16_encode_20(input + 200, actual, 0);
+    TEST_ASSERT_EQUAL_MEMORY(expected, actual, 40);
+
+    const uint8_t uuid[16] = {0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3,
+                              0xa4, 0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x00};
+    base16_encode_uuid(uuid, actual, 0);
+    TEST_ASSERT_EQUAL_STRING_LEN("123e4567-e89b-12d3-a456-426614174000", actual, 36);
+
+    base16_free(upper);
+    base16_free(lower);
+}
+
+void test_base16_integers(void) {
+    char output[32];
+    base16_format_u32(0xDEADBEEF, output, 0);
+    TEST_ASSERT_EQUAL_STRING_LEN("deadbeef", output, 8);
+    base16_format_u64(0x0123456789ABCDEFULL, output, 1);
+    TEST_ASSERT_EQUAL_STRING_LEN("0123456789ABCDEF", output, 16);
+    base16_format_u128(0x00000000000000FFULL, 0xA, output, 1);
+    TEST_ASSERT_EQUAL_STRING_LEN("00000000000000FF000000000000000A", output, 32);
+
+    TEST_ASSERT_EQUAL(1, base16_format_u32_min(0, output, 1));
+    TEST_ASSERT_EQUAL_STRING_LEN("0", output, 1);
+    TEST_ASSERT_EQUAL(3, base16_format_u64_min(0xABC, output, 0));
+    TEST_ASSERT_EQUAL_STRING_LEN("abc", output, 3);
+    TEST_ASSERT_EQUAL(18, base16_format_u128_min(0x1F, 0, output, 1));
+    TEST_ASSERT_EQUAL_STRING_LEN("1F0000000000000000", output, 18);
+
+    uint32_t value32;
+    TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_parse_u32("DeadBeef", 8, &value32));
+    TEST_ASSERT_EQUAL_UINT32(0xDEADBEEF, value32);
+    TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_parse_u32("7", 1, &value32));
+    TEST_ASSERT_EQUAL_UINT32(7, value32);
+    TEST_ASSERT_EQUAL(BASE16_ERROR_INVALID_INPUT, base16_parse_u32("12g4", 4, &value32));
+    TEST_ASSERT_EQUAL(BASE16_ERROR_INVALID_INPUT, base16_parse_u32("12:4", 4, &value32));
+    TEST_ASSERT_EQUAL(BASE16_ERROR_INVALID_INPUT, base16_parse_u32("12\xC1" "4", 4, &value32));
+    TEST_ASSERT_EQUAL(BASE16_ERROR_INVALID_LENGTH, base16_parse_u32("123456789", 9, &value32));
+    TEST_ASSERT_EQUAL(BASE16_ERROR_INVALID_LENGTH, base16_parse_u32("", 0, &value32));
+
+    uint64_t value64, high, low;
+    TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_parse_u64("123456789abcdef", 15, &value64));
+    TEST_ASSERT_TRUE(value64 == 0x123456789ABCDEFULL);
+    TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_parse_u128("1F0000000000000000", 18, &high, &low));
+    TEST_ASSERT_TRUE(high == 0x1F && low == 0);
+
+    // Every value formatted at every width parses back to itself
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 1000; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        const uint64_t v = x >> (i % 64);
+        const size_t count = base16_format_u64_min(v, output, i & 1);
+        TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_parse_u64(output, count, &value64));
+        TEST_ASSERT_TRUE(value64 == v);
+        base16_format_u128(v, ~v, output, i & 1);
+        TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_parse_u128(output, 32, &high, &low));
+        TEST_ASSERT_TRUE(high == v && low == ~v);
+    }
+}
+
+void test_base16_word_classes(void) {
+    base16_config_t config = {0, 0, "", 1};
+    base16_ctx_t *ctx;
+    base16_init(&ctx, &config);
+
+    // Hex digits of either case in every lane decode as the table does
+    const char *digits = "0123456789abcdefABCDEF";
+    for (int position = 0; position < 8; position++) {
+        for (const char *c = digits; *c != '\0'; c++) {
+            char input[16 + BASE16_SLOP_BYTES] = {0};
+            memcpy(input, "0123456789abcdef", 16);
+            input[position] = *c;
+
+            uint8_t actual[64], expected[64 + BASE16_SLOP_BYTES];
+            size_t actual_length, expected_length;
+            TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_decode(ctx, input, 16, actual, sizeof(actual), &actual_length));
+            TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_decode_slop(ctx, input, 16, expected, sizeof(expected),
+                                                                &expected_length));
+            TEST_ASSERT_EQUAL(expected_length, actual_length);
+            TEST_ASSERT_EQUAL_MEMORY(expected, actual, actual_length);
+        }
+
+        char input[16 + BASE16_SLOP_BYTES] = {0};
+        memcpy(input, "0123456789abcdef", 16);
+        input[position] = 'g';
+        uint8_t output[64];
+        size_t output_length;
+        TEST_ASSERT_EQUAL(BASE16_ERROR_INVALID_INPUT, base16_decode(ctx, input, 16, output, sizeof(output), &output_length));
+    }
+    base16_free(ctx);
+}
+
+// Whitespace anywhere, pairs split included, and a configured ignore set
+void test_base16_ignore_set(void) {
+    base16_config_t bad = {1, 0, "", 1, ":a"};
+    base16_ctx_t *ctx;
+    TEST_ASSERT_EQUAL(BASE16_ERROR_INVALID_INPUT, base16_init(&ctx, &bad));
+
+    base16_config_t config = {1, 0, "", 1, ":- \n"};
+    TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_init(&ctx, &config));
+
+    // A MAC-style dump long enough to span several compaction blocks
+    enum { SIZE = 3000 };
+    uint8_t input[SIZE], decoded[2 * SIZE];
+    char text[4 * SIZE];
+    size_t length = 0, output_length;
+    for (int i = 0; i < SIZE; i++) {
+        input[i] = (uint8_t) (i * 151 + 7);
+        if (i % 7 == 3) {
+            length += (size_t) sprintf(text + length, "%x %x:", input[i] >> 4, input[i] & 0x0F);
+        } else {
+            length += (size_t) sprintf(text + length, i % 16 == 15 ? "%02x\n" : "%02X:", input[i]);
+        }
+    }
+    TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_decode(ctx, text, length, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(SIZE, output_length);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded, SIZE);
+
+    // The streaming decoder skips the same set
+    bek_stream_t stream;
+    bek_stream_init(&stream);
+    size_t consumed, tail;
+    memset(decoded, 0, sizeof(decoded));
+    TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_decode_update(ctx, &stream, text, length, &consumed,
+                                                           decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_decode_final(ctx, &stream, decoded + output_length,
+                                                          sizeof(decoded) - output_length, &tail));
+    TEST_ASSERT_EQUAL(SIZE, output_length + tail);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded, SIZE);
+
+    // A tab is not in this set, although the default set has it
+    TEST_ASSERT_EQUAL(BASE16_ERROR_INVALID_INPUT, base16_decode(ctx, "de:ad:be:ef\t00:11:22:33", 23, decoded, sizeof(decoded), &output_length));
+    bek_stream_init(&stream);
+    TEST_ASSERT_EQUAL(BASE16_ERROR_INVALID_INPUT, base16_decode_update(ctx, &stream, "de:ad:be:ef\t00:11:22:33", 23,
+                                                                       &consumed, decoded, sizeof(decoded), &output_length));
+    base16_free(ctx);
+}
+
+// UTF-16 variants: the same text as the char functions, one code unit per
+// character, including a line length that splits a byte
+void test_base16_utf16(void) {
+    base16_config_t config = {0, 7, "\n", 0};
+    base16_ctx_t *ctx;
+    base16_init(&ctx, &config);
+
+    uint8_t input[100], decoded[200];
+    for (size_t i = 0; i < sizeof(input); i++) input[i] = (uint8_t) (i * 29 + 3);
+    char text[256];
+    uint16_t wide[256];
+    size_t output_size, text_length, wide_length, output_length;
+
+    for (size_t n = 0; n <= sizeof(input); n += n < 8 ? 1 : 23) {
+        base16_get_encode_size(n, ctx, &output_size);
+        TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_encode(ctx, input, n, text, sizeof(text), &text_length));
+        TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_encode_utf16(ctx, input, n, wide, output_size, &wide_length));
+        TEST_ASSERT_EQUAL(text_length, wide_length);
+        for (size_t i = 0; i <= text_length; i++) TEST_ASSERT_EQUAL((uint8_t) text[i], wide[i]);
+
+        TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_decode_utf16(ctx, wide, wide_length, decoded, sizeof(decoded), &output_length));
+        TEST_ASSERT_EQUAL(n, output_length);
+        TEST_ASSERT_EQUAL_MEMORY(input, decoded, n);
+    }
+
+    // Units above 0xFF are invalid even where their low byte is a digit
+    uint16_t digits[20];
+    for (int i = 0; i < 20; i++) digits[i] = (uint16_t) "0123456789abcdefABCD"[i];
+    TEST_ASSERT_EQUAL(BASE16_SUCCESS, base16_decode_utf16(ctx, digits, 20, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(10, output_length);
+    digits[12] |= 0x0100;
+    TEST_ASSERT_EQUAL(BASE16_ERROR_INVALID_INPUT, base16_decode_utf16(ctx, digits, 20, decoded, sizeof(decoded), &output_length));
+
+    base16_free(ctx);
+}
@@ -67,6 +67,36 @@ void test_base32_decode(void) {
     base32_free(ctx);
 }
 
+// The reverse table rejects characters outside the alphabet, skips spaces and
+// line breaks and stops at the first padding character
+void test_base32_decode_lookup(void) {
+    base32_config_t config = {1, 0, 0, "", 1};
+    base32_ctx_t *ctx;
+    base32_init(&ctx, &config);
+
+    uint8_t decoded[BUFFER_SIZE];
+    size_t output_length;
+
+    const char *invalid[] = {"MZXW6!TB", "MZXW6YT@", "MZXW6YTB-I======", "MZXW\x80YTB", "MZXW\t6YTB"};
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        TEST_ASSERT_EQUAL(BASE32_ERROR_INVALID_INPUT,
+                          base32_decode(ctx, invalid[i], strlen(invalid[i]), decoded, sizeof(decoded), &output_length));
+    }
+
+    const char *spaced = "MZXW 6YTB\r\nOI======\n";
+    TEST_ASSERT_EQUAL(BASE32_SUCCESS, base32_decode(ctx, spaced, strlen(spaced), decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(6, output_length);
+    TEST_ASSERT_EQUAL_MEMORY("foobar", decoded, 6);
+
+    // Nothing after the padding is read, not even invalid characters
+    const char *padded = "MZXW6===MZXW6YTB!";
+    TEST_ASSERT_EQUAL(BASE32_SUCCESS, base32_decode(ctx, padded, strlen(padded), decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(3, output_length);
+    TEST_ASSERT_EQUAL_MEMORY("foo", decoded, 3);
+
+    base32_free(ctx);
+}
+
 void test_base32hex_encode(void) {
     size_t output_size, output_length;
     char encoded[BUFFER_SIZE];
@@ -132,3 +162,200 @@ void test_base32_invalid_inputs(void) {
     base32_free(ctx);
 
 }
+
+// Test the padded-buffer (slop) variants against the regular vectors
+void test_base32_slop(void) {
+    base32_config_t config = {1, 0, 0, ""};
+    base32_ctx_t *ctx;
+    base32_init(&ctx, &config);
+
+    size_t output_length;
+    uint8_t input[BUFFER_SIZE + BASE32_SLOP_BYTES];
+    char encoded[BUFFER_SIZE + BASE32_SLOP_BYTES];
+    uint8_t decoded[BUFFER_SIZE + BASE32_SLOP_BYTES];
+
+    for (size_t i = 0; i < sizeof(base32TestVectors) / sizeof(base32TestVectors[0]); i++) {
+        const size_t length = strlen(base32TestVectors[i].input);
+        memset(input, 0xA5, sizeof(input));  // Garbage in the slop region must not leak
+        memcpy(input, base32TestVectors[i].input, length);
+
+        TEST_ASSERT_EQUAL(BASE32_SUCCESS, base32_encode_slop(ctx, input, length, encoded, BUFFER_SIZE, &output_length));
+        TEST_ASSERT_EQUAL_STRING(base32TestVectors[i].encoded, encoded);
+
+        TEST_ASSERT_EQUAL(BASE32_SUCCESS, base32_decode_slop(ctx, encoded, output_length, decoded, BUFFER_SIZE, &output_length));
+        TEST_ASSERT_EQUAL(length, output_length);
+        TEST_ASSERT_EQUAL_MEMORY(base32TestVectors[i].input, decoded, length);
+    }
+
+    memcpy(encoded, "MZXW6Y1B", 8);
+    TEST_ASSERT_EQUAL(BASE32_ERROR_INVALID_INPUT, base32_decode_slop(ctx, encoded, 8, decoded, BUFFER_SIZE, &output_length));
+
+    base32_free(ctx);
+}
+
+// Test exact-size encoding without a terminator, packed back to back
+void test_base32_no_terminator(void) {
+    base32_config_t config = {1, 0, 0, "", 1};
+    base32_ctx_t *ctx;
+    base32_init(&ctx, &config);
+
+    char arena[BUFFER_SIZE];
+    char expected[BUFFER_SIZE] = "";
+    size_t offset = 0, output_size, output_length;
+    memset(arena, '#', sizeof(arena));
+
+    for (size_t i = 0; i < sizeof(base32TestVectors) / sizeof(base32TestVectors[0]); i++) {
+        const size_t length = strlen(base32TestVectors[i].input);
+        base32_get_encode_size(length, ctx, &output_size);
+        TEST_ASSERT_EQUAL(strlen(base32TestVectors[i].encoded), output_size);
+        TEST_ASSERT_EQUAL(BASE32_SUCCESS, base32_encode(ctx, (const uint8_t *)base32TestVectors[i].input, length,
+                                                       arena + offset, output_size, &output_length));
+        offset += output_length;
+        strcat(expected, base32TestVectors[i].encoded);
+    }
+    TEST_ASSERT_EQUAL_STRING_LEN(expected, arena, offset);
+    TEST_ASSERT_EQUAL('#', arena[offset]);
+    base32_free(ctx);
+
+    // Line breaks are part of the exact size
+    base32_config_t wrapped = {0, 0, 8, "\n", 1};
+    base32_init(&ctx, &wrapped);
+    base32_get_encode_size(6, ctx, &output_size);
+    TEST_ASSERT_EQUAL(BASE32_SUCCESS, base32_encode(ctx, (const uint8_t *)"foobar", 6, arena, output_size, &output_length));
+    TEST_ASSERT_EQUAL(output_size, output_length);
+    TEST_ASSERT_EQUAL_STRING_LEN("MZXW6YTB\nOI", arena, output_length);
+    base32_free(ctx);
+}
+
+// Test scatter/gather encoding and decoding with quanta split across segments
+void test_base32_iov(void) {
+    base32_config_t config = {1, 0, 0, ""};
+    base32_ctx_t *ctx;
+    base32_init(&ctx, &config);
+
+    char encoded[BUFFER_SIZE];
+    uint8_t decoded[BUFFER_SIZE];
+    size_t output_length;
+
+    struct iovec input[] = {{"fo", 2}, {"oba", 3}, {"r", 1}};
+    struct iovec output[] = {{encoded, 5}, {encoded + 5, 5}, {encoded + 10, 6}};
+    TEST_ASSERT_EQUAL(BASE32_SUCCESS, base32_encode_iov(ctx, input, 3, output, 3, &output_length));
+    TEST_ASSERT_EQUAL(16, output_length);
+    TEST_ASSERT_EQUAL_STRING_LEN("MZXW6YTBOI======", encoded, 16);
+
+    struct iovec text[] = {{"MZXW6Y", 6}, {"TBO", 3}, {"I======", 7}};
+    struct iovec bytes[] = {{decoded, 4}, {decoded + 4, BUFFER_SIZE - 4}};
+    TEST_ASSERT_EQUAL(BASE32_SUCCESS, base32_decode_iov(ctx, text, 3, bytes, 2, &output_length));
+    TEST_ASSERT_EQUAL(6, output_length);
+    TEST_ASSERT_EQUAL_MEMORY("foobar", decoded, 6);
+
+    base32_free(ctx);
+}
+
+// Compare the fixed-length base32 encoder with the generic encoder
+void test_base32_fixed(void) {
+    base32_config_t config = {0, 0, 0, "", 1};
+    base32_ctx_t *ctx;
+    base32_init(&ctx, &config);
+
+    uint8_t input[256];
+    for (int i = 0; i < 256; i++) input[i] = (uint8_t) (i * 73 + 5);
+
+    char expected[BUFFER_SIZE], actual[BUFFER_SIZE];
+    size_t output_length;
+    for (int offset = 0; offset + 32 <= 256; offset += 8) {
+        base32_encode(ctx, input + offset, 32, expected, sizeof(expected), &output_length);
+        base32_encode_32(input + offset, actual);
+        TEST_ASSERT_EQUAL(52, output_length);
+        TEST_ASSERT_EQUAL_MEMORY(expected, actual, 52);
+    }
+
+    base32_free(ctx);
+}
+
+void test_base32_word_classes(void) {
+    const char *alphabets[2] = {"ABCDEFGHIJKLMNOPQRSTUVWXYZ234567", "0123456789ABCDEFGHIJKLMNOPQRSTUV"};
+    for (int hex = 0; hex < 2; hex++) {
+        base32_config_t config = {0, hex, 0, "", 1};
+        base32_ctx_t *ctx;
+        base32_init(&ctx, &config);
+
+        // Every byte value in every lane of a word must classify as the alphabet says
+        for (int position = 0; position < 8; position++) {
+            for (int c = 1; c < 256; c++) {
+                if (c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '=') continue;
+                char input[16 + BASE32_SLOP_BYTES] = {0};
+                memcpy(input, alphabets[hex], 16);
+                input[position] = (char) c;
+
+                uint8_t actual[BUFFER_SIZE + BASE32_SLOP_BYTES];
+                size_t actual_length;
+                const base32_error_t result = base32_decode(ctx, input, 16, actual, sizeof(actual), &actual_length);
+                if (c == 0 || strchr(alphabets[hex], c) == NULL) {
+                    TEST_ASSERT_EQUAL(BASE32_ERROR_INVALID_INPUT, result);
+                    continue;
+                }
+                TEST_ASSERT_EQUAL(BASE32_SUCCESS, result);
+
+                // Reference: 5 bits per character from the alphabet index
+                uint8_t expected[10] = {0};
+                for (int k = 0; k < 16; k++) {
+                    const unsigned value = (unsigned) (strchr(alphabets[hex], input[k]) - alphabets[hex]);
+                    for (int bit = 0; bit < 5; bit++) {
+                        if (value & (16u >> bit)) expected[(5 * k + bit) / 8] |= (uint8_t) (0x80 >> ((5 * k + bit) % 8));
+                    }
+                }
+                TEST_ASSERT_EQUAL(10, actual_length);
+                TEST_ASSERT_EQUAL_MEMORY(expected, actual, 10);
+
+                TEST_ASSERT_EQUAL(BASE32_SUCCESS, base32_decode_slop(ctx, input, 16, actual, sizeof(actual),
+                                                                    &actual_length));
+                TEST_ASSERT_EQUAL_MEMORY(expected, actual, 10);
+            }
+        }
+        base32_free(ctx);
+    }
+}
+
+// Strict decoding accepts exactly what the encoder writes
+void test_base32_strict(void) {
+    base32_config_t padded = {1, 0, 0, "", 1};
+    base32_config_t unpadded = {0, 0, 0, "", 1};
+    base32_ctx_t *ctx, *raw;
+    base32_init(&ctx, &padded);
+    base32_init(&raw, &unpadded);
+
+    uint8_t decoded[BUFFER_SIZE];
+    size_t output_length;
+    for (size_t i = 0; i < sizeof(base32TestVectors) / sizeof(base32TestVectors[0]); i++) {
+        // The third column holds the unpadded standard spelling
+        const struct Base32TestVector *tv = &base32TestVectors[i];
+        TEST_ASSERT_EQUAL(BASE32_SUCCESS, base32_decode_strict(ctx, tv->encoded, strlen(tv->encoded),
+                                                              decoded, strlen(tv->input), &output_length));
+        TEST_ASSERT_EQUAL(strlen(tv->input), output_length);
+        TEST_ASSERT_EQUAL_MEMORY(tv->input, decoded, output_length);
+
+        TEST_ASSERT_EQUAL(BASE32_SUCCESS, base32_decode_strict(raw, tv->encoded_hex, strlen(tv->encoded_hex),
+                                                              decoded, sizeof(decoded), &output_length));
+        TEST_ASSERT_EQUAL(strlen(tv->input), output_length);
+        TEST_ASSERT_EQUAL_MEMORY(tv->input, decoded, output_length);
+        if (strcmp(tv->encoded, tv->encoded_hex) != 0) {
+            TEST_ASSERT_EQUAL(BASE32_ERROR_PADDING, base32_decode_strict(ctx, tv->encoded_hex, strlen(tv->encoded_hex),
+                                                                        decoded, sizeof(decoded), &output_length));
+            TEST_ASSERT_EQUAL(BASE32_ERROR_PADDING, base32_decode_strict(raw, tv->encoded, strlen(tv->encoded),
+                                                                        decoded, sizeof(decoded), &output_length));
+        }
+    }
+
+    TEST_ASSERT_EQUAL(BASE32_ERROR_PADDING, base32_decode_strict(ctx, "MZ======", 8, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE32_ERROR_PADDING, base32_decode_strict(ctx, "MZXW6YR=", 8, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE32_ERROR_PADDING, base32_decode_strict(ctx, "MY=====", 7, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE32_ERROR_INVALID_LENGTH, base32_decode_strict(ctx, "MZX=====", 8, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE32_ERROR_INVALID_INPUT, base32_decode_strict(ctx, "MZXW 6YT", 8, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE32_ERROR_INVALID_INPUT, base32_decode_strict(ctx, "mzxw6ytb", 8, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE32_ERROR_INVALID_INPUT, base32_decode_strict(ctx, "MZXW6Y1=", 8, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE32_ERROR_BUFFER_TOO_SMALL, base32_decode_strict(ctx, "MZXW6YTBOI======", 16, decoded, 5, &output_length));
+
+    base32_free(ctx);
+    base32_free(raw);
+}
@@ -127,3 +127,486 @@ void test_base64_invalid_inputs(void) {
 }
 
 
+
+// Test the padded-buffer (slop) variants against the regular vectors
+void test_base64_slop(void) {
+    base64_config_t config = {1, 0, 0, ""};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+
+    size_t output_length;
+    uint8_t input[BUFFER_SIZE + BASE64_SLOP_BYTES];
+    char encoded[BUFFER_SIZE + BASE64_SLOP_BYTES];
+    uint8_t decoded[BUFFER_SIZE + BASE64_SLOP_BYTES];
+
+    for (size_t i = 0; i < sizeof(base64TestVectors) / sizeof(base64TestVectors[0]); i++) {
+        const size_t length = strlen(base64TestVectors[i].input);
+        memset(input, 0xA5, sizeof(input));  // Garbage in the slop region must not leak
+        memcpy(input, base64TestVectors[i].input, length);
+
+        TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode_slop(ctx, input, length, encoded, BUFFER_SIZE, &output_length));
+        TEST_ASSERT_EQUAL_STRING(base64TestVectors[i].encoded, encoded);
+
+        TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_slop(ctx, encoded, output_length, decoded, BUFFER_SIZE, &output_length));
+        TEST_ASSERT_EQUAL(length, output_length);
+        TEST_ASSERT_EQUAL_MEMORY(base64TestVectors[i].input, decoded, length);
+    }
+
+    memcpy(encoded, "Zm9v YmF", 8);
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode_slop(ctx, encoded, 8, decoded, BUFFER_SIZE, &output_length));
+
+    base64_free(ctx);
+}
+
+// Test exact-size encoding without a terminator, packed back to back
+void test_base64_no_terminator(void) {
+    base64_config_t config = {1, 0, 0, "", 1};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+
+    char arena[BUFFER_SIZE];
+    char expected[BUFFER_SIZE] = "";
+    size_t offset = 0, output_size, output_length;
+    memset(arena, '#', sizeof(arena));
+
+    for (size_t i = 0; i < sizeof(base64TestVectors) / sizeof(base64TestVectors[0]); i++) {
+        const size_t length = strlen(base64TestVectors[i].input);
+        base64_get_encode_size(length, ctx, &output_size);
+        TEST_ASSERT_EQUAL(strlen(base64TestVectors[i].encoded), output_size);
+        TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode(ctx, (const uint8_t *)base64TestVectors[i].input, length,
+                                                       arena + offset, output_size, &output_length));
+        offset += output_length;
+        strcat(expected, base64TestVectors[i].encoded);
+    }
+    TEST_ASSERT_EQUAL_STRING_LEN(expected, arena, offset);
+    TEST_ASSERT_EQUAL('#', arena[offset]);
+    base64_free(ctx);
+
+    // Line breaks are part of the exact size
+    base64_config_t wrapped = {0, 0, 4, "\r\n", 1};
+    base64_init(&ctx, &wrapped);
+    base64_get_encode_size(7, ctx, &output_size);
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode(ctx, (const uint8_t *)"foobar!", 7, arena, output_size, &output_length));
+    TEST_ASSERT_EQUAL(output_size, output_length);
+    TEST_ASSERT_EQUAL_STRING_LEN("Zm9v\r\nYmFy\r\nIQ", arena, output_length);
+    base64_free(ctx);
+}
+
+// Test scatter/gather encoding and decoding with quanta split across segments
+void test_base64_iov(void) {
+    base64_config_t config = {1, 0, 0, ""};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+
+    char encoded[BUFFER_SIZE];
+    uint8_t decoded[BUFFER_SIZE];
+    size_t output_length;
+
+    // "foobar" in segments of 1, 4 and 1 bytes, written into 3-byte segments
+    struct iovec input[] = {{"f", 1}, {"ooba", 4}, {"r", 1}};
+    struct iovec output[] = {{encoded, 3}, {encoded + 3, 3}, {encoded + 6, 3}};
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode_iov(ctx, input, 3, output, 3, &output_length));
+    TEST_ASSERT_EQUAL(8, output_length);
+    TEST_ASSERT_EQUAL_STRING_LEN("Zm9vYmFy", encoded, 8);
+
+    TEST_ASSERT_EQUAL(BASE64_ERROR_BUFFER_TOO_SMALL, base64_encode_iov(ctx, input, 3, output, 2, &output_length));
+
+    // Padding and whitespace split across segments
+    struct iovec text[] = {{"Zm9v\nY", 6}, {"g=", 2}, {"=", 1}};
+    struct iovec bytes[] = {{decoded, 2}, {decoded + 2, BUFFER_SIZE - 2}};
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_iov(ctx, text, 3, bytes, 2, &output_length));
+    TEST_ASSERT_EQUAL(4, output_length);
+    TEST_ASSERT_EQUAL_MEMORY("foob", decoded, 4);
+
+    struct iovec bad[] = {{"Zm9v", 4}, {"Y*==", 4}};
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode_iov(ctx, bad, 2, bytes, 2, &output_length));
+
+    base64_free(ctx);
+}
+
+struct SinkCapture {
+    uint8_t *data;
+    size_t length;
+    int calls;
+    int fail_after;
+};
+
+static int capture_sink(void *user_data, const void *data, size_t length) {
+    struct SinkCapture *capture = user_data;
+    if (capture->fail_after > 0 && capture->calls == capture->fail_after) return -1;
+    memcpy(capture->data + capture->length, data, length);
+    capture->length += length;
+    capture->calls++;
+    return 0;
+}
+
+// Test block-wise output through a callback
+void test_base64_sink(void) {
+    base64_config_t config = {1, 0, 76, "\n"};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+
+    const size_t length = 40000;
+    uint8_t *input = malloc(length);
+    for (size_t i = 0; i < length; i++) input[i] = (uint8_t)(i * 31 + 7);
+
+    size_t output_size, output_length;
+    base64_get_encode_size(length, ctx, &output_size);
+    char *expected = malloc(output_size);
+    base64_encode(ctx, input, length, expected, output_size, &output_length);
+
+    struct SinkCapture capture = {malloc(output_size), 0, 0, 0};
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode_to_sink(ctx, input, length, capture_sink, &capture));
+    TEST_ASSERT_EQUAL(output_length, capture.length);
+    TEST_ASSERT_EQUAL((output_length + BEK_SINK_BLOCK_SIZE - 1) / BEK_SINK_BLOCK_SIZE, capture.calls);
+    TEST_ASSERT_EQUAL_MEMORY(expected, capture.data, output_length);
+
+    struct SinkCapture decoded = {malloc(length), 0, 0, 0};
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_to_sink(ctx, expected, output_length, capture_sink, &decoded));
+    TEST_ASSERT_EQUAL(length, decoded.length);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded.data, length);
+
+    struct SinkCapture aborted = {capture.data, 0, 0, 1};
+    TEST_ASSERT_EQUAL(BASE64_ERROR_CALLBACK, base64_encode_to_sink(ctx, input, length, capture_sink, &aborted));
+
+    free(decoded.data);
+    free(capture.data);
+    free(expected);
+    free(input);
+    base64_free(ctx);
+}
+
+// Test encoding and decoding across the wrap point of ring buffers
+void test_base64_ring(void) {
+    base64_config_t config = {1, 0, 0, ""};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+
+    // "foobar" stored as "bar", 2 free bytes, "foo" with the used region wrapping
+    uint8_t in_storage[8] = {'b', 'a', 'r', '?', '?', 'f', 'o', 'o'};
+    bek_ring_t input = {in_storage, sizeof(in_storage), 5, 6};
+
+    uint8_t out_storage[10];
+    bek_ring_t output = {out_storage, sizeof(out_storage), 6, 1};
+    size_t output_length;
+
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode_ring(ctx, &input, &output, &output_length));
+    TEST_ASSERT_EQUAL(8, output_length);
+    TEST_ASSERT_EQUAL(9, output.length);
+    TEST_ASSERT_EQUAL_MEMORY("Zm9", out_storage + 7, 3);
+    TEST_ASSERT_EQUAL_MEMORY("vYmFy", out_storage, 5);
+
+    // Decode the encoded text back out of the output ring
+    bek_ring_t encoded = {out_storage, sizeof(out_storage), 7, 8};
+    uint8_t dec_storage[6];
+    bek_ring_t decoded = {dec_storage, sizeof(dec_storage), 4, 0};
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_ring(ctx, &encoded, &decoded, &output_length));
+    TEST_ASSERT_EQUAL(6, decoded.length);
+    TEST_ASSERT_EQUAL_MEMORY("fo", dec_storage + 4, 2);
+    TEST_ASSERT_EQUAL_MEMORY("obar", dec_storage, 4);
+
+    // Not enough free space leaves the ring untouched
+    TEST_ASSERT_EQUAL(BASE64_ERROR_BUFFER_TOO_SMALL, base64_encode_ring(ctx, &input, &output, &output_length));
+    TEST_ASSERT_EQUAL(9, output.length);
+
+    base64_free(ctx);
+}
+
+// Compare the fixed-length base64url encoders with the generic encoder
+void test_base64_fixed(void) {
+    base64_config_t config = {0, 1, 0, "", 1};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+
+    uint8_t input[256];
+    for (int i = 0; i < 256; i++) input[i] = (uint8_t) (i * 37 + 11);
+
+    char expected[128], actual[128];
+    size_t output_length;
+    for (int offset = 0; offset + 64 <= 256; offset += 16) {
+        base64_encode(ctx, input + offset, 20, expected, sizeof(expected), &output_length);
+        base64url_encode_20(input + offset, actual);
+        TEST_ASSERT_EQUAL(27, output_length);
+        TEST_ASSERT_EQUAL_MEMORY(expected, actual, 27);
+
+        base64_encode(ctx, input + offset, 32, expected, sizeof(expected), &output_length);
+        base64url_encode_32(input + offset, actual);
+        TEST_ASSERT_EQUAL(43, output_length);
+        TEST_ASSERT_EQUAL_MEMORY(expected, actual, 43);
+
+        base64_encode(ctx, input + offset, 64, expected, sizeof(expected), &output_length);
+        base64url_encode_64(input + offset, actual);
+        TEST_ASSERT_EQUAL(86, output_length);
+        TEST_ASSERT_EQUAL_MEMORY(expected, actual, 86);
+    }
+
+    for (unsigned v = 0; v < 64; v++) {
+        TEST_ASSERT_EQUAL("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"[v], base64url_value_char(v));
+    }
+
+    base64_free(ctx);
+}
+
+void test_base64_word_classes(void) {
+    const char *alphabets[2] = {
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+    };
+    for (int url = 0; url < 2; url++) {
+        base64_config_t config = {0, url, 0, "", 1};
+        base64_ctx_t *ctx;
+        base64_init(&ctx, &config);
+
+        // Every byte value in every lane of a word must classify as the table does
+        for (int position = 0; position < 8; position++) {
+            for (int c = 1; c < 256; c++) {
+                if (c == ' ' || c == '\n' || c == '\r' || c == '=') continue;
+                char input[16 + BASE64_SLOP_BYTES] = {0};
+                memcpy(input, "QUJDREVGR0hJSktM", 16);
+                input[position] = (char) c;
+
+                uint8_t actual[64], expected[64 + BASE64_SLOP_BYTES];
+                size_t actual_length, expected_length;
+                const base64_error_t result = base64_decode(ctx, input, 16, actual, sizeof(actual), &actual_length);
+                if (strchr(alphabets[url], c) == NULL) {
+                    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, result);
+                    continue;
+                }
+                TEST_ASSERT_EQUAL(BASE64_SUCCESS, result);
+                TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_slop(ctx, input, 16, expected, sizeof(expected),
+                                                                    &expected_length));
+                TEST_ASSERT_EQUAL(expected_length, actual_length);
+                TEST_ASSERT_EQUAL_MEMORY(expected, actual, actual_length);
+            }
+        }
+        base64_free(ctx);
+    }
+}
+
+// Wrapped input must decode as the compact text does, whether every line keeps
+// the first line's layout or the layout breaks part way through
+void test_base64_decode_wrapped(void) {
+    base64_config_t config = {1, 0, 76, "\r\n", 1};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+
+    uint8_t input[400];
+    for (int i = 0; i < (int) sizeof(input); i++) input[i] = (uint8_t) (i * 131 + 17);
+
+    char mime[640], compact[640];
+    size_t mime_length, compact_length, output_length;
+    uint8_t decoded[512];
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode(ctx, input, sizeof(input), mime, sizeof(mime), &mime_length));
+    for (size_t i = compact_length = 0; i < mime_length; i++) {
+        if (mime[i] != '\r' && mime[i] != '\n') compact[compact_length++] = mime[i];
+    }
+
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode(ctx, mime, mime_length, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(sizeof(input), output_length);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded, sizeof(input));
+
+    // LF only, with a short line and then a space inside a line breaking the
+    // layout; an empty piece marks where the space goes
+    const size_t cuts[] = {76, 152, 200, 276, 300, 0, 352, compact_length};
+    char broken[700];
+    size_t length = 0, start = 0;
+    for (size_t c = 0; c < sizeof(cuts) / sizeof(cuts[0]); c++) {
+        if (cuts[c] == 0) {
+            broken[length++] = ' ';
+            continue;
+        }
+        memcpy(broken + length, compact + start, cuts[c] - start);
+        length += cuts[c] - start;
+        start = cuts[c];
+        if (c + 1 < sizeof(cuts) / sizeof(cuts[0]) && cuts[c + 1] != 0) broken[length++] = '\n';
+    }
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode(ctx, broken, length, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(sizeof(input), output_length);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded, sizeof(input));
+
+    // An invalid character in a line of the regular layout is still an error
+    mime[80] = '*';
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode(ctx, mime, mime_length, decoded, sizeof(decoded), &output_length));
+
+    base64_free(ctx);
+}
+
+// A configured ignore set: JSON-style layout across several compaction blocks
+// decodes as the compact text does, and characters outside the set are errors
+void test_base64_ignore_set(void) {
+    base64_config_t bad = {1, 0, 0, "", 1, " A"};
+    base64_ctx_t *ctx;
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_init(&ctx, &bad));
+    bad.ignore = "=";
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_init(&ctx, &bad));
+
+    base64_config_t config = {1, 0, 0, "", 1, " \t\r\n\","};
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_init(&ctx, &config));
+
+    enum { SIZE = 9000 };
+    uint8_t *input = malloc(SIZE);
+    char *compact = malloc(2 * SIZE), *messy = malloc(4 * SIZE);
+    uint8_t *decoded = malloc(2 * SIZE);
+    for (int i = 0; i < SIZE; i++) input[i] = (uint8_t) (i * 31 + (i >> 5));
+
+    size_t compact_length, messy_length = 0, output_length;
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode(ctx, input, SIZE - 1, compact, 2 * SIZE, &compact_length));
+    for (size_t i = 0; i < compact_length; i++) {
+        if (i % 37 == 0) messy[messy_length++] = '"';
+        if (i % 53 == 0) {
+            memcpy(messy + messy_length, ",\n\t  \"", 6);
+            messy_length += 6;
+        }
+        messy[messy_length++] = compact[i];
+    }
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode(ctx, messy, messy_length, decoded, 2 * SIZE, &output_length));
+    TEST_ASSERT_EQUAL(SIZE - 1, output_length);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded, SIZE - 1);
+
+    // The streaming and iovec decoders skip the same set
+    bek_stream_t stream;
+    bek_stream_init(&stream);
+    size_t consumed, tail;
+    memset(decoded, 0, 2 * SIZE);
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_update(ctx, &stream, messy, messy_length, &consumed,
+                                                           decoded, 2 * SIZE, &output_length));
+    TEST_ASSERT_EQUAL(messy_length, consumed);
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_final(ctx, &stream, decoded + output_length,
+                                                          2 * SIZE - output_length, &tail));
+    TEST_ASSERT_EQUAL(SIZE - 1, output_length + tail);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded, SIZE - 1);
+
+    struct iovec text[] = {{messy, 1000}, {messy + 1000, messy_length - 1000}};
+    struct iovec bytes[] = {{decoded, 2 * SIZE}};
+    memset(decoded, 0, 2 * SIZE);
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_iov(ctx, text, 2, bytes, 1, &output_length));
+    TEST_ASSERT_EQUAL(SIZE - 1, output_length);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded, SIZE - 1);
+
+    // An invalid character deep in the text, in a block that gets compacted
+    messy[messy_length - 100] = '*';
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode(ctx, messy, messy_length, decoded, 2 * SIZE, &output_length));
+    base64_free(ctx);
+
+    // Without '\n' in the set, a line break is invalid input
+    config.ignore = " ";
+    base64_init(&ctx, &config);
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode(ctx, "Zm9v\nYmFy", 9, decoded, 2 * SIZE, &output_length));
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode(ctx, "Zm9v YmFy", 9, decoded, 2 * SIZE, &output_length));
+    TEST_ASSERT_EQUAL(6, output_length);
+    bek_stream_init(&stream);
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode_update(ctx, &stream, "Zm9v\nYmFy", 9, &consumed,
+                                                                       decoded, 2 * SIZE, &output_length));
+    TEST_ASSERT_EQUAL(4, consumed);
+    base64_free(ctx);
+
+    free(input);
+    free(compact);
+    free(messy);
+    free(decoded);
+}
+
+// Strict decoding accepts exactly what the encoder writes
+void test_base64_strict(void) {
+    base64_config_t padded = {1, 0, 0, "", 1};
+    base64_config_t url = {0, 1, 0, "", 1};
+    base64_ctx_t *ctx, *url_ctx;
+    base64_init(&ctx, &padded);
+    base64_init(&url_ctx, &url);
+
+    uint8_t decoded[BUFFER_SIZE];
+    size_t output_length;
+    for (size_t i = 0; i < sizeof(base64TestVectors) / sizeof(base64TestVectors[0]); i++) {
+        const struct Base64TestVector *tv = &base64TestVectors[i];
+        TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_strict(ctx, tv->encoded, strlen(tv->encoded),
+                                                              decoded, strlen(tv->input), &output_length));
+        TEST_ASSERT_EQUAL(strlen(tv->input), output_length);
+        TEST_ASSERT_EQUAL_MEMORY(tv->input, decoded, output_length);
+
+        tv = &base64TestVectorsUrl[i];
+        TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_strict(url_ctx, tv->encoded, strlen(tv->encoded),
+                                                              decoded, sizeof(decoded), &output_length));
+        TEST_ASSERT_EQUAL(strlen(tv->input), output_length);
+        TEST_ASSERT_EQUAL_MEMORY(tv->input, decoded, output_length);
+    }
+
+    // Unused bits, missing, short, extra or unexpected padding
+    TEST_ASSERT_EQUAL(BASE64_ERROR_PADDING, base64_decode_strict(ctx, "Zh==", 4, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE64_ERROR_PADDING, base64_decode_strict(ctx, "Zm9=", 4, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE64_ERROR_PADDING, base64_decode_strict(ctx, "Zg", 2, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE64_ERROR_PADDING, base64_decode_strict(ctx, "Zg=", 3, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE64_ERROR_PADDING, base64_decode_strict(ctx, "Zg===", 5, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE64_ERROR_PADDING, base64_decode_strict(ctx, "Zm9v====", 8, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE64_ERROR_PADDING, base64_decode_strict(url_ctx, "Zg==", 4, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE64_ERROR_PADDING, base64_decode_strict(url_ctx, "Zv9", 3, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_LENGTH, base64_decode_strict(ctx, "Zm9vY===", 8, decoded, sizeof(decoded), &output_length));
+
+    // Whitespace, padding inside the text and the other variant's characters
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode_strict(ctx, "Zm9v YmF", 8, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode_strict(ctx, "Zg==Zg==", 8, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode_strict(url_ctx, "Zm+/", 4, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode_strict(url_ctx, "Z/8", 3, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE64_ERROR_BUFFER_TOO_SMALL, base64_decode_strict(ctx, "Zm9vYg==", 8, decoded, 3, &output_length));
+
+    // A bad character anywhere in a longer text, bulk loop included
+    uint8_t input[90];
+    char encoded[BUFFER_SIZE + 8];
+    size_t encoded_length;
+    for (int i = 0; i < (int) sizeof(input); i++) input[i] = (uint8_t) (i * 29 + 5);
+    base64_encode(url_ctx, input, sizeof(input) - 1, encoded, sizeof(encoded), &encoded_length);
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_strict(url_ctx, encoded, encoded_length, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(sizeof(input) - 1, output_length);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded, output_length);
+    for (size_t i = 0; i < encoded_length; i++) {
+        const char saved = encoded[i];
+        encoded[i] = '\n';
+        TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode_strict(url_ctx, encoded, encoded_length, decoded,
+                                                                          sizeof(decoded), &output_length));
+        encoded[i] = saved;
+    }
+
+    base64_free(ctx);
+    base64_free(url_ctx);
+}
+
+// UTF-16 variants: the same text as the char functions, one code unit per
+// character, through the kernels and across line breaks
+void test_base64_utf16(void) {
+    base64_config_t config = {1, 0, 10, "\r\n", 0};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+
+    uint8_t input[300], decoded[400];
+    for (size_t i = 0; i < sizeof(input); i++) input[i] = (uint8_t) (i * 41 + 7);
+    char text[512];
+    uint16_t wide[512];
+    size_t output_size, text_length, wide_length, output_length;
+
+    for (size_t n = 0; n <= sizeof(input); n += n < 8 ? 1 : 73) {
+        base64_get_encode_size(n, ctx, &output_size);
+        TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode(ctx, input, n, text, sizeof(text), &text_length));
+        TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode_utf16(ctx, input, n, wide, output_size, &wide_length));
+        TEST_ASSERT_EQUAL(text_length, wide_length);
+        for (size_t i = 0; i <= text_length; i++) TEST_ASSERT_EQUAL((uint8_t) text[i], wide[i]);
+
+        TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_utf16(ctx, wide, wide_length, decoded, sizeof(decoded), &output_length));
+        TEST_ASSERT_EQUAL(n, output_length);
+        TEST_ASSERT_EQUAL_MEMORY(input, decoded, n);
+    }
+    TEST_ASSERT_EQUAL(BASE64_ERROR_BUFFER_TOO_SMALL, base64_encode_utf16(ctx, input, 10, wide, 10, &wide_length));
+
+    // Whitespace between runs is skipped; a unit that only narrows to an
+    // alphabet character is not
+    const uint16_t spaced[] = {'Z', 'm', '9', 'v', ' ', 'Y', 'm', 'F', 'y', '\n'};
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_utf16(ctx, spaced, 10, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(6, output_length);
+    TEST_ASSERT_EQUAL_MEMORY("foobar", decoded, 6);
+    const uint16_t wrapped[] = {'Z', 'm', '9', 0x0176, 'Y', 'm', 'F', 'y'};
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode_utf16(ctx, wrapped, 8, decoded, sizeof(decoded), &output_length));
+    uint16_t long_text[64];
+    for (int i = 0; i < 64; i++) long_text[i] = 'Q';
+    long_text[37] = 0x2000 | 'Q';
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode_utf16(ctx, long_text, 64, decoded, sizeof(decoded), &output_length));
+
+    base64_free(ctx);
+}
@@ -0,0 +1,175 @@
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base85.h"
+
+#define BUFFER_SIZE 128
+
+struct Base85TestVector {
+    const char *input;
+    size_t length;
+    const char *ascii85;
+    const char *z85;
+};
+
+// Test vectors; Z85 "HelloWorld" is the example of ZeroMQ RFC 32
+const struct Base85TestVector base85TestVectors[] = {
+    {"", 0, "", ""},
+    {"f", 1, "Ac", "w="},
+    {"fo", 2, "Ao@", "w]v"},
+    {"foo", 3, "AoDS", "w]zO"},
+    {"foob", 4, "AoDTs", "w]zP%"},
+    {"fooba", 5, "AoDTs@/", "w]zP%ve"},
+    {"foobar", 6, "AoDTs@<)", "w]zP%vr8"},
+    {"\xff\xff\xff\xff", 4, "s8W-!", "%nSc0"},
+    {"\x86\x4f\xd2\x6f\xb5\x59\xf7\x5b", 8, "L/669[9<6.", "HelloWorld"},
+};
+
+void test_base85_encode_decode(void) {
+    for (int z85 = 0; z85 <= 1; z85++) {
+        base85_config_t config = {z85, 0, "", 0};
+        base85_ctx_t *ctx;
+        TEST_ASSERT_EQUAL(BASE85_SUCCESS, base85_init(&ctx, &config));
+
+        for (size_t i = 0; i < sizeof(base85TestVectors) / sizeof(base85TestVectors[0]); i++) {
+            const struct Base85TestVector *tv = &base85TestVectors[i];
+            const char *expected = z85 ? tv->z85 : tv->ascii85;
+            char encoded[BUFFER_SIZE];
+            uint8_t decoded[BUFFER_SIZE];
+            size_t output_size, output_length;
+
+            base85_get_encode_size(tv->length, ctx, &output_size);
+            TEST_ASSERT_EQUAL(strlen(expected) + 1, output_size);
+            TEST_ASSERT_EQUAL(BASE85_SUCCESS, base85_encode(ctx, (const uint8_t *) tv->input, tv->length,
+                                                           encoded, output_size, &output_length));
+            TEST_ASSERT_EQUAL_STRING(expected, encoded);
+
+            TEST_ASSERT_EQUAL(BASE85_SUCCESS, base85_decode(ctx, expected, strlen(expected),
+                                                           decoded, sizeof(decoded), &output_length));
+            TEST_ASSERT_EQUAL(tv->length, output_length);
+            TEST_ASSERT_EQUAL_MEMORY(tv->input, decoded, tv->length);
+        }
+        base85_free(ctx);
+    }
+}
+
+// Test 'z' groups, whitespace and line wrapping
+void test_base85_ascii85_extras(void) {
+    base85_config_t config = {0, 0, "", 1};
+    base85_ctx_t *ctx;
+    base85_init(&ctx, &config);
+
+    uint8_t decoded[BUFFER_SIZE];
+    size_t output_length;
+    TEST_ASSERT_EQUAL(BASE85_SUCCESS, base85_decode(ctx, "z\nz !<", 6, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(9, output_length);
+    TEST_ASSERT_EQUAL_MEMORY("\0\0\0\0\0\0\0\0\1", decoded, 9);
+    base85_free(ctx);
+
+    base85_config_t wrapped = {0, 4, "\n", 1};
+    base85_init(&ctx, &wrapped);
+    char encoded[BUFFER_SIZE];
+    size_t output_size;
+    base85_get_encode_size(6, ctx, &output_size);
+    TEST_ASSERT_EQUAL(BASE85_SUCCESS, base85_encode(ctx, (const uint8_t *) "foobar", 6, encoded, output_size, &output_length));
+    TEST_ASSERT_EQUAL(output_size, output_length);
+    TEST_ASSERT_EQUAL_STRING_LEN("AoDT\ns@<)\n", encoded, output_length);
+
+    TEST_ASSERT_EQUAL(BASE85_SUCCESS, base85_decode(ctx, encoded, output_length, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(6, output_length);
+    TEST_ASSERT_EQUAL_MEMORY("foobar", decoded, 6);
+    base85_free(ctx);
+}
+
+// Test handling invalid inputs
+void test_base85_invalid_inputs(void) {
+    base85_config_t config = {0, 0, "", 0};
+    base85_config_t z85_config = {1, 0, "", 0};
+    base85_ctx_t *ctx, *z85;
+    base85_init(&ctx, &config);
+    base85_init(&z85, &z85_config);
+
+    uint8_t decoded[BUFFER_SIZE];
+    size_t output_length;
+
+    TEST_ASSERT_EQUAL(BASE85_ERROR_NULL_POINTER, base85_encode(ctx, NULL, 0, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL(BASE85_ERROR_BUFFER_TOO_SMALL, base85_encode(ctx, (const uint8_t *) "test", 4, (char *) decoded, 5, &output_length));
+    TEST_ASSERT_EQUAL(BASE85_ERROR_BUFFER_TOO_SMALL, base85_decode(ctx, "AoDTs", 5, decoded, 4, &output_length));
+
+    // Characters outside the alphabet, 'z' inside a group, a lone trailing character
+    TEST_ASSERT_EQUAL(BASE85_ERROR_INVALID_INPUT, base85_decode(ctx, "AoDTv", 5, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE85_ERROR_INVALID_INPUT, base85_decode(ctx, "AozTs", 5, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE85_ERROR_INVALID_INPUT, base85_decode(z85, "w]zP~", 5, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE85_ERROR_INVALID_LENGTH, base85_decode(ctx, "AoDTsA", 6, decoded, sizeof(decoded), &output_length));
+
+    // Groups above 2^32 - 1, whole and partial
+    TEST_ASSERT_EQUAL(BASE85_ERROR_INVALID_INPUT, base85_decode(ctx, "s8W-\"", 5, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE85_ERROR_INVALID_INPUT, base85_decode(ctx, "uuuuu", 5, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE85_ERROR_INVALID_INPUT, base85_decode(ctx, "uu", 2, decoded, sizeof(decoded), &output_length));
+    TEST_ASSERT_EQUAL(BASE85_ERROR_INVALID_INPUT, base85_decode(z85, "%nSc1", 5, decoded, sizeof(decoded), &output_length));
+
+    base85_free(ctx);
+    base85_free(z85);
+}
+
+// Stream one byte or character at a time and through iovecs; the results must
+// match the one-shot calls
+void test_base85_stream(void) {
+    base85_config_t config = {0, 7, "\n", 1};
+    base85_ctx_t *ctx;
+    base85_init(&ctx, &config);
+
+    uint8_t input[61];
+    for (int i = 0; i < (int) sizeof(input); i++) input[i] = (uint8_t) (i * 97 + 3);
+    memset(input + 8, 0, 8);
+
+    char whole[BUFFER_SIZE], streamed[BUFFER_SIZE];
+    size_t whole_length, offset = 0, consumed, produced;
+    TEST_ASSERT_EQUAL(BASE85_SUCCESS, base85_encode(ctx, input, sizeof(input), whole, sizeof(whole), &whole_length));
+
+    bek_stream_t stream;
+    bek_stream_init(&stream);
+    for (size_t i = 0; i < sizeof(input); i++) {
+        TEST_ASSERT_EQUAL(BASE85_SUCCESS, base85_encode_update(ctx, &stream, input + i, 1, &consumed,
+                                                              streamed + offset, sizeof(streamed) - offset, &produced));
+        offset += produced;
+    }
+    TEST_ASSERT_EQUAL(BASE85_SUCCESS, base85_encode_final(ctx, &stream, streamed + offset, sizeof(streamed) - offset, &produced));
+    offset += produced;
+    TEST_ASSERT_EQUAL(whole_length, offset);
+    TEST_ASSERT_EQUAL_MEMORY(whole, streamed, whole_length);
+
+    // Decode with a 'z' in place of the zero group, one character at a time
+    char text[BUFFER_SIZE];
+    memcpy(text, "z\n", 2);
+    memcpy(text + 2, whole, whole_length);
+    uint8_t decoded[BUFFER_SIZE];
+    offset = 0;
+    bek_stream_init(&stream);
+    for (size_t i = 0; i < whole_length + 2; i++) {
+        TEST_ASSERT_EQUAL(BASE85_SUCCESS, base85_decode_update(ctx, &stream, text + i, 1, &consumed,
+                                                              decoded + offset, sizeof(decoded) - offset, &produced));
+        offset += produced;
+    }
+    TEST_ASSERT_EQUAL(BASE85_SUCCESS, base85_decode_final(ctx, &stream, decoded + offset, sizeof(decoded) - offset, &produced));
+    offset += produced;
+    TEST_ASSERT_EQUAL(sizeof(input) + 4, offset);
+    TEST_ASSERT_EQUAL_MEMORY("\0\0\0\0", decoded, 4);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded + 4, sizeof(input));
+
+    struct iovec pieces[] = {{text, 3}, {text + 3, 11}, {text + 14, whole_length + 2 - 14}};
+    struct iovec bytes[] = {{decoded, 5}, {decoded + 5, sizeof(decoded) - 5}};
+    TEST_ASSERT_EQUAL(BASE85_SUCCESS, base85_decode_iov(ctx, pieces, 3, bytes, 2, &offset));
+    TEST_ASSERT_EQUAL(sizeof(input) + 4, offset);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded + 4, sizeof(input));
+
+    bek_stream_init(&stream);
+    TEST_ASSERT_EQUAL(BASE85_ERROR_INVALID_INPUT, base85_decode_update(ctx, &stream, "s8W-\"", 5, &consumed,
+                                                                      decoded, sizeof(decoded), &produced));
+    bek_stream_init(&stream);
+    base85_decode_update(ctx, &stream, "Ao", 1, &consumed, decoded, sizeof(decoded), &produced);
+    TEST_ASSERT_EQUAL(BASE85_ERROR_INVALID_LENGTH, base85_decode_final(ctx, &stream, decoded, sizeof(decoded), &produced));
+
+    base85_free(ctx);
+}
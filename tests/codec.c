@@ -0,0 +1,794 @@
+#include <unity.h>
+#include "bek_checksum.h"
+#include "bek_codec.h"
+#include "bek_file.h"
+#include "bek_pem.h"
+#include "bek_pool.h"
+#include "bek_uring.h"
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Encode and decode the same payload through the generic API of every codec
+void test_bek_codec_roundtrip(void) {
+    base64_config_t base64_config = {1, 0, 0, "", 1};
+    base32_config_t base32_config = {1, 0, 0, "", 1};
+    base16_config_t base16_config = {1, 0, "", 1};
+    base85_config_t base85_config = {0, 0, "", 1};
+    base64_ctx_t *base64_ctx;
+    base32_ctx_t *base32_ctx;
+    base16_ctx_t *base16_ctx;
+    base85_ctx_t *base85_ctx;
+    base64_init(&base64_ctx, &base64_config);
+    base32_init(&base32_ctx, &base32_config);
+    base16_init(&base16_ctx, &base16_config);
+    base85_init(&base85_ctx, &base85_config);
+
+    bek_codec_t codecs[4];
+    codecs[0].kind = BEK_CODEC_BASE64;
+    codecs[0].ctx.base64 = base64_ctx;
+    codecs[1].kind = BEK_CODEC_BASE32;
+    codecs[1].ctx.base32 = base32_ctx;
+    codecs[2].kind = BEK_CODEC_BASE16;
+    codecs[2].ctx.base16 = base16_ctx;
+    codecs[3].kind = BEK_CODEC_BASE85;
+    codecs[3].ctx.base85 = base85_ctx;
+
+    const char *expected[] = {"Zm9vYmFy", "MZXW6YTBOI======", "666F6F626172", "AoDTs@<)"};
+    const uint8_t input[] = "foobar";
+
+    for (int i = 0; i < 4; i++) {
+        char encoded[64];
+        uint8_t decoded[64];
+        size_t size, length;
+
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_get_encode_size(&codecs[i], 6, &size));
+        TEST_ASSERT_EQUAL(strlen(expected[i]), size);
+
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_encode(&codecs[i], input, 6, encoded, size, &length));
+        TEST_ASSERT_EQUAL(size, length);
+        TEST_ASSERT_EQUAL_MEMORY(expected[i], encoded, length);
+        TEST_ASSERT_EQUAL(BEK_ERROR_BUFFER_TOO_SMALL, bek_encode(&codecs[i], input, 6, encoded, size - 1, &length));
+
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_get_decode_size(&codecs[i], size, &size));
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_decode(&codecs[i], encoded, length, decoded, size, &length));
+        TEST_ASSERT_EQUAL(6, length);
+        TEST_ASSERT_EQUAL_MEMORY(input, decoded, 6);
+    }
+
+    TEST_ASSERT_EQUAL(BEK_ERROR_INVALID_INPUT, bek_decode(&codecs[0], "Zm9v!mFy", 8, (uint8_t[8]){0}, 8, &(size_t){0}));
+    TEST_ASSERT_EQUAL(BEK_ERROR_NULL_POINTER, bek_encode(NULL, input, 6, (char[16]){0}, 16, &(size_t){0}));
+
+    base64_free(base64_ctx);
+    base32_free(base32_ctx);
+    base16_free(base16_ctx);
+    base85_free(base85_ctx);
+}
+
+// Independently encoded chunks must concatenate into the one-shot encoding
+void test_bek_codec_chunks(void) {
+    base64_config_t config = {1, 0, 76, "\n", 1};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+
+    bek_codec_t codec;
+    codec.kind = BEK_CODEC_BASE64;
+    codec.ctx.base64 = ctx;
+
+    TEST_ASSERT_EQUAL(57, bek_encode_chunk_size(&codec, 1));
+    TEST_ASSERT_EQUAL(57 * 17, bek_encode_chunk_size(&codec, 1000));
+    TEST_ASSERT_EQUAL(0, bek_encode_chunk_size(NULL, 1000));
+
+    uint8_t input[300];
+    for (int i = 0; i < (int) sizeof(input); i++) input[i] = (uint8_t) (i * 7);
+
+    char whole[512], pieces[512];
+    size_t whole_length, offset = 0;
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_encode(&codec, input, sizeof(input), whole, sizeof(whole), &whole_length));
+
+    const size_t chunk = bek_encode_chunk_size(&codec, 100);
+    for (size_t pos = 0; pos < sizeof(input); pos += chunk) {
+        const size_t n = sizeof(input) - pos < chunk ? sizeof(input) - pos : chunk;
+        size_t length;
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_encode(&codec, input + pos, n, pieces + offset, sizeof(pieces) - offset, &length));
+        offset += length;
+    }
+
+    TEST_ASSERT_EQUAL(whole_length, offset);
+    TEST_ASSERT_EQUAL_MEMORY(whole, pieces, whole_length);
+
+    base64_free(ctx);
+}
+
+// Round-trip a file through the memory-mapped APIs with small parallel chunks
+void test_bek_file_roundtrip(void) {
+    base64_config_t config = {1, 0, 76, "\n", 1};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+
+    bek_codec_t codec;
+    codec.kind = BEK_CODEC_BASE64;
+    codec.ctx.base64 = ctx;
+
+    char plain_path[] = "/tmp/bek_plain_XXXXXX";
+    char encoded_path[] = "/tmp/bek_encoded_XXXXXX";
+    char decoded_path[] = "/tmp/bek_decoded_XXXXXX";
+    close(mkstemp(plain_path));
+    close(mkstemp(encoded_path));
+    close(mkstemp(decoded_path));
+
+    static uint8_t input[10000];
+    for (int i = 0; i < (int) sizeof(input); i++) input[i] = (uint8_t) (i * 31 + (i >> 8));
+    FILE *file = fopen(plain_path, "wb");
+    fwrite(input, 1, sizeof(input), file);
+    fclose(file);
+
+    const bek_file_options_t options = {4, 500};
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_encode_file(&codec, plain_path, encoded_path, &options));
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_decode_file(&codec, encoded_path, decoded_path, &options));
+
+    static char expected[16384];
+    static uint8_t actual[16384];
+    size_t expected_length;
+    bek_encode(&codec, input, sizeof(input), expected, sizeof(expected), &expected_length);
+
+    file = fopen(encoded_path, "rb");
+    TEST_ASSERT_EQUAL(expected_length, fread(actual, 1, sizeof(actual), file));
+    fclose(file);
+    TEST_ASSERT_EQUAL_MEMORY(expected, actual, expected_length);
+
+    file = fopen(decoded_path, "rb");
+    TEST_ASSERT_EQUAL(sizeof(input), fread(actual, 1, sizeof(actual), file));
+    fclose(file);
+    TEST_ASSERT_EQUAL_MEMORY(input, actual, sizeof(input));
+
+    TEST_ASSERT_EQUAL(BEK_ERROR_IO, bek_encode_file(&codec, "/nonexistent/bek", encoded_path, NULL));
+
+    remove(plain_path);
+    remove(encoded_path);
+    remove(decoded_path);
+    base64_free(ctx);
+}
+
+// Each Ascii85 'z' decodes to four bytes, so a block of them outgrows its input fourfold
+void test_bek_file_uring_zero_groups(void) {
+    base85_config_t config = {0, 0, "", 1};
+    base85_ctx_t *ctx;
+    base85_init(&ctx, &config);
+
+    bek_codec_t codec;
+    codec.kind = BEK_CODEC_BASE85;
+    codec.ctx.base85 = ctx;
+
+    char encoded_path[] = "/tmp/bek_encoded_XXXXXX";
+    char decoded_path[] = "/tmp/bek_decoded_XXXXXX";
+    close(mkstemp(encoded_path));
+    close(mkstemp(decoded_path));
+
+    static char input[3000];
+    memset(input, 'z', sizeof(input));
+    FILE *file = fopen(encoded_path, "wb");
+    fwrite(input, 1, sizeof(input), file);
+    fclose(file);
+
+    const bek_uring_options_t options = {4, 500};
+    const bek_error_t error = bek_decode_file_uring(&codec, encoded_path, decoded_path, &options);
+    // Skip when the backend is not built or the kernel refuses io_uring
+    if (error != BEK_ERROR_IO || (errno != ENOSYS && errno != EPERM)) {
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, error);
+
+        static uint8_t expected[4 * sizeof(input)];
+        static uint8_t actual[4 * sizeof(input) + 1];
+        file = fopen(decoded_path, "rb");
+        TEST_ASSERT_EQUAL(sizeof(expected), fread(actual, 1, sizeof(actual), file));
+        fclose(file);
+        TEST_ASSERT_EQUAL_MEMORY(expected, actual, sizeof(expected));
+    }
+
+    remove(encoded_path);
+    remove(decoded_path);
+    base85_free(ctx);
+}
+
+// Mix many small jobs, one job large enough to be split and one bad job
+void test_bek_pool_jobs(void) {
+    base64_config_t base64_config = {1, 0, 76, "\n", 1};
+    base16_config_t base16_config = {1, 0, "", 1};
+    base64_ctx_t *base64_ctx;
+    base16_ctx_t *base16_ctx;
+    base64_init(&base64_ctx, &base64_config);
+    base16_init(&base16_ctx, &base16_config);
+
+    bek_codec_t base64 = {.kind = BEK_CODEC_BASE64, .ctx.base64 = base64_ctx};
+    bek_codec_t base16 = {.kind = BEK_CODEC_BASE16, .ctx.base16 = base16_ctx};
+
+    enum { SMALL = 200, LARGE = 3 * BEK_POOL_SPLIT_SIZE + 1 };
+    static uint8_t small_input[SMALL][100];
+    static char small_output[SMALL][256];
+    uint8_t *large_input = malloc(LARGE);
+    char *large_encoded = malloc(2 * LARGE);
+    uint8_t *large_decoded = malloc(LARGE);
+    for (size_t i = 0; i < LARGE; i++) large_input[i] = (uint8_t) (i * 131 + (i >> 10));
+
+    bek_job_t jobs[SMALL + 2];
+    for (int i = 0; i < SMALL; i++) {
+        memset(small_input[i], i, sizeof(small_input[i]));
+        jobs[i] = (bek_job_t) {i % 2 ? &base64 : &base16, BEK_JOB_ENCODE, small_input[i], 1 + i % 100,
+                               small_output[i], sizeof(small_output[i]), 0, BEK_SUCCESS};
+    }
+    jobs[SMALL] = (bek_job_t) {&base64, BEK_JOB_ENCODE, large_input, LARGE, large_encoded, 2 * LARGE, 0, BEK_SUCCESS};
+    jobs[SMALL + 1] = (bek_job_t) {&base16, BEK_JOB_DECODE, "6G", 2, small_output[0], 1, 0, BEK_SUCCESS};
+
+    bek_pool_t *pool;
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pool_create(&pool, 4));
+    TEST_ASSERT_EQUAL(BEK_ERROR_INVALID_INPUT, bek_pool_run(pool, jobs, SMALL + 2));
+    TEST_ASSERT_EQUAL(BEK_ERROR_INVALID_INPUT, jobs[SMALL + 1].status);
+
+    for (int i = 0; i < SMALL; i++) {
+        char expected[256];
+        size_t expected_length;
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, jobs[i].status);
+        bek_encode(jobs[i].codec, small_input[i], jobs[i].input_length, expected, sizeof(expected), &expected_length);
+        TEST_ASSERT_EQUAL(expected_length, jobs[i].output_length);
+        TEST_ASSERT_EQUAL_MEMORY(expected, small_output[i], expected_length);
+    }
+
+    // Decode the large encoding back through the pool
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, jobs[SMALL].status);
+    bek_job_t decode = {&base64, BEK_JOB_DECODE, large_encoded, jobs[SMALL].output_length, large_decoded, LARGE, 0, BEK_SUCCESS};
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pool_run(pool, &decode, 1));
+    TEST_ASSERT_EQUAL(LARGE, decode.output_length);
+    TEST_ASSERT_EQUAL_MEMORY(large_input, large_decoded, LARGE);
+
+    bek_pool_free(pool);
+    free(large_input);
+    free(large_encoded);
+    free(large_decoded);
+    base64_free(base64_ctx);
+    base16_free(base16_ctx);
+}
+
+// Parallel decoders split text by the characters the context skips, so a
+// character only the configured ignore set skips must not shift a chunk
+void test_bek_ignore_set_parallel(void) {
+    base64_config_t config = {1, 0, 0, "", 1, " \r\n\t"};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+    bek_codec_t codec = {.kind = BEK_CODEC_BASE64, .ctx.base64 = ctx};
+
+    enum { SIZE = 3 * BEK_POOL_SPLIT_SIZE / 2 + 2 };
+    uint8_t *input = malloc(SIZE);
+    char *compact = malloc(2 * SIZE), *text = malloc(3 * SIZE);
+    uint8_t *decoded = malloc(SIZE + 3);
+    for (size_t i = 0; i < SIZE; i++) input[i] = (uint8_t) (i * 131 + (i >> 10));
+
+    // A tab every 61 characters, which the table alone does not skip
+    size_t compact_length, text_length = 0;
+    bek_encode(&codec, input, SIZE, compact, 2 * SIZE, &compact_length);
+    for (size_t i = 0; i < compact_length; i++) {
+        if (i % 61 == 60) text[text_length++] = '\t';
+        text[text_length++] = compact[i];
+    }
+    TEST_ASSERT_TRUE(text_length > 2 * BEK_POOL_SPLIT_SIZE);
+
+    bek_pool_t *pool;
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pool_create(&pool, 4));
+    bek_job_t decode = {&codec, BEK_JOB_DECODE, text, text_length, decoded, SIZE + 3, 0, BEK_SUCCESS};
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pool_run(pool, &decode, 1));
+    TEST_ASSERT_EQUAL(SIZE, decode.output_length);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded, SIZE);
+    bek_pool_free(pool);
+
+    char encoded_path[] = "/tmp/bek_encoded_XXXXXX";
+    char decoded_path[] = "/tmp/bek_decoded_XXXXXX";
+    close(mkstemp(encoded_path));
+    close(mkstemp(decoded_path));
+    FILE *file = fopen(encoded_path, "wb");
+    fwrite(text, 1, text_length, file);
+    fclose(file);
+
+    const bek_file_options_t options = {4, 256 * 1024};
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_decode_file(&codec, encoded_path, decoded_path, &options));
+    memset(decoded, 0, SIZE);
+    file = fopen(decoded_path, "rb");
+    TEST_ASSERT_EQUAL(SIZE, fread(decoded, 1, SIZE, file));
+    fclose(file);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded, SIZE);
+
+    remove(encoded_path);
+    remove(decoded_path);
+    free(input);
+    free(compact);
+    free(text);
+    free(decoded);
+    base64_free(ctx);
+}
+
+// Encode blocks of every tail length and decode them back through bek_pem_next
+void test_bek_pem_roundtrip(void) {
+    uint8_t input[200], decoded[200];
+    char text[512];
+    for (int i = 0; i < (int) sizeof(input); i++) input[i] = (uint8_t) (i * 29 + 11);
+
+    for (size_t length = 0; length <= sizeof(input); length += 7) {
+        size_t text_length, decoded_length, offset = 0;
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pem_encode("CERTIFICATE", input, length, text, sizeof(text), &text_length));
+        TEST_ASSERT_EQUAL(bek_pem_get_encode_size(11, length), text_length);
+        TEST_ASSERT_EQUAL_MEMORY("-----BEGIN CERTIFICATE-----\n", text, 28);
+        TEST_ASSERT_EQUAL_MEMORY("-----END CERTIFICATE-----\n", text + text_length - 26, 26);
+
+        bek_pem_block_t block;
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pem_next(text, text_length, &offset, &block));
+        TEST_ASSERT_EQUAL(text_length, offset);
+        TEST_ASSERT_EQUAL_STRING_LEN("CERTIFICATE", block.label, block.label_length);
+        TEST_ASSERT_TRUE(bek_pem_get_decode_size(&block) >= length);
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pem_decode(&block, decoded, sizeof(decoded), &decoded_length));
+        TEST_ASSERT_EQUAL(length, decoded_length);
+        TEST_ASSERT_EQUAL_MEMORY(input, decoded, length);
+    }
+
+    TEST_ASSERT_EQUAL(BEK_ERROR_BUFFER_TOO_SMALL, bek_pem_encode("KEY", input, 48, text, bek_pem_get_encode_size(3, 48) - 1, &(size_t){0}));
+}
+
+// Walk a bundle with explanatory text, CRLF lines, a 76-column block and bad blocks
+void test_bek_pem_bundle(void) {
+    const char bundle[] =
+        "subject=CN = Example - Root\n"
+        "-----BEGIN CERTIFICATE-----\r\n"
+        "AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8gISIjJCUmJygpKissLS4v\r\n"
+        "MDEy\r\n"
+        "-----END CERTIFICATE-----\r\n"
+        "\n"
+        "-----BEGIN PUBLIC KEY-----\n"
+        "AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8gISIjJCUmJygpKissLS4vMDEyMzQ1Njc4\n"
+        "OTo7PD0+Pw==\n"
+        "-----END PUBLIC KEY-----";
+    uint8_t expected[64], decoded[64];
+    for (int i = 0; i < 64; i++) expected[i] = (uint8_t) i;
+
+    size_t offset = 0, length;
+    bek_pem_block_t block;
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pem_next(bundle, sizeof(bundle) - 1, &offset, &block));
+    TEST_ASSERT_EQUAL_STRING_LEN("CERTIFICATE", block.label, block.label_length);
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pem_decode(&block, decoded, sizeof(decoded), &length));
+    TEST_ASSERT_EQUAL(51, length);
+    TEST_ASSERT_EQUAL_MEMORY(expected, decoded, 51);
+    TEST_ASSERT_EQUAL(BEK_ERROR_BUFFER_TOO_SMALL, bek_pem_decode(&block, decoded, 50, &length));
+
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pem_next(bundle, sizeof(bundle) - 1, &offset, &block));
+    TEST_ASSERT_EQUAL_STRING_LEN("PUBLIC KEY", block.label, block.label_length);
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pem_decode(&block, decoded, sizeof(decoded), &length));
+    TEST_ASSERT_EQUAL(64, length);
+    TEST_ASSERT_EQUAL_MEMORY(expected, decoded, 64);
+
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pem_next(bundle, sizeof(bundle) - 1, &offset, &block));
+    TEST_ASSERT_NULL(block.label);
+    TEST_ASSERT_EQUAL(sizeof(bundle) - 1, offset);
+
+    const char *bad[] = {
+        "-----BEGIN CERTIFICATE-----\nAAEC\n",
+        "-----BEGIN CERTIFICATE-----\nAAEC\n-----END KEY-----\n",
+        "-----BEGIN CERTIFICATE----- x\nAAEC\n-----END CERTIFICATE-----\n",
+    };
+    for (int i = 0; i < 3; i++) {
+        offset = 0;
+        TEST_ASSERT_EQUAL(BEK_ERROR_INVALID_INPUT, bek_pem_next(bad[i], strlen(bad[i]), &offset, &block));
+    }
+
+    const char corrupt[] = "-----BEGIN X-----\nAA*C\n-----END X-----\n";
+    offset = 0;
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pem_next(corrupt, sizeof(corrupt) - 1, &offset, &block));
+    TEST_ASSERT_EQUAL(BEK_ERROR_INVALID_INPUT, bek_pem_decode(&block, decoded, sizeof(decoded), &length));
+}
+
+// Bit-at-a-time CRC-32C to check the table and instruction paths against
+static uint32_t crc32c_reference(const uint8_t *p, size_t length) {
+    uint32_t crc = 0xFFFFFFFFu;
+    while (length--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+void test_bek_crc32c(void) {
+    TEST_ASSERT_EQUAL_HEX32(0xE3069283u, bek_crc32c(0, "123456789", 9));
+    TEST_ASSERT_EQUAL_HEX32(0, bek_crc32c(0, "", 0));
+
+    enum { SIZE = 1000 };
+    static uint8_t data[SIZE];
+    for (size_t i = 0; i < SIZE; i++) data[i] = (uint8_t) (i * 167 + (i >> 3));
+    const uint32_t whole = bek_crc32c(0, data, SIZE);
+    TEST_ASSERT_EQUAL_HEX32(crc32c_reference(data, SIZE), whole);
+
+    // Chained over uneven pieces, including unaligned starts
+    for (size_t split = 0; split <= 17; split++) {
+        TEST_ASSERT_EQUAL_HEX32(whole, bek_crc32c(bek_crc32c(0, data, split), data + split, SIZE - split));
+    }
+}
+
+// The fused calls must produce the output of bek_encode/bek_decode and the
+// checksum of the raw bytes, across block boundaries
+void test_bek_codec_crc32c(void) {
+    base64_config_t base64_config = {1, 0, 76, "\r\n", 1};
+    base32_config_t base32_config = {0, 0, 0, "", 1};
+    base16_config_t base16_config = {1, 0, "", 1};
+    base85_config_t base85_config = {1, 0, "", 1};
+    base64_ctx_t *base64_ctx;
+    base32_ctx_t *base32_ctx;
+    base16_ctx_t *base16_ctx;
+    base85_ctx_t *base85_ctx;
+    base64_init(&base64_ctx, &base64_config);
+    base32_init(&base32_ctx, &base32_config);
+    base16_init(&base16_ctx, &base16_config);
+    base85_init(&base85_ctx, &base85_config);
+    const bek_codec_t codecs[4] = {{.kind = BEK_CODEC_BASE64, .ctx.base64 = base64_ctx},
+                                   {.kind = BEK_CODEC_BASE32, .ctx.base32 = base32_ctx},
+                                   {.kind = BEK_CODEC_BASE16, .ctx.base16 = base16_ctx},
+                                   {.kind = BEK_CODEC_BASE85, .ctx.base85 = base85_ctx}};
+
+    enum { SIZE = 20000 };
+    uint8_t *input = malloc(SIZE), *decoded = malloc(SIZE);
+    char *expected = malloc(3 * SIZE), *encoded = malloc(3 * SIZE);
+    for (size_t i = 0; i < SIZE; i++) input[i] = (uint8_t) (i * 97 + (i >> 7));
+
+    const size_t lengths[] = {0, 1, 4, 8192, SIZE};
+    for (int c = 0; c < 4; c++) {
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            const size_t n = lengths[l];
+            size_t expected_length, length;
+            uint32_t crc = 0;
+            TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_encode(&codecs[c], input, n, expected, 3 * SIZE, &expected_length));
+            TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_encode_crc32c(&codecs[c], input, n, encoded, 3 * SIZE, &length, &crc));
+            TEST_ASSERT_EQUAL(expected_length, length);
+            TEST_ASSERT_EQUAL_MEMORY(expected, encoded, length);
+            TEST_ASSERT_EQUAL_HEX32(bek_crc32c(0, input, n), crc);
+
+            crc = 0;
+            TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_decode_crc32c(&codecs[c], encoded, length, decoded, SIZE, &length, &crc));
+            TEST_ASSERT_EQUAL(n, length);
+            TEST_ASSERT_EQUAL_MEMORY(input, decoded, n);
+            TEST_ASSERT_EQUAL_HEX32(bek_crc32c(0, input, n), crc);
+        }
+    }
+
+    // Chaining from a previous value, and the errors of bek_encode/bek_decode
+    uint32_t crc = bek_crc32c(0, input, 100);
+    size_t length;
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_encode_crc32c(&codecs[0], input + 100, 200, encoded, 3 * SIZE, &length, &crc));
+    TEST_ASSERT_EQUAL_HEX32(bek_crc32c(0, input, 300), crc);
+    TEST_ASSERT_EQUAL(BEK_ERROR_BUFFER_TOO_SMALL, bek_encode_crc32c(&codecs[0], input, 300, encoded, 10, &length, &crc));
+    TEST_ASSERT_EQUAL(BEK_ERROR_NULL_POINTER, bek_encode_crc32c(&codecs[0], input, 300, encoded, 3 * SIZE, &length, NULL));
+    TEST_ASSERT_EQUAL(BEK_ERROR_BUFFER_TOO_SMALL, bek_decode_crc32c(&codecs[2], "00112233", 8, decoded, 3, &length, &crc));
+    TEST_ASSERT_EQUAL(BEK_ERROR_INVALID_INPUT, bek_decode_crc32c(&codecs[2], "0011zz", 6, decoded, SIZE, &length, &crc));
+
+    base64_free(base64_ctx);
+    base32_free(base32_ctx);
+    base16_free(base16_ctx);
+    base85_free(base85_ctx);
+    free(input);
+    free(decoded);
+    free(expected);
+    free(encoded);
+}
+
+// Allocator that counts calls and can be told to fail; pool workers call it
+// concurrently
+struct counting_allocator {
+    atomic_int allocations;
+    atomic_int frees;
+    atomic_size_t live;
+    int fail;
+};
+
+static void *counting_alloc(void *user_data, const size_t size) {
+    struct counting_allocator *counter = user_data;
+    if (counter->fail) return NULL;
+    counter->allocations++;
+    counter->live += size;
+    return malloc(size);
+}
+
+static void counting_free(void *user_data, void *ptr, const size_t size) {
+    struct counting_allocator *counter = user_data;
+    counter->frees++;
+    counter->live -= size;
+    free(ptr);
+}
+
+void test_bek_buf(void) {
+    struct counting_allocator counter = {0};
+    const bek_allocator_t allocator = {counting_alloc, counting_free, &counter};
+    bek_buf_t buf;
+    bek_buf_init(&buf, &allocator);
+    TEST_ASSERT_NULL(buf.data);
+
+    // Geometric growth: 1000 single-byte appends take a handful of allocations
+    for (int i = 0; i < 1000; i++) {
+        const uint8_t byte = (uint8_t) i;
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_buf_append(&buf, &byte, 1));
+    }
+    TEST_ASSERT_EQUAL(1000, buf.length);
+    TEST_ASSERT_EQUAL(999 & 0xFF, buf.data[999]);
+    TEST_ASSERT_TRUE(counter.allocations <= 6);
+    TEST_ASSERT_EQUAL(counter.allocations - 1, counter.frees);
+
+    base64_config_t config = {1, 0, 0, "", 1};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+    const bek_codec_t codec = {.kind = BEK_CODEC_BASE64, .ctx.base64 = ctx};
+
+    // Appends after the existing contents, terminated but not counted
+    bek_buf_clear(&buf);
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_buf_append(&buf, "x=", 2));
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode_to_buf(ctx, (const uint8_t *) "foobar", 6, &buf));
+    TEST_ASSERT_EQUAL(10, buf.length);
+    TEST_ASSERT_EQUAL_STRING("x=Zm9vYmFy", (const char *) buf.data);
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_encode_to_buf(&codec, (const uint8_t *) "f", 1, &buf));
+    TEST_ASSERT_EQUAL_STRING("x=Zm9vYmFyZg==", (const char *) buf.data);
+
+    bek_buf_clear(&buf);
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_decode_to_buf(ctx, "Zm9v", 4, &buf));
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_decode_to_buf(&codec, "YmFy", 4, &buf));
+    TEST_ASSERT_EQUAL(6, buf.length);
+    TEST_ASSERT_EQUAL_MEMORY("foobar", buf.data, 6);
+    TEST_ASSERT_EQUAL(BASE64_ERROR_INVALID_INPUT, base64_decode_to_buf(ctx, "Zm*v", 4, &buf));
+    TEST_ASSERT_EQUAL(6, buf.length);
+
+    // Reused across calls, the buffer stops allocating
+    static uint8_t payload[5000];
+    const int before = counter.allocations;
+    for (size_t n = sizeof(payload); n > 0; n -= 500) {
+        bek_buf_clear(&buf);
+        TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode_to_buf(ctx, payload, n, &buf));
+        TEST_ASSERT_EQUAL((n + 2) / 3 * 4, buf.length);
+    }
+    TEST_ASSERT_EQUAL(before + 1, counter.allocations);
+
+    // A failing allocator leaves the contents alone
+    counter.fail = 1;
+    TEST_ASSERT_EQUAL(BASE64_ERROR_MEMORY, base64_encode_to_buf(ctx, payload, 2 * sizeof(payload), &buf));
+    TEST_ASSERT_EQUAL(BEK_ERROR_MEMORY, bek_buf_reserve(&buf, 2 * buf.capacity));
+    TEST_ASSERT_EQUAL((500 + 2) / 3 * 4, buf.length);
+
+    bek_buf_free(&buf);
+    TEST_ASSERT_NULL(buf.data);
+    TEST_ASSERT_EQUAL(counter.allocations, counter.frees);
+    TEST_ASSERT_EQUAL(0, counter.live);
+    base64_free(ctx);
+}
+
+// Contexts keep the allocator of their config; pools, file jobs and buffers
+// without one use the library allocator
+void test_bek_allocator(void) {
+    struct counting_allocator counter = {0};
+    const bek_allocator_t allocator = {counting_alloc, counting_free, &counter};
+
+    base32_config_t base32_config = {1, 0, 0, "", 1, &allocator};
+    base32_ctx_t *base32_ctx;
+    TEST_ASSERT_EQUAL(BASE32_SUCCESS, base32_init(&base32_ctx, &base32_config));
+    TEST_ASSERT_EQUAL(1, counter.allocations);
+    base32_free(base32_ctx);
+    TEST_ASSERT_EQUAL(1, counter.frees);
+
+    // Rejected and failed initializations leave nothing behind
+    base16_config_t rejected = {1, 0, "", 1, "a", &allocator};
+    base16_ctx_t *base16_ctx;
+    TEST_ASSERT_EQUAL(BASE16_ERROR_INVALID_INPUT, base16_init(&base16_ctx, &rejected));
+    counter.fail = 1;
+    base85_config_t base85_config = {0, 0, "", 1, &allocator};
+    base85_ctx_t *base85_ctx;
+    TEST_ASSERT_EQUAL(BASE85_ERROR_MEMORY, base85_init(&base85_ctx, &base85_config));
+    counter.fail = 0;
+    TEST_ASSERT_EQUAL(2, counter.allocations);
+    TEST_ASSERT_EQUAL(2, counter.frees);
+    TEST_ASSERT_EQUAL(0, counter.live);
+
+    bek_set_allocator(&allocator);
+    base64_config_t base64_config = {1, 0, 76, "\n", 1};
+    base64_ctx_t *base64_ctx;
+    base64_init(&base64_ctx, &base64_config);
+    const bek_codec_t codec = {.kind = BEK_CODEC_BASE64, .ctx.base64 = base64_ctx};
+
+    // Split encode and decode jobs plan their pieces through the allocator
+    enum { LARGE = 3 * BEK_POOL_SPLIT_SIZE + 1 };
+    uint8_t *input = malloc(LARGE);
+    char *encoded = malloc(2 * LARGE);
+    char *expected = malloc(2 * LARGE);
+    uint8_t *decoded = malloc(LARGE);
+    for (size_t i = 0; i < LARGE; i++) input[i] = (uint8_t) (i * 151 + (i >> 9));
+    size_t expected_length;
+    bek_encode(&codec, input, LARGE, expected, 2 * LARGE, &expected_length);
+
+    bek_pool_t *pool;
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pool_create(&pool, 3));
+    bek_job_t encode = {&codec, BEK_JOB_ENCODE, input, LARGE, encoded, 2 * LARGE, 0, BEK_SUCCESS};
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pool_run(pool, &encode, 1));
+    TEST_ASSERT_EQUAL(expected_length, encode.output_length);
+    TEST_ASSERT_EQUAL_MEMORY(expected, encoded, expected_length);
+    bek_job_t decode = {&codec, BEK_JOB_DECODE, encoded, encode.output_length, decoded, LARGE, 0, BEK_SUCCESS};
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pool_run(pool, &decode, 1));
+    TEST_ASSERT_EQUAL(LARGE, decode.output_length);
+    TEST_ASSERT_EQUAL_MEMORY(input, decoded, LARGE);
+    bek_pool_free(pool);
+
+    char plain_path[] = "/tmp/bek_plain_XXXXXX";
+    char encoded_path[] = "/tmp/bek_encoded_XXXXXX";
+    close(mkstemp(plain_path));
+    close(mkstemp(encoded_path));
+    FILE *file = fopen(plain_path, "wb");
+    fwrite(input, 1, 5000, file);
+    fclose(file);
+    const bek_file_options_t options = {2, 500};
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_encode_file(&codec, plain_path, encoded_path, &options));
+    TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_decode_file(&codec, encoded_path, plain_path, &options));
+    remove(plain_path);
+    remove(encoded_path);
+
+    base64_free(base64_ctx);
+    bek_set_allocator(NULL);
+    TEST_ASSERT_TRUE(counter.allocations > 10);
+    TEST_ASSERT_EQUAL(counter.allocations, counter.frees);
+    TEST_ASSERT_EQUAL(0, counter.live);
+
+    // Back to malloc/free
+    const int before = counter.allocations;
+    base64_init(&base64_ctx, &base64_config);
+    base64_free(base64_ctx);
+    TEST_ASSERT_EQUAL(before, counter.allocations);
+
+    free(input);
+    free(encoded);
+    free(expected);
+    free(decoded);
+}
+
+// Codec handle plus the context it owns
+typedef struct {
+    bek_codec_t codec;
+    void *ctx;
+} owned_codec_t;
+
+// Codec of the given kind wrapped at 76 columns with the given output stores
+static owned_codec_t wrapped_codec(const bek_codec_kind_t kind, const bek_store_mode_t stores) {
+    owned_codec_t owned = {.codec.kind = kind};
+    if (kind == BEK_CODEC_BASE64) {
+        base64_config_t config = {1, 0, 76, "\r\n", 1, NULL, NULL, stores};
+        base64_ctx_t *ctx;
+        base64_init(&ctx, &config);
+        owned.codec.ctx.base64 = owned.ctx = ctx;
+    } else if (kind == BEK_CODEC_BASE32) {
+        base32_config_t config = {1, 0, 76, "\n", 1, NULL, stores};
+        base32_ctx_t *ctx;
+        base32_init(&ctx, &config);
+        owned.codec.ctx.base32 = owned.ctx = ctx;
+    } else if (kind == BEK_CODEC_BASE16) {
+        base16_config_t config = {1, 76, "\n", 1, NULL, NULL, stores};
+        base16_ctx_t *ctx;
+        base16_init(&ctx, &config);
+        owned.codec.ctx.base16 = owned.ctx = ctx;
+    } else {
+        base85_config_t config = {0, 76, "\n", 1, NULL, stores};
+        base85_ctx_t *ctx;
+        base85_init(&ctx, &config);
+        owned.codec.ctx.base85 = owned.ctx = ctx;
+    }
+    return owned;
+}
+
+static void free_codec(const owned_codec_t *owned) {
+    if (owned->codec.kind == BEK_CODEC_BASE64) base64_free(owned->ctx);
+    if (owned->codec.kind == BEK_CODEC_BASE32) base32_free(owned->ctx);
+    if (owned->codec.kind == BEK_CODEC_BASE16) base16_free(owned->ctx);
+    if (owned->codec.kind == BEK_CODEC_BASE85) base85_free(owned->ctx);
+}
+
+// Non-temporal stores produce the same output at every alignment and length
+void test_bek_nontemporal(void) {
+    enum { INPUT = 5000, OUTPUT = 3 * INPUT };
+    static uint8_t input[INPUT];
+    static char expected[OUTPUT], actual[OUTPUT + 64];
+    for (size_t i = 0; i < INPUT; i++) input[i] = (uint8_t) (i * 37 + (i >> 7));
+    memset(input + 1000, 0, 64);
+
+    const bek_codec_kind_t kinds[] = {BEK_CODEC_BASE64, BEK_CODEC_BASE32, BEK_CODEC_BASE16, BEK_CODEC_BASE85};
+    for (int k = 0; k < 4; k++) {
+        const owned_codec_t cached = wrapped_codec(kinds[k], BEK_STORE_CACHED);
+        const owned_codec_t streamed = wrapped_codec(kinds[k], BEK_STORE_NONTEMPORAL);
+
+        for (size_t length = 0; length <= INPUT; length += length < 200 ? 1 : 397) {
+            const size_t offset = length % 64;
+            size_t expected_length, actual_length;
+            TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_encode(&cached.codec, input, length, expected, OUTPUT, &expected_length));
+            memset(actual, '#', sizeof(actual));
+            TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_encode(&streamed.codec, input, length, actual + offset,
+                                                      OUTPUT, &actual_length));
+            TEST_ASSERT_EQUAL(expected_length, actual_length);
+            TEST_ASSERT_EQUAL_MEMORY(expected, actual + offset, expected_length);
+            TEST_ASSERT_EQUAL('#', actual[offset + actual_length]);
+        }
+        free_codec(&cached);
+        free_codec(&streamed);
+    }
+
+    // The codec's own call keeps its terminator
+    base64_config_t config = {1, 0, 76, "\n", 0, NULL, NULL, BEK_STORE_NONTEMPORAL};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+    size_t length;
+    TEST_ASSERT_EQUAL(BASE64_SUCCESS, base64_encode(ctx, (const uint8_t *) "foobar", 6, actual + 3, 10, &length));
+    TEST_ASSERT_EQUAL(8, length);
+    TEST_ASSERT_EQUAL_STRING("Zm9vYmFy", actual + 3);
+    TEST_ASSERT_EQUAL(BASE64_ERROR_BUFFER_TOO_SMALL, base64_encode(ctx, (const uint8_t *) "foobar", 6, actual, 8, &length));
+    base64_free(ctx);
+}
+
+// Fake layout: memory alternates between two nodes every MiB
+static int alternating_node(void *user_data, const void *address) {
+    (void) user_data;
+    return (int) (((uintptr_t) address >> 20) & 1);
+}
+
+// Large jobs on NUMA-aware pools, over a made-up two-node layout and over
+// the layout of this machine
+void test_bek_pool_numa(void) {
+    base64_config_t config = {1, 0, 76, "\n", 1};
+    base64_ctx_t *ctx;
+    base64_init(&ctx, &config);
+    const bek_codec_t codec = {.kind = BEK_CODEC_BASE64, .ctx.base64 = ctx};
+
+    enum { LARGE = 5 * BEK_POOL_SPLIT_SIZE + 7 };
+    uint8_t *input = malloc(LARGE);
+    char *expected = malloc(2 * LARGE);
+    uint8_t *decoded = malloc(LARGE);
+    for (size_t i = 0; i < LARGE; i++) input[i] = (uint8_t) (i * 173 + (i >> 11));
+    size_t expected_length;
+    bek_encode(&codec, input, LARGE, expected, 2 * LARGE, &expected_length);
+
+    // Outputs are mapped untouched, so the writers place their pages
+    char *encoded = bek_pool_map_output(2 * LARGE);
+    TEST_ASSERT_NOT_NULL(encoded);
+
+    const int cpu_nodes[] = {0, 0, 1, 1};
+    const bek_numa_topology_t topology = {4, cpu_nodes, alternating_node, NULL};
+    const bek_numa_options_t fake = {5, &topology};
+    const bek_numa_options_t local = {3, NULL};
+    const bek_numa_options_t *options[] = {&fake, &local};
+
+    for (int o = 0; o < 2; o++) {
+        bek_pool_t *pool;
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pool_create_numa(&pool, options[o]));
+        bek_job_t jobs[2] = {
+            {&codec, BEK_JOB_ENCODE, input, LARGE, encoded, 2 * LARGE, 0, BEK_SUCCESS},
+            {&codec, BEK_JOB_DECODE, expected, expected_length, decoded, LARGE, 0, BEK_SUCCESS},
+        };
+        TEST_ASSERT_EQUAL(BEK_SUCCESS, bek_pool_run(pool, jobs, 2));
+        TEST_ASSERT_EQUAL(expected_length, jobs[0].output_length);
+        TEST_ASSERT_EQUAL_MEMORY(expected, encoded, expected_length);
+        TEST_ASSERT_EQUAL(LARGE, jobs[1].output_length);
+        TEST_ASSERT_EQUAL_MEMORY(input, decoded, LARGE);
+
+        // Every piece of the fake layout has a node with workers to go to
+        bek_pool_stats_t stats;
+        bek_pool_get_stats(pool, &stats);
+        TEST_ASSERT_TRUE(stats.pieces >= 2 * LARGE / BEK_POOL_PIECE_SIZE);
+        TEST_ASSERT_TRUE(stats.pieces_local <= stats.pieces);
+        if (o == 0) TEST_ASSERT_EQUAL(stats.pieces, stats.pieces_placed);
+        bek_pool_free(pool);
+    }
+
+    const bek_numa_topology_t incomplete = {4, NULL, alternating_node, NULL};
+    const bek_numa_options_t invalid = {2, &incomplete};
+    bek_pool_t *pool;
+    TEST_ASSERT_EQUAL(BEK_ERROR_NULL_POINTER, bek_pool_create_numa(&pool, &invalid));
+
+    bek_pool_unmap_output(encoded, 2 * LARGE);
+    base64_free(ctx);
+    free(input);
+    free(expected);
+    free(decoded);
+}
@@ -3,37 +3,128 @@
 extern void test_base64_encode_decode(void);
 extern void test_base64_encode_decode_url_safe(void);
 extern void test_base64_invalid_inputs(void);
+extern void test_base64_slop(void);
+extern void test_base64_no_terminator(void);
+extern void test_base64_iov(void);
+extern void test_base64_sink(void);
+extern void test_base64_ring(void);
+extern void test_base64_fixed(void);
+extern void test_base64_word_classes(void);
+extern void test_base64_decode_wrapped(void);
+extern void test_base64_ignore_set(void);
+extern void test_base64_strict(void);
+extern void test_base64_utf16(void);
 
 extern void test_base32_encode(void);
 extern void test_base32_decode(void);
+extern void test_base32_decode_lookup(void);
 extern void test_base32hex_encode(void);
 extern void test_base32hex_decode(void);
 extern void test_base32_invalid_inputs(void);
+extern void test_base32_slop(void);
+extern void test_base32_no_terminator(void);
+extern void test_base32_iov(void);
+extern void test_base32_fixed(void);
+extern void test_base32_word_classes(void);
+extern void test_base32_strict(void);
 
 extern void test_base16_encode(void);
 extern void test_base16_decode(void);
+extern void test_base16_slop(void);
+extern void test_base16_no_terminator(void);
+extern void test_base16_iov(void);
+extern void test_base16_fixed(void);
+extern void test_base16_integers(void);
+extern void test_base16_word_classes(void);
+extern void test_base16_ignore_set(void);
+extern void test_base16_utf16(void);
+
+extern void test_base85_encode_decode(void);
+extern void test_base85_ascii85_extras(void);
+extern void test_base85_invalid_inputs(void);
+extern void test_base85_stream(void);
+
+extern void test_bek_codec_roundtrip(void);
+extern void test_bek_codec_chunks(void);
+extern void test_bek_file_roundtrip(void);
+extern void test_bek_file_uring_zero_groups(void);
+extern void test_bek_pool_jobs(void);
+extern void test_bek_ignore_set_parallel(void);
+extern void test_bek_pem_roundtrip(void);
+extern void test_bek_pem_bundle(void);
+extern void test_bek_crc32c(void);
+extern void test_bek_codec_crc32c(void);
+extern void test_bek_buf(void);
+extern void test_bek_allocator(void);
+extern void test_bek_nontemporal(void);
+extern void test_bek_pool_numa(void);
 
 void setUp(void) {
 }
 
 void tearDown(void) {
 }
-
 int main(void) {
     UNITY_BEGIN();
 
     RUN_TEST(test_base64_encode_decode);
     RUN_TEST(test_base64_encode_decode_url_safe);
     // RUN_TEST(test_base64_invalid_inputs);
+    RUN_TEST(test_base64_slop);
+    RUN_TEST(test_base64_no_terminator);
+    RUN_TEST(test_base64_iov);
+    RUN_TEST(test_base64_sink);
+    RUN_TEST(test_base64_ring);
+    RUN_TEST(test_base64_fixed);
+    RUN_TEST(test_base64_word_classes);
+    RUN_TEST(test_base64_decode_wrapped);
+    RUN_TEST(test_base64_ignore_set);
+    RUN_TEST(test_base64_strict);
+    RUN_TEST(test_base64_utf16);
 
     RUN_TEST(test_base32_encode);
     RUN_TEST(test_base32_decode);
+    RUN_TEST(test_base32_decode_lookup);
     RUN_TEST(test_base32hex_encode);
     RUN_TEST(test_base32hex_decode);
     // RUN_TEST(test_base32_invalid_inputs);
+    RUN_TEST(test_base32_slop);
+    RUN_TEST(test_base32_no_terminator);
+    RUN_TEST(test_base32_iov);
+    RUN_TEST(test_base32_fixed);
+    RUN_TEST(test_base32_word_classes);
+    RUN_TEST(test_base32_strict);
 
     RUN_TEST(test_base16_encode);
     RUN_TEST(test_base16_decode);
+    RUN_TEST(test_base16_slop);
+    RUN_TEST(test_base16_no_terminator);
+    RUN_TEST(test_base16_iov);
+    RUN_TEST(test_base16_fixed);
+    RUN_TEST(test_base16_integers);
+    RUN_TEST(test_base16_word_classes);
+    RUN_TEST(test_base16_ignore_set);
+    RUN_TEST(test_base16_utf16);
+
+    RUN_TEST(test_base85_encode_decode);
+    RUN_TEST(test_base85_ascii85_extras);
+    RUN_TEST(test_base85_invalid_inputs);
+    RUN_TEST(test_base85_stream);
+
+    RUN_TEST(test_bek_codec_roundtrip);
+    RUN_TEST(test_bek_codec_chunks);
+    RUN_TEST(test_bek_file_roundtrip);
+    RUN_TEST(test_bek_file_uring_zero_groups);
+    RUN_TEST(test_bek_pool_jobs);
+    RUN_TEST(test_bek_ignore_set_parallel);
+    RUN_TEST(test_bek_pem_roundtrip);
+    RUN_TEST(test_bek_pem_bundle);
+    RUN_TEST(test_bek_crc32c);
+    RUN_TEST(test_bek_codec_crc32c);
+    RUN_TEST(test_bek_buf);
+    RUN_TEST(test_bek_allocator);
+    RUN_TEST(test_bek_nontemporal);
+    RUN_TEST(test_bek_pool_numa);
 
     return UNITY_END();
 }